@@ -45,19 +45,50 @@
 #define configCPU_CLOCK_HZ			                ( ( unsigned long ) 20000000 )
 #define configTICK_RATE_HZ			                ( ( TickType_t ) 1000 )
 #define configMINIMAL_STACK_SIZE	                ( ( unsigned short ) 143 )
-#define configTOTAL_HEAP_SIZE		                ( ( size_t ) ( 5000 ) )
+#define configTOTAL_HEAP_SIZE		                ( ( size_t ) ( 6400 ) )
 #define configMAX_TASK_NAME_LEN		                ( 10 )
 #define configUSE_TRACE_FACILITY	                1
 #define configUSE_16_BIT_TICKS		                0
 #define configIDLE_SHOULD_YIELD		                0
 #define configMAX_PRIORITIES		                ( 5 )
 #define configMAX_CO_ROUTINE_PRIORITIES             ( 2 )
+#define configUSE_TASK_BUDGETS                      1
+#define configUSE_TIME_TRIGGERED_TASKS              1
 
 #define configGENERATE_RUN_TIME_STATS               1
+#define configRECORD_JOB_TIMES                      1
+#define configRECORD_WAKEUP_LATENCY                 1
+#define configRECORD_CONTEXT_SWITCHES               1
+#define configUSE_TASK_HEAP_ACCOUNTING              1
+#define configUSE_HEAP_TRACE                        0
+#define configRECORD_STACK_HEADROOM                 1
+#define configUSE_TASK_ITERATOR                     1
+#define configRECORD_CRITICAL_SECTION_TIMES         1
+#define configRECORD_INTERRUPT_RUN_TIME             1
 #define configSUPPORT_DYNAMIC_ALLOCATION            1
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    ( prvSetupTimer() )
 #define portGET_RUN_TIME_COUNTER_VALUE()            ( ulGetHighFrequencyTimerTicks() )
 
+/* High resolution timers run from the GPTMs at the processor clock, see
+prvSetupHRTimer() in main.c. */
+extern unsigned long ulHRTimerGetHardwareTime( void );
+extern void vHRTimerSetHardwareCompare( unsigned long ulDelay );
+extern void vHRTimerStopHardwareCompare( void );
+#define configUSE_HR_TIMERS                         1
+#define configHR_TIMER_FREQUENCY_HZ                 configCPU_CLOCK_HZ
+#define portHR_TIMER_GET_TIME()                     ( ulHRTimerGetHardwareTime() )
+#define portHR_TIMER_SET_COMPARE( ulDelay )         vHRTimerSetHardwareCompare( ulDelay )
+#define portHR_TIMER_STOP_COMPARE()                 vHRTimerStopHardwareCompare()
+
+/* Tickless idle.  The sleep hooks in main.c stop the run time stats timer and
+gate the LCD's I2C controller while the processor sleeps, and account for the
+time asleep using the Timer2 time base of the high resolution timers. */
+extern void vPreSleepProcessing( unsigned long ulExpectedIdleTime );
+extern void vPostSleepProcessing( unsigned long ulExpectedIdleTime );
+#define configUSE_TICKLESS_IDLE                     1
+#define configPRE_SLEEP_PROCESSING( x )             vPreSleepProcessing( x )
+#define configPOST_SLEEP_PROCESSING( x )            vPostSleepProcessing( x )
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 
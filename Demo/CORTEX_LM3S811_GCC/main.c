@@ -31,6 +31,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "hrtimers.h"
 
 /* Delay between cycles of the 'check' task. */
 #define mainSENSOR_DELAY			( ( TickType_t ) 100 / portTICK_PERIOD_MS )		// 10 [Hz]
@@ -43,6 +44,99 @@ efficient. */
 /* Demo task priorities. */
 #define mainCHECK_TASK_PRIORITY		( tskIDLE_PRIORITY + 3 )
 
+/* CPU budget of the display task: at most 10 ms every 100 ms. */
+#define mainDISPLAY_BUDGET			pdMS_TO_TICKS( 10 )
+#define mainDISPLAY_BUDGET_PERIOD	pdMS_TO_TICKS( 100 )
+
+/* Timer0 reload value, which sets the resolution of the run time stats. */
+#define mainRUN_TIME_TIMER_LOAD		( 1500 )
+#define mainRUN_TIME_COUNTER_HZ		( configCPU_CLOCK_HZ / mainRUN_TIME_TIMER_LOAD )
+#define mainRUN_TIME_COUNTER_US		( 1000000UL / mainRUN_TIME_COUNTER_HZ )
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+	/* The sleep hooks time the sleep with Timer2, which only runs when the
+	high resolution timers are used. */
+	#if ( configUSE_HR_TIMERS != 1 )
+		#error configUSE_TICKLESS_IDLE needs the Timer2 time base of configUSE_HR_TIMERS.
+	#endif
+
+	/* Processor clocks in one tick period. */
+	#define mainCLOCKS_PER_TICK		( configCPU_CLOCK_HZ / configTICK_RATE_HZ )
+
+	/* The interrupts that end a sleep, as counted by vPostSleepProcessing(). */
+	#define mainWAKE_TICK			0
+	#define mainWAKE_UART			1
+	#define mainWAKE_HR_TIMER		2
+	#define mainWAKE_OTHER			3
+	#define mainWAKE_SOURCES		4
+#endif
+
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+	/* The DWT cycle counter that times the interrupt handlers, and the debug
+	registers that start it. */
+	#define mainDWT_CYCCNT				( 0xE0001004 )
+	#define mainDWT_CTRL				( 0xE0001000 )
+	#define mainDEMCR					( 0xE000EDFC )
+	#define mainDEMCR_TRCENA			( 1UL << 24 )
+	#define mainDWT_CTRL_CYCCNTENA		( 1UL << 0 )
+
+	/* The number of handlers timed, see ulISRExceptions[].  PendSV is timed by
+	prvPendSVDispatch(), which relies on it being the first. */
+	#define mainISR_PENDSV				0
+	#define mainISR_COUNT				5
+#endif
+
+/* The output of the top report.  The text table is for a terminal; the CSV
+lines and the binary frames carry the windowed CPU shares, free stack and
+context switch counts of each task for tools/topview.py, the binary frames
+in about half the bytes of the CSV lines. */
+#define mainTOP_TEXT				0
+#define mainTOP_CSV					1
+#define mainTOP_BINARY				2
+
+#ifndef mainTOP_OUTPUT
+	#define mainTOP_OUTPUT			mainTOP_TEXT
+#endif
+
+/* The top report reads the tasks one at a time with xTaskIteratorNext(). */
+#if ( configUSE_TASK_ITERATOR != 1 )
+	#error The top report needs configUSE_TASK_ITERATOR set to 1.
+#endif
+
+/* Binary frames are the two sync bytes, the frame type, the payload length,
+the little endian payload and a checksum that makes the bytes from the type
+to the checksum sum to 0. */
+#define mainTOP_SYNC_0				( 0xA5 )
+#define mainTOP_SYNC_1				( 0x5A )
+#define mainTOP_FRAME_REPORT		( 1 )
+#define mainTOP_FRAME_TASK			( 2 )
+#define mainTOP_FRAME_ISR			( 3 )
+
+/* The 10 s and 60 s CPU shares are exponentially decaying averages of the
+share in each report, kept like the Linux load averages in fixed point with
+mainLOAD_SHIFT fractional bits.  Each report decays them by exp(-2 s / 10 s)
+and exp(-2 s / 60 s), so the constants assume mainTOP_DELAY is 2 s.  Shares
+are in tenths of a percent, which leaves room for the products in 32 bits. */
+#define mainLOAD_SHIFT				( 11 )
+#define mainLOAD_ONE				( 1UL << mainLOAD_SHIFT )
+#define mainLOAD_EXP_10				( 1677UL )
+#define mainLOAD_EXP_60				( 1981UL )
+#define mainPERMILLE				( 1000UL )
+
+/* What the top task keeps about a task from one report to the next, in the
+same order as pxTaskStatusArray. */
+typedef struct
+{
+	UBaseType_t uxTaskNumber;
+	unsigned long ulLastRunTime;
+	unsigned long ulLoad10;
+	unsigned long ulLoad60;
+#if ( configRECORD_CONTEXT_SWITCHES == 1 )
+	UBaseType_t uxLastVoluntary;
+	UBaseType_t uxLastInvoluntary;
+#endif
+} TopWindow_t;
+
 /* Misc. */
 #define mainQUEUE_SIZE				( 3 )
 #define MAX_ARRAY_VALUE				20
@@ -64,11 +158,39 @@ static void prvSetupHardware( void );
 static void vDrawArrayBufferSize( int value);
 static char* cGetColumnOctal( int value );
 void prvSetupTimer( void );
+#if ( configUSE_HR_TIMERS == 1 )
+static void prvSetupHRTimer( void );
+void Timer1IntHandler( void );
+unsigned long ulHRTimerGetHardwareTime( void );
+void vHRTimerSetHardwareCompare( unsigned long ulDelay );
+void vHRTimerStopHardwareCompare( void );
+#endif
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+static void prvSetupISRAccounting( void );
+static void prvISRDispatch( void );
+static void prvPendSVDispatch( void ) __attribute__( ( naked ) );
+void vPendSVAccountingEnter( void );
+void vPendSVAccountingExit( void );
+static void prvRecordISR( unsigned long ulIndex, unsigned long ulStart, unsigned long ulNestedAtStart );
+#endif
+static BaseType_t prvResizeTopArrays( UBaseType_t uxCapacity );
+static UBaseType_t prvRefreshTaskStatus( void );
+static unsigned long prvUpdateLoad( unsigned long ulLoad, unsigned long ulExp, unsigned long ulPermille );
+static void prvPrintTopHeader( unsigned long ulWindow, UBaseType_t uxArraySize );
+static void prvPrintTopTask( const TaskStatus_t *pxStatus, const TopWindow_t *pxWindow, unsigned long ulPermille, unsigned long ulVoluntary, unsigned long ulInvoluntary );
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+static void prvPrintTopISR( unsigned long ulPermille, unsigned long ulLoad10, unsigned long ulLoad60 );
+#endif
 void vPushValueIntoArray( int array[], int value, int size );
 void Timer0IntHandler( void );
 void vDrawAxis( void );
 void vCheckStackOverflow(void);
 void vPrintTopStats( void );
+void vPrintSchedStats( UBaseType_t uxArraySize );
+void vPrintHeapTrace( void );
+void vPrintSleepStats( void );
+void vPrintCriticalStats( void );
+void vPrintISRStats( void );
 void vSendStringToUART( const char* );
 char* cUnsignedIntToString( unsigned, char*, int );
 int iGetAverageTemperature( int array[], int bufferSize, int arraySize );
@@ -83,6 +205,74 @@ static int iArrayBufferSize = 5;
 static char octalBufferSize[12];
 unsigned long ulHighFrequencyTimerTicks;
 TaskStatus_t *pxTaskStatusArray;
+TaskHandle_t xDisplayTaskHandle;
+TaskHandle_t xSensorTaskHandle;
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+	/* Sleep accounting, updated by the sleep hooks with interrupts masked and
+	reported and cleared by the top task.  Times are in processor clocks. */
+	static unsigned long ulSleepStart;
+	static unsigned long ulSleepClocks;
+	static unsigned long ulSleepCount;
+	static unsigned long ulTicksSuppressed;
+	static unsigned long ulWakeCount[mainWAKE_SOURCES];
+	static unsigned long ulLastSleepReport;
+	static unsigned long ulRunTimeRemainder;
+#endif
+
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+	/* The exceptions whose handlers are timed, and their names in the report. */
+	static const unsigned long ulISRExceptions[mainISR_COUNT] = { FAULT_PENDSV, FAULT_SYSTICK, INT_UART0, INT_TIMER0A, INT_TIMER1A };
+	static const char *pcISRNames[mainISR_COUNT] = { "PendSV", "SysTick", "UART0", "Timer0", "Timer1" };
+
+	/* The handlers the vectors pointed to before prvSetupISRAccounting()
+	replaced them. */
+	static void (*pfnISRHandlers[mainISR_COUNT])( void );
+
+	/* Per handler statistics, reported and cleared by the top task.  Times are
+	in processor clocks and leave out the handlers that interrupted them. */
+	static unsigned long ulISRCount[mainISR_COUNT];
+	static unsigned long ulISRClocks[mainISR_COUNT];
+	static unsigned long ulISRMaxClocks[mainISR_COUNT];
+	static TickType_t xLastISRReport;
+
+	/* The time in all the handlers, which is never cleared, and the part of
+	it not yet reported to the kernel because it is less than one run time
+	counter period. */
+	static unsigned long ulISRClocksTotal;
+	static unsigned long ulISRClocksRemainder;
+
+	/* When the running PendSV handler started.  PendSV has the lowest
+	priority so cannot interrupt itself. */
+	static unsigned long ulPendSVStart;
+	static unsigned long ulPendSVNestedAtStart;
+
+	/* The interrupt run time at the last top report, and its 10 s and 60 s
+	averages. */
+	static unsigned long ulLastISRRunTime;
+	static unsigned long ulISRLoad10;
+	static unsigned long ulISRLoad60;
+#endif
+
+/* The top report's state for each task, the number of tasks in the last
+report, the number of tasks the arrays have room for and the run time counter
+at the last report. */
+static TopWindow_t *pxTopWindows;
+static UBaseType_t uxTopTasks;
+static UBaseType_t uxTopCapacity;
+static unsigned long ulLastTopRunTime;
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+	/* The sensor is released by the tick at the start of every 100 ms frame. */
+	static const TimeTriggeredEntry_t xSchedule[] =
+	{
+		{ 0, mainSENSOR_DELAY, &xSensorTaskHandle }
+	};
+
+	/* The number of frames the sensor task has not finished within, for
+	inspection in the debugger. */
+	static volatile unsigned long ulSensorOverruns = 0;
+#endif
 
 
 /*---------------------------QUEUES--------------------------*/
@@ -111,12 +301,21 @@ int main( void )
 	}
 
 	/* Start the tasks defined within the file. */
-	xTaskCreate( vSensorTask, "Sensor", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY + 1, NULL );
+	xTaskCreate( vSensorTask, "Sensor", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY + 1, &xSensorTaskHandle );
 	xTaskCreate( vAverageTask, "Average", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY, NULL );
-	xTaskCreate( vDisplayTask, "Display", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY - 1, NULL );
+	xTaskCreate( vDisplayTask, "Display", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY - 1, &xDisplayTaskHandle );
 	xTaskCreate( vTopTask, "Top", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY - 2, NULL );
 	xTaskCreate( vUARTTask, "Uart", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY, NULL );
 
+#if ( configUSE_TASK_BUDGETS == 1 )
+	/* Bound the share of the CPU the LCD redraw can take. */
+	vTaskSetCpuBudget( xDisplayTaskHandle, mainDISPLAY_BUDGET, mainDISPLAY_BUDGET_PERIOD );
+#endif
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+	vTaskSetTimeTriggeredSchedule( xSchedule, sizeof( xSchedule ) / sizeof( xSchedule[ 0 ] ) );
+#endif
+
 	/* Start the scheduler. */
 	vTaskStartScheduler();
 
@@ -135,6 +334,9 @@ int main( void )
  * This is just a simulation of a temperature sensor that changes the temperature randomly.
  * There is not a real sensor in this project.
  * 
+ * When configUSE_TIME_TRIGGERED_TASKS is 1 the task is released from the tick
+ * by the schedule table instead of delaying itself.
+ * 
  * @param pvParameters Parameters passed to the task (not used).
  */
 static void vSensorTask( void *pvParameters ) 
@@ -147,7 +349,17 @@ static void vSensorTask( void *pvParameters )
 
 	while (true)
 	{
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+		( void ) xLastExecutionTime;
+
+		/* The previous sample did not finish within its frame, so this
+		frame's release has already happened.  Sample straight away to catch
+		up, but count the overrun. */
+		if (xTaskWaitForRelease() != pdPASS)
+			ulSensorOverruns++;
+#else
 		vTaskDelayUntil(&xLastExecutionTime, mainSENSOR_DELAY);
+#endif
 
 		change = (uiGetRandomNumber() % 3) - 1; // -1, 0, 1
 		iActualTemperature += change;
@@ -239,22 +451,27 @@ static void vDisplayTask( void *pvParameters )
 /**
  * @brief The task that prints system statistics.
  * 
- * It prints the TASK, CPU%, STACK FREE and TICKS of each task.
- * Sends it via UART.
+ * Every 2 s it prints the TASK, its share of the CPU over the last 2 s and
+ * averaged over 10 s and 60 s, STACK FREE, BUDGET, WAKE99 (p99 wake up latency
+ * in microseconds), HEAP and the voluntary and involuntary context switches
+ * (VCSW, ICSW) in the last 2 s of each task, followed by the time spent in each
+ * interrupt handler when configRECORD_INTERRUPT_RUN_TIME is 1 and the sleep
+ * statistics when configUSE_TICKLESS_IDLE is 1.
+ * Sends it via UART, as text, CSV or binary frames, see mainTOP_OUTPUT.
  * 
  * @param pvParameters Parameters passed to the task (not used).
  */
 static void vTopTask( void *pvParameters )
 {
-	UBaseType_t uxArraySize = uxTaskGetNumberOfTasks();
-	pxTaskStatusArray = pvPortMalloc(uxArraySize * sizeof(TaskStatus_t));
+	TickType_t xLastReport = xTaskGetTickCount();
 
 	/* Error handling. */
 	vCheckStackOverflow();
 
 	while (true)
 	{
-		vTaskDelay(mainTOP_DELAY);
+		/* A fixed period keeps the reports in step with the averages. */
+		vTaskDelayUntil(&xLastReport, mainTOP_DELAY);
 
 		vPrintTopStats();
 
@@ -315,6 +532,10 @@ static void prvSetupHardware( void )
 	OSRAMInit(false);
 	OSRAMStringDraw("www.FreeRTOS.org", 0, 0);
 	OSRAMStringDraw("SOII Project", 16, 1);
+
+	#if ( configUSE_HR_TIMERS == 1 )
+		prvSetupHRTimer();
+	#endif
 }
 
 /**
@@ -326,11 +547,107 @@ void prvSetupTimer( void )
 	IntMasterEnable();
 	TimerIntEnable(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
 	TimerConfigure(TIMER0_BASE,TIMER_CFG_32_BIT_TIMER);
-	TimerLoadSet(TIMER0_BASE, TIMER_A, 1500);
+	TimerLoadSet(TIMER0_BASE, TIMER_A, mainRUN_TIME_TIMER_LOAD);
 	TimerIntRegister(TIMER0_BASE,TIMER_A, Timer0IntHandler);
 	TimerEnable(TIMER0_BASE,TIMER_A);
+
+	#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+		/* The kernel calls this just before starting the first task, after
+		every handler has been registered, so the handlers can now be
+		wrapped. */
+		prvSetupISRAccounting();
+	#endif
+}
+
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+/**
+ * @brief Wraps the handlers in ulISRExceptions[] so each one is timed.
+ *
+ * The vectors are moved to prvISRDispatch(), or prvPendSVDispatch() for
+ * PendSV, through the RAM vector table IntRegister() keeps, and the handlers
+ * they pointed to are saved in pfnISRHandlers[].  The SVC handler only starts
+ * the first task so is not timed.  Interrupts are still disabled.
+ */
+static void prvSetupISRAccounting( void )
+{
+	void (**pfnVectors)( void );
+	int i;
+
+	/* Start the cycle counter. */
+	HWREG(mainDEMCR) |= mainDEMCR_TRCENA;
+	HWREG(mainDWT_CTRL) |= mainDWT_CTRL_CYCCNTENA;
+
+	for (i = 0; i < mainISR_COUNT; i++)
+	{
+		/* Read the vector from whichever table is in use. */
+		pfnVectors = (void (**)(void)) HWREG(NVIC_VTABLE);
+		pfnISRHandlers[i] = pfnVectors[ulISRExceptions[i]];
+
+		IntRegister(ulISRExceptions[i], i == mainISR_PENDSV ? prvPendSVDispatch : prvISRDispatch);
+	}
+
+	xLastISRReport = xTaskGetTickCount();
+}
+#endif
+
+#if ( configUSE_HR_TIMERS == 1 )
+/**
+ * @brief Configures the timers behind the high resolution timer API.
+ *
+ * Timer2 free runs over the full 32-bit range as the time base, and Timer1 is
+ * used as a one-shot compare that is reloaded for each expiry.  Both count at
+ * the processor clock.  Timer1 interrupts at the kernel priority so timer
+ * callbacks can use the FromISR API.
+ */
+static void prvSetupHRTimer( void )
+{
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER2);
+
+	TimerConfigure(TIMER2_BASE, TIMER_CFG_32_BIT_PER);
+	TimerLoadSet(TIMER2_BASE, TIMER_A, 0xFFFFFFFFUL);
+	TimerEnable(TIMER2_BASE, TIMER_A);
+
+	TimerConfigure(TIMER1_BASE, TIMER_CFG_32_BIT_OS);
+	TimerIntRegister(TIMER1_BASE, TIMER_A, Timer1IntHandler);
+	IntPrioritySet(INT_TIMER1A, configKERNEL_INTERRUPT_PRIORITY);
+	TimerIntEnable(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
 }
 
+/**
+ * @brief Gets the high resolution time base.
+ *
+ * The GPTM counts down, so the count is inverted to give an up counter.
+ *
+ * @return The number of processor clocks since Timer2 was started, modulo 2^32.
+ */
+unsigned long ulHRTimerGetHardwareTime( void )
+{
+	return ~TimerValueGet(TIMER2_BASE, TIMER_A);
+}
+
+/**
+ * @brief Arms the high resolution timer interrupt.
+ *
+ * @param ulDelay The number of processor clocks until the interrupt.
+ */
+void vHRTimerSetHardwareCompare( unsigned long ulDelay )
+{
+	TimerDisable(TIMER1_BASE, TIMER_A);
+	TimerLoadSet(TIMER1_BASE, TIMER_A, ulDelay);
+	TimerEnable(TIMER1_BASE, TIMER_A);
+}
+
+/**
+ * @brief Disarms the high resolution timer interrupt.
+ */
+void vHRTimerStopHardwareCompare( void )
+{
+	TimerDisable(TIMER1_BASE, TIMER_A);
+	TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+}
+#endif
+
 /*----------------------------UTILS--------------------------*/
 /**
  * @brief Gets a random number.
@@ -507,7 +824,7 @@ unsigned long ulGetHighFrequencyTimerTicks( void )
  */
 void vCheckStackOverflow(void)
 {
-    if (uxTaskGetStackHighWaterMark(NULL) < 1)
+    if (uxTaskGetStackHeadroom(NULL) < 1)
 	{
 		OSRAMClear();
 		OSRAMStringDraw("Stack Overflow", 0, 0);
@@ -571,57 +888,809 @@ void vSendStringToUART( const char *message )
   	UARTCharPut(UART0_BASE, '\0');
 }
 
+/**
+ * @brief Makes room in the top report's arrays for uxCapacity tasks.
+ *
+ * The windows of the tasks in the last report are kept.
+ *
+ * @param uxCapacity The number of tasks to make room for.
+ * @return pdTRUE if the arrays were reallocated, pdFALSE if the heap is full.
+ */
+static BaseType_t prvResizeTopArrays( UBaseType_t uxCapacity )
+{
+	TaskStatus_t *pxNewStatus;
+	TopWindow_t *pxNewWindows;
+	UBaseType_t x;
+
+	pxNewStatus = pvPortMalloc(uxCapacity * sizeof(TaskStatus_t));
+	pxNewWindows = pvPortMalloc(uxCapacity * sizeof(TopWindow_t));
+
+	if ((pxNewStatus == NULL) || (pxNewWindows == NULL))
+	{
+		vPortFree(pxNewStatus);
+		vPortFree(pxNewWindows);
+		return pdFALSE;
+	}
+
+	for (x = 0; x < uxTopTasks; x++)
+		pxNewWindows[x] = pxTopWindows[x];
+
+	vPortFree(pxTaskStatusArray);
+	vPortFree(pxTopWindows);
+	pxTaskStatusArray = pxNewStatus;
+	pxTopWindows = pxNewWindows;
+	uxTopCapacity = uxCapacity;
+
+	return pdTRUE;
+}
+
+/**
+ * @brief Brings pxTaskStatusArray up to date for the top report.
+ *
+ * The tasks are read one at a time with xTaskIteratorNext(), which only holds
+ * the scheduler suspended while it copies one task, rather than for the walk
+ * of every task list that uxTaskGetSystemState() makes. The enumeration starts
+ * again if a task is created or deleted part way through, after growing the
+ * arrays if there are now more tasks than they have room for.
+ *
+ * @return The number of valid entries in pxTaskStatusArray, or 0 if the
+ * arrays could not be grown.
+ */
+static UBaseType_t prvRefreshTaskStatus( void )
+{
+	TaskIterator_t xIterator;
+	BaseType_t xResult;
+	const TopWindow_t xNewWindow = { 0 };
+	TopWindow_t xWindow;
+	UBaseType_t uxTasks, x, y;
+
+	do
+	{
+		/* The arrays keep a spare entry, so filling them means a task was
+		created after uxTaskGetNumberOfTasks() was read. */
+		if ((uxTaskGetNumberOfTasks() >= uxTopCapacity) &&
+			(prvResizeTopArrays(uxTaskGetNumberOfTasks() + 1) == pdFALSE))
+			return 0;
+
+		uxTasks = 0;
+		vTaskIteratorStart(&xIterator);
+
+		do
+		{
+			xResult = xTaskIteratorNext(&xIterator, &pxTaskStatusArray[uxTasks], tskSTATUS_ALL);
+		} while ((xResult == pdTRUE) && (++uxTasks < uxTopCapacity));
+	} while (xResult != pdFALSE);
+
+	/* Tasks are reported in the order they were created, so a task's window
+	is either in its place from the last report or further on, past those of
+	deleted tasks. Tasks are matched by number, as a new task can reuse the
+	memory of a deleted one. A task not found is new, and its run time and
+	switches are all since the last report. */
+	for (x = 0; x < uxTasks; x++)
+	{
+		for (y = x; y < uxTopTasks; y++)
+		{
+			if (pxTopWindows[y].uxTaskNumber == pxTaskStatusArray[x].xTaskNumber)
+				break;
+		}
+
+		if (y < uxTopTasks)
+		{
+			xWindow = pxTopWindows[x];
+			pxTopWindows[x] = pxTopWindows[y];
+			pxTopWindows[y] = xWindow;
+		}
+		else
+		{
+			pxTopWindows[x] = xNewWindow;
+			pxTopWindows[x].uxTaskNumber = pxTaskStatusArray[x].xTaskNumber;
+		}
+	}
+
+	uxTopTasks = uxTasks;
+
+	return uxTopTasks;
+}
+
+/**
+ * @brief Folds one report's CPU share into an exponentially decaying average.
+ *
+ * @param ulLoad The average, in tenths of a percent with mainLOAD_SHIFT fractional bits.
+ * @param ulExp The decay per report, mainLOAD_EXP_10 or mainLOAD_EXP_60.
+ * @param ulPermille The share over the last report, in tenths of a percent.
+ * @return The new average.
+ */
+static unsigned long prvUpdateLoad( unsigned long ulLoad, unsigned long ulExp, unsigned long ulPermille )
+{
+	return (ulLoad * ulExp + (ulPermille << mainLOAD_SHIFT) * (mainLOAD_ONE - ulExp)) >> mainLOAD_SHIFT;
+}
+
+/* Rounds an average kept by prvUpdateLoad() to tenths of a percent. */
+#define mainLOAD_TO_PERMILLE( ulLoad )	( ( ( ulLoad ) + ( mainLOAD_ONE / 2 ) ) >> mainLOAD_SHIFT )
+
+#if ( mainTOP_OUTPUT == mainTOP_TEXT )
+/* Sends a share in tenths of a percent as a percentage with one decimal. */
+static void prvSendPermille( unsigned long ulPermille )
+{
+	char value[12];
+	char *end;
+
+	end = cUnsignedIntToString(ulPermille / 10, value, 10);
+	*end++ = '.';
+	cUnsignedIntToString(ulPermille % 10, end, 10);
+	vSendStringToUART(value);
+}
+#elif ( mainTOP_OUTPUT == mainTOP_CSV )
+/* Sends a number followed by a comma. */
+static void prvSendCSVField( unsigned long ulValue )
+{
+	char value[12];
+
+	cUnsignedIntToString(ulValue, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART(",");
+}
+#elif ( mainTOP_OUTPUT == mainTOP_BINARY )
+/* Appends a 16 bit value to a frame payload, saturating larger ones. */
+static uint8_t *prvPut16( uint8_t *pucPayload, unsigned long ulValue )
+{
+	if (ulValue > 0xFFFFUL)
+		ulValue = 0xFFFFUL;
+
+	*pucPayload++ = (uint8_t) ulValue;
+	*pucPayload++ = (uint8_t) (ulValue >> 8);
+
+	return pucPayload;
+}
+
+static uint8_t *prvPut32( uint8_t *pucPayload, unsigned long ulValue )
+{
+	pucPayload = prvPut16(pucPayload, ulValue & 0xFFFFUL);
+
+	return prvPut16(pucPayload, ulValue >> 16);
+}
+
+/* Sends a binary frame, see mainTOP_SYNC_0. */
+static void prvSendTopFrame( uint8_t ucType, const uint8_t *pucPayload, uint8_t ucLength )
+{
+	uint8_t ucSum = ucType + ucLength;
+	uint8_t i;
+
+	UARTCharPut(UART0_BASE, mainTOP_SYNC_0);
+	UARTCharPut(UART0_BASE, mainTOP_SYNC_1);
+	UARTCharPut(UART0_BASE, ucType);
+	UARTCharPut(UART0_BASE, ucLength);
+
+	for (i = 0; i < ucLength; i++)
+	{
+		UARTCharPut(UART0_BASE, pucPayload[i]);
+		ucSum += pucPayload[i];
+	}
+
+	UARTCharPut(UART0_BASE, (uint8_t) -ucSum);
+}
+#endif
+
+/**
+ * @brief Starts a top report.
+ *
+ * TOP,<tick count>,<run time counter counts in the report>,<tasks>
+ *
+ * @param ulWindow The run time counter counts since the last report.
+ * @param uxArraySize The number of tasks in the report.
+ */
+static void prvPrintTopHeader( unsigned long ulWindow, UBaseType_t uxArraySize )
+{
+#if ( mainTOP_OUTPUT == mainTOP_TEXT )
+	( void ) ulWindow;
+	( void ) uxArraySize;
+
+	vSendStringToUART("TASK\tCPU% 2s\t10s\t60s\tSTACK FREE\tBUDGET\tWAKE99\tHEAP\tVCSW\tICSW\r\n");
+	vSendStringToUART("-------------------------------------------------------------------------------\r\n");
+#elif ( mainTOP_OUTPUT == mainTOP_CSV )
+	char value[12];
+
+	vSendStringToUART("TOP,");
+	prvSendCSVField(xTaskGetTickCount());
+	prvSendCSVField(ulWindow);
+	cUnsignedIntToString(uxArraySize, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\r\n");
+#else
+	uint8_t ucPayload[9];
+
+	prvPut32(prvPut32(ucPayload, xTaskGetTickCount()), ulWindow);
+	ucPayload[8] = (uint8_t) uxArraySize;
+	prvSendTopFrame(mainTOP_FRAME_REPORT, ucPayload, sizeof(ucPayload));
+#endif
+}
+
+/**
+ * @brief Prints one task's line of the top report.
+ *
+ * CPU shares are in tenths of a percent, stack in words:
+ * TOPT,<task>,<2 s>,<10 s>,<60 s>,<stack free>,<voluntary>,<involuntary>
+ *
+ * @param pxStatus The task's status.
+ * @param pxWindow The task's averages, already updated for this report.
+ * @param ulPermille The task's share of the CPU since the last report.
+ * @param ulVoluntary The voluntary context switches since the last report.
+ * @param ulInvoluntary The involuntary context switches since the last report.
+ */
+static void prvPrintTopTask( const TaskStatus_t *pxStatus, const TopWindow_t *pxWindow, unsigned long ulPermille, unsigned long ulVoluntary, unsigned long ulInvoluntary )
+{
+#if ( mainTOP_OUTPUT == mainTOP_TEXT )
+	char value[12];
+
+	vSendStringToUART(pxStatus->pcTaskName);
+	vSendStringToUART("\t");
+	prvSendPermille(ulPermille);
+	vSendStringToUART("%\t");
+	prvSendPermille(mainLOAD_TO_PERMILLE(pxWindow->ulLoad10));
+	vSendStringToUART("%\t");
+	prvSendPermille(mainLOAD_TO_PERMILLE(pxWindow->ulLoad60));
+	vSendStringToUART("%\t");
+	cUnsignedIntToString(pxStatus->usStackHighWaterMark, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\t\t");
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+	/* Ticks used in the current period against the budget. */
+	if (pxStatus->xCpuBudget > 0)
+	{
+		cUnsignedIntToString(pxStatus->xCpuBudgetUsed, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART("/");
+		cUnsignedIntToString(pxStatus->xCpuBudget, value, 10);
+		vSendStringToUART(value);
+	}
+	else
+		vSendStringToUART("-");
+#else
+	vSendStringToUART("-");
+#endif
+
+	vSendStringToUART("\t");
+
+#if ( configRECORD_WAKEUP_LATENCY == 1 )
+	/* 99th percentile ready to running latency in microseconds. */
+	cUnsignedIntToString(ulTaskGetWakeupLatencyPercentile(pxStatus->xHandle, 99) * mainRUN_TIME_COUNTER_US, value, 10);
+	vSendStringToUART(value);
+#else
+	vSendStringToUART("-");
+#endif
+
+	vSendStringToUART("\t");
+
+#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	/* Heap bytes currently held, and the most ever held. */
+	cUnsignedIntToString(pxStatus->xHeapBytesInUse, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("/");
+	cUnsignedIntToString(pxStatus->xHeapBytesPeak, value, 10);
+	vSendStringToUART(value);
+#else
+	vSendStringToUART("-");
+#endif
+
+	vSendStringToUART("\t");
+
+#if ( configRECORD_CONTEXT_SWITCHES == 1 )
+	cUnsignedIntToString(ulVoluntary, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\t");
+	cUnsignedIntToString(ulInvoluntary, value, 10);
+	vSendStringToUART(value);
+#else
+	vSendStringToUART("-\t-");
+#endif
+
+	vSendStringToUART("\r\n");
+#elif ( mainTOP_OUTPUT == mainTOP_CSV )
+	char value[12];
+
+	vSendStringToUART("TOPT,");
+	vSendStringToUART(pxStatus->pcTaskName);
+	vSendStringToUART(",");
+	prvSendCSVField(ulPermille);
+	prvSendCSVField(mainLOAD_TO_PERMILLE(pxWindow->ulLoad10));
+	prvSendCSVField(mainLOAD_TO_PERMILLE(pxWindow->ulLoad60));
+	prvSendCSVField(pxStatus->usStackHighWaterMark);
+	prvSendCSVField(ulVoluntary);
+	cUnsignedIntToString(ulInvoluntary, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\r\n");
+#else
+	uint8_t ucPayload[12 + configMAX_TASK_NAME_LEN];
+	uint8_t *pucName;
+	uint8_t i;
+
+	pucName = prvPut16(ucPayload, ulPermille);
+	pucName = prvPut16(pucName, mainLOAD_TO_PERMILLE(pxWindow->ulLoad10));
+	pucName = prvPut16(pucName, mainLOAD_TO_PERMILLE(pxWindow->ulLoad60));
+	pucName = prvPut16(pucName, pxStatus->usStackHighWaterMark);
+	pucName = prvPut16(pucName, ulVoluntary);
+	pucName = prvPut16(pucName, ulInvoluntary);
+
+	/* The name fills the rest of the payload, without its terminator. */
+	for (i = 0; (i < configMAX_TASK_NAME_LEN) && (pxStatus->pcTaskName[i] != '\0'); i++)
+		pucName[i] = (uint8_t) pxStatus->pcTaskName[i];
+
+	prvSendTopFrame(mainTOP_FRAME_TASK, ucPayload, (uint8_t) (12 + i));
+#endif
+}
+
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+/**
+ * @brief Prints the interrupt handlers' line of the top report.
+ *
+ * TOPI,<2 s>,<10 s>,<60 s>
+ *
+ * @param ulPermille The interrupt handlers' share of the CPU since the last report.
+ * @param ulLoad10 The 10 s average, as kept by prvUpdateLoad().
+ * @param ulLoad60 The 60 s average, as kept by prvUpdateLoad().
+ */
+static void prvPrintTopISR( unsigned long ulPermille, unsigned long ulLoad10, unsigned long ulLoad60 )
+{
+#if ( mainTOP_OUTPUT == mainTOP_TEXT )
+	vSendStringToUART("ISR\t");
+	prvSendPermille(ulPermille);
+	vSendStringToUART("%\t");
+	prvSendPermille(mainLOAD_TO_PERMILLE(ulLoad10));
+	vSendStringToUART("%\t");
+	prvSendPermille(mainLOAD_TO_PERMILLE(ulLoad60));
+	vSendStringToUART("%\t-\t\t-\t-\t-\t-\t-\r\n");
+#elif ( mainTOP_OUTPUT == mainTOP_CSV )
+	char value[12];
+
+	vSendStringToUART("TOPI,");
+	prvSendCSVField(ulPermille);
+	prvSendCSVField(mainLOAD_TO_PERMILLE(ulLoad10));
+	cUnsignedIntToString(mainLOAD_TO_PERMILLE(ulLoad60), value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\r\n");
+#else
+	uint8_t ucPayload[6];
+
+	prvPut16(prvPut16(prvPut16(ucPayload, ulPermille), mainLOAD_TO_PERMILLE(ulLoad10)), mainLOAD_TO_PERMILLE(ulLoad60));
+	prvSendTopFrame(mainTOP_FRAME_ISR, ucPayload, sizeof(ucPayload));
+#endif
+}
+#endif
+
 /**
  * @brief Prints the task statistics to the UART.
+ *
+ * CPU shares are taken over the time since the last report rather than since
+ * boot, so a burst shows in the report that follows it, and are averaged over
+ * 10 s and 60 s.
+ */
+void vPrintTopStats(void)
+{
+	UBaseType_t uxArraySize;
+	UBaseType_t x;
+	TopWindow_t *pxWindow;
+
+	unsigned long ulNow;
+	unsigned long ulWindow;
+	unsigned long ulPermille;
+	unsigned long ulVoluntary = 0;
+	unsigned long ulInvoluntary = 0;
+
+	uxArraySize = prvRefreshTaskStatus();
+
+	ulNow = portGET_RUN_TIME_COUNTER_VALUE();
+	ulWindow = ulNow - ulLastTopRunTime;
+
+	if ((uxArraySize == 0) || (ulWindow == 0))
+		return;
+
+	ulLastTopRunTime = ulNow;
+
+#if ( mainTOP_OUTPUT != mainTOP_BINARY )
+	vSendStringToUART("\r");
+#endif
+
+	prvPrintTopHeader(ulWindow, uxArraySize);
+
+	for (x = 0; x < uxArraySize; x++)
+	{
+		pxWindow = &pxTopWindows[x];
+
+		/* The task's counter is read a little after ulNow for the tasks
+		refreshed later, so the share can round over 100%. */
+		ulPermille = (pxTaskStatusArray[x].ulRunTimeCounter - pxWindow->ulLastRunTime) * mainPERMILLE / ulWindow;
+
+		if (ulPermille > mainPERMILLE)
+			ulPermille = mainPERMILLE;
+
+		pxWindow->ulLastRunTime = pxTaskStatusArray[x].ulRunTimeCounter;
+		pxWindow->ulLoad10 = prvUpdateLoad(pxWindow->ulLoad10, mainLOAD_EXP_10, ulPermille);
+		pxWindow->ulLoad60 = prvUpdateLoad(pxWindow->ulLoad60, mainLOAD_EXP_60, ulPermille);
+
+#if ( configRECORD_CONTEXT_SWITCHES == 1 )
+		ulVoluntary = pxTaskStatusArray[x].uxVoluntarySwitches - pxWindow->uxLastVoluntary;
+		ulInvoluntary = pxTaskStatusArray[x].uxInvoluntarySwitches - pxWindow->uxLastInvoluntary;
+		pxWindow->uxLastVoluntary = pxTaskStatusArray[x].uxVoluntarySwitches;
+		pxWindow->uxLastInvoluntary = pxTaskStatusArray[x].uxInvoluntarySwitches;
+#endif
+
+		prvPrintTopTask(&pxTaskStatusArray[x], pxWindow, ulPermille, ulVoluntary, ulInvoluntary);
+	}
+
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+	/* The time in the interrupt handlers, which the kernel has taken off the
+	tasks they interrupted. */
+	ulPermille = (ulTaskGetInterruptRunTimeCounter() - ulLastISRRunTime) * mainPERMILLE / ulWindow;
+
+	if (ulPermille > mainPERMILLE)
+		ulPermille = mainPERMILLE;
+
+	ulLastISRRunTime = ulTaskGetInterruptRunTimeCounter();
+	ulISRLoad10 = prvUpdateLoad(ulISRLoad10, mainLOAD_EXP_10, ulPermille);
+	ulISRLoad60 = prvUpdateLoad(ulISRLoad60, mainLOAD_EXP_60, ulPermille);
+
+	prvPrintTopISR(ulPermille, ulISRLoad10, ulISRLoad60);
+
+	vPrintISRStats();
+#endif
+
+#if ( configRECORD_JOB_TIMES == 1 )
+	vPrintSchedStats(uxArraySize);
+#endif
+
+#if ( configUSE_HEAP_TRACE == 1 )
+	vPrintHeapTrace();
+#endif
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+	vPrintSleepStats();
+#endif
+
+#if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+	vPrintCriticalStats();
+#endif
+
+	vSendStringToUART("\r\n\r\n\r\n");
+}
+
+#if ( configRECORD_JOB_TIMES == 1 )
+/**
+ * @brief Prints the observed task set as CSV lines for the response time analyzer.
+ * 
+ * Uses the array filled by vPrintTopStats. Times are in run time counter units.
+ * The lines can be fed to tools/rta.py to check the task set is schedulable:
+ * 
+ * SCHEDHZ,<run time counter Hz>,<tick Hz>
+ * SCHED,<task>,<priority>,<min interval>,<max job time>,<jobs>
+ * 
+ * @param uxArraySize The number of valid entries in pxTaskStatusArray.
  */
-void vPrintTopStats(void) 
+void vPrintSchedStats( UBaseType_t uxArraySize )
 {
-    volatile UBaseType_t uxArraySize;
-    volatile UBaseType_t x;
+	UBaseType_t x;
+	char value[12];
+
+	vSendStringToUART("SCHEDHZ,");
+	cUnsignedIntToString(mainRUN_TIME_COUNTER_HZ, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART(",");
+	cUnsignedIntToString(configTICK_RATE_HZ, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\r\n");
+
+	for (x = 0; x < uxArraySize; x++)
+	{
+		vSendStringToUART("SCHED,");
+		vSendStringToUART(pxTaskStatusArray[x].pcTaskName);
+		vSendStringToUART(",");
+		cUnsignedIntToString(pxTaskStatusArray[x].uxCurrentPriority, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString(pxTaskStatusArray[x].ulMinJobInterval, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString(pxTaskStatusArray[x].ulMaxJobRunTime, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString(pxTaskStatusArray[x].uxJobCount, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART("\r\n");
+	}
+}
+#endif
 
-    unsigned long ulTotalRunTime;
-    unsigned long ulStatsAsPercentage;
 
-	char counter[12];
-	char percentage[12];
-	char stack[12];
+#if ( configUSE_HEAP_TRACE == 1 )
+/**
+ * @brief Prints the heap trace records for the allocation profiler.
+ * 
+ * Drains the ring buffer filled by heap_trace.c. Addresses are in hex, time
+ * stamps in run time counter units. The lines can be fed to tools/heapprof.py
+ * to find the call sites that churn the heap:
+ * 
+ * HEAPTHZ,<run time counter Hz>,<records dropped so far>
+ * HEAPT,<m|f>,<address>,<caller>,<time stamp>,<block size>,<free bytes>
+ */
+void vPrintHeapTrace( void )
+{
+	HeapTraceRecord_t xRecord;
+	char value[12];
+
+	vSendStringToUART("HEAPTHZ,");
+	cUnsignedIntToString(mainRUN_TIME_COUNTER_HZ, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART(",");
+	cUnsignedIntToString(ulHeapTraceGetDroppedCount(), value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\r\n");
+
+	while (xHeapTraceRead(&xRecord) == pdTRUE)
+	{
+		vSendStringToUART(xRecord.ucOperation == heapTRACE_MALLOC ? "HEAPT,m," : "HEAPT,f,");
+		cUnsignedIntToString((unsigned) xRecord.pvAddress, value, 16);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString((unsigned) xRecord.pvCaller, value, 16);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString(xRecord.ulTimeStamp, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString(xRecord.xBlockSize, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART(",");
+		cUnsignedIntToString(xRecord.xFreeBytesRemaining, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART("\r\n");
+	}
+}
+#endif
 
-    if (pxTaskStatusArray != NULL) 
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+/**
+ * @brief Prints the interrupt handler statistics since the last report.
+ * 
+ * For each timed handler: the number of times it ran, its rate per second,
+ * its share of the processor time and the longest it ran for in processor
+ * clocks. Times leave out the handlers that interrupted it.
+ */
+void vPrintISRStats( void )
+{
+	unsigned long ulCount[mainISR_COUNT], ulClocks[mainISR_COUNT], ulMaxClocks[mainISR_COUNT];
+	unsigned long ulWindow, ulPercent;
+	TickType_t xNow;
+	char value[12];
+	int i;
+
+	taskENTER_CRITICAL();
 	{
-        uxArraySize = uxTaskGetSystemState(pxTaskStatusArray, uxArraySize, &ulTotalRunTime);
+		xNow = xTaskGetTickCount();
+		ulWindow = (unsigned long) (xNow - xLastISRReport);
+		xLastISRReport = xNow;
 
-        ulTotalRunTime /= 100UL;
+		for (i = 0; i < mainISR_COUNT; i++)
+		{
+			ulCount[i] = ulISRCount[i];
+			ulClocks[i] = ulISRClocks[i];
+			ulMaxClocks[i] = ulISRMaxClocks[i];
+			ulISRCount[i] = 0;
+			ulISRClocks[i] = 0;
+			ulISRMaxClocks[i] = 0;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if (ulWindow == 0)
+		return;
 
-        vSendStringToUART("\r");
+	vSendStringToUART("IRQ\tCOUNT\tRATE/s\tCPU%\tMAX CLK\r\n");
+
+	for (i = 0; i < mainISR_COUNT; i++)
+	{
+		vSendStringToUART(pcISRNames[i]);
+		vSendStringToUART("\t");
+		cUnsignedIntToString(ulCount[i], value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART("\t");
+		cUnsignedIntToString(ulCount[i] * configTICK_RATE_HZ / ulWindow, value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART("\t");
+
+		/* The window in clocks divided by 100. */
+		ulPercent = ulClocks[i] / (ulWindow * (configCPU_CLOCK_HZ / configTICK_RATE_HZ / 100));
+		cUnsignedIntToString(ulPercent, value, 10);
+		vSendStringToUART(ulPercent > 0 || ulClocks[i] == 0 ? value : "<1");
+		vSendStringToUART("%\t");
+		cUnsignedIntToString(ulMaxClocks[i], value, 10);
+		vSendStringToUART(value);
+		vSendStringToUART("\r\n");
+	}
+}
+#endif
 
-        if (ulTotalRunTime > 0) 
+#if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+/**
+ * @brief Prints the longest critical sections and scheduler suspensions.
+ * 
+ * Times are in processor clocks, from the DWT cycle counter, and cover the
+ * whole run rather than the last report. The counter stops while the
+ * processor sleeps, so the idle task's suspension around a tickless sleep
+ * does not include the sleep. Kinds are c (interrupts masked) and s
+ * (scheduler suspended). The lines can be fed to tools/critprof.py to name
+ * the call sites and bound the interrupt latency:
+ * 
+ * CRITHZ,<timer Hz>
+ * CRIT,<c|s>,<caller>,<longest>
+ * CRITH,<c|s>,<bucket 0>,...,<bucket configCRITICAL_SECTION_BUCKETS - 1>
+ */
+void vPrintCriticalStats( void )
+{
+	CriticalSectionRecord_t xRecords[configCRITICAL_SECTION_TOP_COUNT];
+	uint32_t ulHistogram[configCRITICAL_SECTION_BUCKETS];
+	const char *pcKindNames[critprofKINDS] = { "c,", "s," };
+	UBaseType_t uxRecords, x;
+	uint8_t ucKind;
+	char value[12];
+
+	vSendStringToUART("CRITHZ,");
+	cUnsignedIntToString(configCPU_CLOCK_HZ, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("\r\n");
+
+	for (ucKind = 0; ucKind < critprofKINDS; ucKind++)
+	{
+		uxRecords = uxCriticalSectionGetLongest(ucKind, xRecords, configCRITICAL_SECTION_TOP_COUNT);
+
+		for (x = 0; x < uxRecords; x++)
 		{
-            vSendStringToUART("TASK\tCPU%\tSTACK FREE\tTICKS\r\n");
-			vSendStringToUART("---------------------------------------\r\n");
-
-            for (x = 0; x < uxArraySize; x++) 
-			{
-                ulStatsAsPercentage = pxTaskStatusArray[x].ulRunTimeCounter / ulTotalRunTime;
-
-                cUnsignedIntToString(pxTaskStatusArray[x].ulRunTimeCounter, counter, 10);
-                cUnsignedIntToString(ulStatsAsPercentage, percentage, 10);
-                cUnsignedIntToString(pxTaskStatusArray[x].usStackHighWaterMark, stack, 10);
-
-                vSendStringToUART(pxTaskStatusArray[x].pcTaskName);
-                vSendStringToUART("\t");
-                vSendStringToUART(ulStatsAsPercentage > 0 ? percentage : "<1");
-                vSendStringToUART("%\t");
-                vSendStringToUART(stack);
-                vSendStringToUART("\t\t");
-                vSendStringToUART(counter);
-                vSendStringToUART("\r\n");
-            }
+			vSendStringToUART("CRIT,");
+			vSendStringToUART(pcKindNames[ucKind]);
+			cUnsignedIntToString((unsigned) xRecords[x].pvCaller, value, 16);
+			vSendStringToUART(value);
+			vSendStringToUART(",");
+			cUnsignedIntToString(xRecords[x].ulCounts, value, 10);
+			vSendStringToUART(value);
+			vSendStringToUART("\r\n");
+		}
 
-            vSendStringToUART("\r\n\r\n\r\n");
-        }
-    }
+		vCriticalSectionGetHistogram(ucKind, ulHistogram);
+		vSendStringToUART("CRITH,");
+		vSendStringToUART(pcKindNames[ucKind]);
+
+		for (x = 0; x < configCRITICAL_SECTION_BUCKETS; x++)
+		{
+			cUnsignedIntToString(ulHistogram[x], value, 10);
+			vSendStringToUART(value);
+			vSendStringToUART(x < configCRITICAL_SECTION_BUCKETS - 1 ? "," : "\r\n");
+		}
+	}
+}
+#endif
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+/**
+ * @brief Prints the sleep statistics since the last report.
+ * 
+ * SLEEP is the share of the time spent asleep, the number of times the
+ * processor went to sleep and the tick interrupts that were suppressed.
+ * WAKE counts the interrupts that ended the sleeps: the tick (the expected
+ * idle time ran out), the UART, the high resolution timer and anything else.
+ */
+void vPrintSleepStats( void )
+{
+	unsigned long ulNow, ulWindow, ulSlept, ulSleeps, ulTicks;
+	unsigned long ulWakes[mainWAKE_SOURCES];
+	const char *pcWakeNames[mainWAKE_SOURCES] = { "\ttick ", "\tuart ", "\thrtimer ", "\tother " };
+	char value[12];
+	int i;
+
+	taskENTER_CRITICAL();
+	{
+		ulNow = ulHRTimerGetHardwareTime();
+		ulWindow = ulNow - ulLastSleepReport;
+		ulSlept = ulSleepClocks;
+		ulSleeps = ulSleepCount;
+		ulTicks = ulTicksSuppressed;
+
+		for (i = 0; i < mainWAKE_SOURCES; i++)
+		{
+			ulWakes[i] = ulWakeCount[i];
+			ulWakeCount[i] = 0;
+		}
+
+		ulLastSleepReport = ulNow;
+		ulSleepClocks = 0;
+		ulSleepCount = 0;
+		ulTicksSuppressed = 0;
+	}
+	taskEXIT_CRITICAL();
+
+	vSendStringToUART("SLEEP\t");
+	cUnsignedIntToString(ulWindow >= 100 ? ulSlept / (ulWindow / 100) : 0, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART("%\t");
+	cUnsignedIntToString(ulSleeps, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART(" sleeps\t");
+	cUnsignedIntToString(ulTicks, value, 10);
+	vSendStringToUART(value);
+	vSendStringToUART(" ticks suppressed\r\n");
+
+	vSendStringToUART("WAKE");
+
+	for (i = 0; i < mainWAKE_SOURCES; i++)
+	{
+		vSendStringToUART(pcWakeNames[i]);
+		cUnsignedIntToString(ulWakes[i], value, 10);
+		vSendStringToUART(value);
+	}
+
+	vSendStringToUART("\r\n");
+}
+
+/**
+ * @brief Called by the kernel with interrupts masked just before the processor sleeps.
+ * 
+ * Timer0 interrupts every 75 us to drive the run time stats, so it is stopped
+ * and its clock gated while the processor sleeps, as is the clock of the I2C
+ * controller the LCD is driven through.
+ * 
+ * @param ulExpectedIdleTime The number of ticks the kernel expects to sleep (not used).
+ */
+void vPreSleepProcessing( unsigned long ulExpectedIdleTime )
+{
+	( void ) ulExpectedIdleTime;
+
+	TimerDisable(TIMER0_BASE, TIMER_A);
+	SysCtlPeripheralDisable(SYSCTL_PERIPH_TIMER0);
+	SysCtlPeripheralDisable(SYSCTL_PERIPH_I2C);
+
+	ulSleepStart = ulHRTimerGetHardwareTime();
 }
 
+/**
+ * @brief Called by the kernel with interrupts still masked when the processor wakes.
+ * 
+ * Accounts for the time asleep, moves the run time counter on by the time
+ * Timer0 was stopped so the sleep is charged to the idle task, records the
+ * interrupt that ended the sleep and ungates the peripherals.
+ * 
+ * @param ulExpectedIdleTime The number of ticks the kernel expected to sleep (not used).
+ */
+void vPostSleepProcessing( unsigned long ulExpectedIdleTime )
+{
+	unsigned long ulSlept = ulHRTimerGetHardwareTime() - ulSleepStart;
+	unsigned long ulPending;
+
+	( void ) ulExpectedIdleTime;
+
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_I2C);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+
+	ulSleepClocks += ulSlept;
+	ulSleepCount++;
+	ulTicksSuppressed += ulSlept / mainCLOCKS_PER_TICK;
+
+	ulRunTimeRemainder += ulSlept;
+	ulHighFrequencyTimerTicks += ulRunTimeRemainder / mainRUN_TIME_TIMER_LOAD;
+	ulRunTimeRemainder %= mainRUN_TIME_TIMER_LOAD;
+
+	/* The interrupt that woke the processor has not run yet, so it is the
+	pending exception. */
+	ulPending = (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_PEN_M) >> NVIC_INT_CTRL_VEC_PEN_S;
+
+	switch (ulPending)
+	{
+		case FAULT_SYSTICK:	ulWakeCount[mainWAKE_TICK]++;		break;
+		case INT_UART0:		ulWakeCount[mainWAKE_UART]++;		break;
+		case INT_TIMER1A:	ulWakeCount[mainWAKE_HR_TIMER]++;	break;
+		default:			ulWakeCount[mainWAKE_OTHER]++;		break;
+	}
+
+	TimerEnable(TIMER0_BASE, TIMER_A);
+}
+#endif
 
 /*---------------------------HANDLERS------------------------*/
 /**
@@ -633,6 +1702,17 @@ void Timer0IntHandler( void )
 	ulHighFrequencyTimerTicks++;
 }
 
+#if ( configUSE_HR_TIMERS == 1 )
+/**
+ * @brief The interrupt handler for Timer1, the high resolution timer compare.
+ */
+void Timer1IntHandler( void )
+{
+	TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+	portEND_SWITCHING_ISR( xHRTimerInterruptHandler() );
+}
+#endif
+
 /**
  * @brief The interrupt handler for the UART.
  * 
@@ -656,3 +1736,109 @@ void vUART_ISR(void)
         }
     }
 }
+
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+/**
+ * @brief The vector of every timed handler except PendSV.
+ *
+ * Looks up the handler of the active exception, calls it and records the
+ * time it took.
+ */
+static void prvISRDispatch( void )
+{
+	unsigned long ulStart, ulNestedAtStart, ulException, i;
+
+	/* The cycle counter is read first so a handler that interrupts between
+	the two reads is charged to this one rather than leaving it negative. */
+	ulStart = HWREG(mainDWT_CYCCNT);
+	ulNestedAtStart = ulISRClocksTotal;
+	ulException = HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M;
+
+	for (i = 0; i < mainISR_COUNT; i++)
+	{
+		if (ulISRExceptions[i] == ulException)
+		{
+			pfnISRHandlers[i]();
+			prvRecordISR(i, ulStart, ulNestedAtStart);
+			break;
+		}
+	}
+}
+
+/**
+ * @brief The PendSV vector.
+ *
+ * xPortPendSVHandler() switches the task registers, so it cannot be called
+ * from C, which would restore the registers it saved on return.  This calls
+ * it with only r0 and the EXC_RETURN value in lr saved on the main stack, and
+ * times it with calls to C functions, which preserve r4 to r11.  PendSV
+ * returns by loading EXC_RETURN into the pc.
+ */
+static void prvPendSVDispatch( void )
+{
+	__asm volatile
+	(
+		"	push {r0, lr}					\n" /* r0 keeps the stack 8 byte aligned. */
+		"	bl vPendSVAccountingEnter		\n"
+		"	bl xPortPendSVHandler			\n"
+		"	bl vPendSVAccountingExit		\n"
+		"	pop {r0, pc}					\n"
+	);
+}
+
+/**
+ * @brief Called by prvPendSVDispatch() before the PendSV handler.
+ */
+void vPendSVAccountingEnter( void )
+{
+	ulPendSVStart = HWREG(mainDWT_CYCCNT);
+	ulPendSVNestedAtStart = ulISRClocksTotal;
+}
+
+/**
+ * @brief Called by prvPendSVDispatch() after the PendSV handler.
+ *
+ * The kernel has already switched the run time stats to the task that was
+ * selected, so the time of the whole handler is taken off that task.
+ */
+void vPendSVAccountingExit( void )
+{
+	prvRecordISR(mainISR_PENDSV, ulPendSVStart, ulPendSVNestedAtStart);
+}
+
+/**
+ * @brief Records the time a handler took and reports it to the kernel.
+ *
+ * @param ulIndex The index of the handler in ulISRExceptions[].
+ * @param ulStart The cycle counter when the handler was entered.
+ * @param ulNestedAtStart ulISRClocksTotal when the handler was entered.
+ */
+static void prvRecordISR( unsigned long ulIndex, unsigned long ulStart, unsigned long ulNestedAtStart )
+{
+	unsigned long ulClocks, ulSavedInterruptStatus;
+
+	ulSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		/* Leave out the handlers that interrupted this one, which have been
+		recorded already. */
+		ulClocks = (HWREG(mainDWT_CYCCNT) - ulStart) - (ulISRClocksTotal - ulNestedAtStart);
+		ulISRClocksTotal += ulClocks;
+
+		ulISRCount[ulIndex]++;
+		ulISRClocks[ulIndex] += ulClocks;
+
+		if (ulClocks > ulISRMaxClocks[ulIndex])
+			ulISRMaxClocks[ulIndex] = ulClocks;
+
+		/* Give the kernel whole run time counter periods, carrying the rest. */
+		ulISRClocksRemainder += ulClocks;
+
+		if (ulISRClocksRemainder >= mainRUN_TIME_TIMER_LOAD)
+		{
+			vTaskAddInterruptRunTime(ulISRClocksRemainder / mainRUN_TIME_TIMER_LOAD);
+			ulISRClocksRemainder %= mainRUN_TIME_TIMER_LOAD;
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(ulSavedInterruptStatus);
+}
+#endif
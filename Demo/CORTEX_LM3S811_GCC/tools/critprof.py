@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Critical section profiler for the FreeRTOS critical section timing.
+
+Reads the CRITHZ/CRIT/CRITH lines the demo prints over the UART when
+configRECORD_CRITICAL_SECTION_TIMES is 1, symbolizes the call sites against
+the demo image and reports, for critical sections (interrupts masked) and
+scheduler suspensions:
+
+    longest         the call sites that held the region longest
+    histogram       the distribution of the time each region was held
+
+The kernel keeps the longest regions and the histograms from the start of the
+run, so only the last report in each log is used.  A call site is the return
+address into the function that entered the region, so critical sections
+entered through taskENTER_CRITICAL() show the kernel or application function
+that used the macro.
+
+The longest critical section is the longest an interrupt at or below
+configMAX_SYSCALL_INTERRUPT_PRIORITY can be held off by task code, which is
+reported as a lower bound on the interrupt latency.  Interrupts masked from
+interrupt handlers, and the masking in the context switch and tickless idle,
+are not timed.
+
+Usage:
+    critprof.py --axf gcc/RTOSDemo.axf uart.log
+"""
+
+import argparse
+import sys
+
+from heapprof import symbolize
+
+KINDS = { "c": "Critical sections (interrupts masked)", "s": "Scheduler suspensions" }
+
+
+def load_log( path ):
+    """Return the timer frequency, and the longest regions and histogram of each kind, from the last report."""
+    timer_hz = None
+    longest = {}
+    histograms = {}
+
+    with open( path, errors = "replace" ) as f:
+        for line in f:
+            # vSendStringToUART() sends a NUL after every string.
+            fields = line.replace( "\0", "" ).strip().split( "," )
+
+            if fields[ 0 ] == "CRITHZ" and len( fields ) >= 2:
+                # Each report starts with a CRITHZ line.
+                timer_hz = float( fields[ 1 ] )
+                longest = { kind: [] for kind in KINDS }
+                histograms = {}
+            elif fields[ 0 ] == "CRIT" and len( fields ) >= 4 and fields[ 1 ] in longest:
+                longest[ fields[ 1 ] ].append( ( int( fields[ 2 ], 16 ), int( fields[ 3 ] ) ) )
+            elif fields[ 0 ] == "CRITH" and len( fields ) >= 3 and fields[ 1 ] in KINDS:
+                histograms[ fields[ 1 ] ] = [ int( count ) for count in fields[ 2: ] ]
+
+    if timer_hz is None:
+        raise ValueError( "%s: no CRITHZ line found - is configRECORD_CRITICAL_SECTION_TIMES set to 1?" % path )
+
+    return timer_hz, longest, histograms
+
+
+def to_us( counts, timer_hz ):
+    return counts * 1000000.0 / timer_hz
+
+
+def bucket_label( bucket, buckets ):
+    low = 1 << ( bucket - 1 ) if bucket > 0 else 0
+
+    if bucket == 0:
+        return "0"
+    elif bucket == buckets - 1:
+        return ">= %d" % low
+    elif low == 1:
+        return "1"
+    else:
+        return "%d-%d" % ( low, 2 * low - 1 )
+
+
+def report( path, timer_hz, longest, histograms, args ):
+    callers = { caller for records in longest.values() for caller, counts in records }
+    names = symbolize( callers, args.axf, args.addr2line )
+
+    print( "%s: times in %.0f Hz timer counts" % ( path, timer_hz ) )
+
+    for kind, title in KINDS.items():
+        records = longest.get( kind, [] )
+        histogram = histograms.get( kind, [] )
+
+        print()
+        print( "  %s, %d timed" % ( title, sum( histogram ) ) )
+        print( "  %10s %10s  %s" % ( "COUNTS", "US", "SITE" ) )
+
+        for caller, counts in records:
+            print( "  %10d %10.1f  %s" % ( counts, to_us( counts, timer_hz ), names[ caller ] ) )
+
+        if histogram and max( histogram ) > 0:
+            widest = max( histogram )
+            print()
+
+            for bucket, count in enumerate( histogram ):
+                if count:
+                    print( "  %14s %9d  %s" % ( bucket_label( bucket, len( histogram ) ), count, "#" * max( 1, count * 40 // widest ) ) )
+
+    masked = longest.get( "c", [] )
+
+    print()
+
+    if masked:
+        counts = masked[ 0 ][ 1 ]
+        print( "  Interrupts were masked by task code for at most %d counts (%.1f us), in %s" %
+               ( counts, to_us( counts, timer_hz ), names[ masked[ 0 ][ 0 ] ] ) )
+        print( "  so the worst case interrupt latency is at least that plus the interrupt entry time" )
+    else:
+        print( "  No critical sections were timed" )
+
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser( description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter )
+    parser.add_argument( "logs", nargs = "+", help = "UART captures containing CRIT lines" )
+    parser.add_argument( "--axf", help = "the image the profile was taken from, used to name the call sites" )
+    parser.add_argument( "--addr2line", default = "arm-none-eabi-addr2line" )
+    args = parser.parse_args()
+
+    for path in args.logs:
+        timer_hz, longest, histograms = load_log( path )
+        report( path, timer_hz, longest, histograms, args )
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit( main() )
@@ -0,0 +1,27 @@
+/*
+ * Configuration used only to build the FreeRTOS heap implementations into
+ * heapbench.  configTOTAL_HEAP_SIZE sizes heap_2.c and heap_4.c - heapbench
+ * gives heap_5.c and heap_6.c a region of the same size.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION                1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 0
+#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 20000000 )
+#define configTICK_RATE_HZ                  ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 128 )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 64 * 1024 ) )
+#define configMAX_TASK_NAME_LEN             ( 10 )
+#define configUSE_16_BIT_TICKS              0
+#define configMAX_PRIORITIES                ( 5 )
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configUSE_MALLOC_FAILED_HOOK        0
+
+#define configASSERT( x )                   assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,487 @@
+/*
+ * heapbench - replays allocation traces against the FreeRTOS heap
+ * implementations on the host and reports how long each pvPortMalloc() and
+ * vPortFree() took, so the worst case as well as the average can be compared.
+ *
+ * Each heap_n.c is compiled with its API renamed to heapn_<function> (see the
+ * heapbench rule in the demo Makefile) so all of them can be linked into one
+ * program and fed exactly the same operations.
+ *
+ * A trace is a text file with one operation per line:
+ *     a <id> <size>    allocate <size> bytes and remember the block as <id>
+ *     f <id>           free the block remembered as <id>
+ * Lines starting with # are ignored.  Frees of ids whose allocation failed are
+ * skipped.  With no trace file the built in synthetic traces are replayed.
+ *
+ * For each heap and trace the mean, 99th percentile, 99.9th percentile and
+ * maximum time of the malloc and free calls is printed, followed by the number
+ * of failed allocations and, where the heap provides vPortGetHeapStats(), the
+ * number of free blocks and the largest free block at the end of the trace.
+ *
+ * heap_6.c is also built a second time, as heap6l_<function>, and given a
+ * region larger than its largest block before the traces are replayed, to
+ * check the region is truncated to a block the free lists can hold and most
+ * of that block can be allocated.
+ *
+ * Usage:
+ *     heapbench [-n operations] [-s seed] [trace ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define benchMAX_IDS         4096
+#define benchDEFAULT_OPS     200000
+
+/* Larger than the largest heap_6 block with its default configuration. */
+#define benchLARGE_REGION    ( ( size_t ) ( 3 * 1024 * 1024 ) )
+
+/* The scheduler is not used, so suspending it has nothing to do. */
+void vTaskSuspendAll( void )
+{
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+    return pdFALSE;
+}
+
+#define benchDECLARE_HEAP( name )                                           \
+    void * name ## _pvPortMalloc( size_t xWantedSize );                     \
+    void name ## _vPortFree( void * pv );                                   \
+    void name ## _vPortGetHeapStats( HeapStats_t * pxHeapStats )
+
+benchDECLARE_HEAP( heap2 );
+benchDECLARE_HEAP( heap4 );
+benchDECLARE_HEAP( heap5 );
+benchDECLARE_HEAP( heap6 );
+void heap5_vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions );
+void heap6_vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions );
+benchDECLARE_HEAP( heap6l );
+void heap6l_vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions );
+
+typedef struct BENCH_HEAP
+{
+    const char * pcName;
+    void * ( *pvMalloc )( size_t xWantedSize );
+    void ( * vFree )( void * pv );
+    void ( * vGetHeapStats )( HeapStats_t * pxHeapStats ); /* NULL if the heap does not provide stats. */
+} BenchHeap_t;
+
+static const BenchHeap_t xHeaps[] =
+{
+    { "heap_2", heap2_pvPortMalloc, heap2_vPortFree, NULL                   },
+    { "heap_4", heap4_pvPortMalloc, heap4_vPortFree, heap4_vPortGetHeapStats },
+    { "heap_5", heap5_pvPortMalloc, heap5_vPortFree, heap5_vPortGetHeapStats },
+    { "heap_6", heap6_pvPortMalloc, heap6_vPortFree, heap6_vPortGetHeapStats }
+};
+
+#define benchNUM_HEAPS    ( sizeof( xHeaps ) / sizeof( xHeaps[ 0 ] ) )
+
+/* heap_2.c and heap_4.c allocate their own configTOTAL_HEAP_SIZE array.  The
+ * heaps that take regions are given arrays of the same size. */
+static uint8_t ucHeap5Region[ configTOTAL_HEAP_SIZE ];
+static uint8_t ucHeap6Region[ configTOTAL_HEAP_SIZE ];
+static uint8_t ucHeap6LargeRegion[ benchLARGE_REGION ];
+
+typedef struct BENCH_OP
+{
+    char cOp;        /* 'a' or 'f'. */
+    unsigned uId;
+    size_t xSize;
+} BenchOp_t;
+
+typedef struct BENCH_TRACE
+{
+    const char * pcName;
+    BenchOp_t * pxOps;
+    size_t xCount;
+} BenchTrace_t;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t ulSeed = 1U;
+
+static uint32_t prvRand( void )
+{
+    /* xorshift32, so traces are the same on every host. */
+    ulSeed ^= ulSeed << 13;
+    ulSeed ^= ulSeed >> 17;
+    ulSeed ^= ulSeed << 5;
+    return ulSeed;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddOp( BenchTrace_t * pxTrace,
+                      size_t * pxCapacity,
+                      char cOp,
+                      unsigned uId,
+                      size_t xSize )
+{
+    if( pxTrace->xCount == *pxCapacity )
+    {
+        *pxCapacity = ( *pxCapacity == 0 ) ? 1024 : *pxCapacity * 2;
+        pxTrace->pxOps = realloc( pxTrace->pxOps, *pxCapacity * sizeof( BenchOp_t ) );
+
+        if( pxTrace->pxOps == NULL )
+        {
+            fprintf( stderr, "heapbench: out of memory\n" );
+            exit( 2 );
+        }
+    }
+
+    pxTrace->pxOps[ pxTrace->xCount ].cOp = cOp;
+    pxTrace->pxOps[ pxTrace->xCount ].uId = uId;
+    pxTrace->pxOps[ pxTrace->xCount ].xSize = xSize;
+    pxTrace->xCount++;
+}
+/*-----------------------------------------------------------*/
+
+/* Random sizes and lifetimes, keeping the heap around half full. */
+static BenchTrace_t prvMakeRandomTrace( size_t xOps )
+{
+    BenchTrace_t xTrace = { "random", NULL, 0 };
+    size_t xCapacity = 0, xLive = 0, x;
+    static unsigned char ucLive[ benchMAX_IDS ];
+    unsigned uId;
+
+    memset( ucLive, 0, sizeof( ucLive ) );
+
+    for( x = 0; x < xOps; x++ )
+    {
+        uId = prvRand() % benchMAX_IDS;
+
+        if( ucLive[ uId ] != 0 )
+        {
+            prvAddOp( &xTrace, &xCapacity, 'f', uId, 0 );
+            ucLive[ uId ] = 0;
+            xLive--;
+        }
+        else if( xLive < 200 )
+        {
+            prvAddOp( &xTrace, &xCapacity, 'a', uId, 8 + ( prvRand() % 256 ) );
+            ucLive[ uId ] = 1;
+            xLive++;
+        }
+    }
+
+    return xTrace;
+}
+/*-----------------------------------------------------------*/
+
+/* Many long lived small blocks interleaved with short lived ones, leaving a
+ * long free list of small holes in front of the large free space - the worst
+ * case for a first fit search. */
+static BenchTrace_t prvMakeFragmentTrace( size_t xOps )
+{
+    BenchTrace_t xTrace = { "fragment", NULL, 0 };
+    size_t xCapacity = 0, x;
+    unsigned uId;
+
+    for( uId = 0; uId < 800; uId++ )
+    {
+        prvAddOp( &xTrace, &xCapacity, 'a', uId, 16 + ( uId & 1U ) * 8 );
+    }
+
+    for( uId = 0; uId < 800; uId += 2 )
+    {
+        prvAddOp( &xTrace, &xCapacity, 'f', uId, 0 );
+    }
+
+    for( x = 0; xTrace.xCount < xOps; x++ )
+    {
+        uId = 1000 + ( unsigned ) ( x % 64 );
+        prvAddOp( &xTrace, &xCapacity, 'a', uId, 64 + ( prvRand() % 512 ) );
+        prvAddOp( &xTrace, &xCapacity, 'f', uId, 0 );
+    }
+
+    return xTrace;
+}
+/*-----------------------------------------------------------*/
+
+/* Fixed size buffers allocated and freed in FIFO order, like a message
+ * queue of dynamically allocated packets. */
+static BenchTrace_t prvMakeFifoTrace( size_t xOps )
+{
+    BenchTrace_t xTrace = { "fifo", NULL, 0 };
+    size_t xCapacity = 0, x;
+    const unsigned uDepth = 64;
+
+    for( x = 0; xTrace.xCount < xOps; x++ )
+    {
+        prvAddOp( &xTrace, &xCapacity, 'a', ( unsigned ) ( x % benchMAX_IDS ), 128 );
+
+        if( x >= uDepth )
+        {
+            prvAddOp( &xTrace, &xCapacity, 'f', ( unsigned ) ( ( x - uDepth ) % benchMAX_IDS ), 0 );
+        }
+    }
+
+    return xTrace;
+}
+/*-----------------------------------------------------------*/
+
+static BenchTrace_t prvLoadTrace( const char * pcFileName )
+{
+    BenchTrace_t xTrace = { pcFileName, NULL, 0 };
+    size_t xCapacity = 0, xSize;
+    unsigned uId;
+    char cLine[ 128 ];
+    FILE * pxFile = fopen( pcFileName, "r" );
+
+    if( pxFile == NULL )
+    {
+        perror( pcFileName );
+        exit( 2 );
+    }
+
+    while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+    {
+        if( ( sscanf( cLine, "a %u %zu", &uId, &xSize ) == 2 ) && ( uId < benchMAX_IDS ) )
+        {
+            prvAddOp( &xTrace, &xCapacity, 'a', uId, xSize );
+        }
+        else if( ( sscanf( cLine, "f %u", &uId ) == 1 ) && ( uId < benchMAX_IDS ) )
+        {
+            prvAddOp( &xTrace, &xCapacity, 'f', uId, 0 );
+        }
+    }
+
+    fclose( pxFile );
+    return xTrace;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC, &xTime );
+    return ( ( uint64_t ) xTime.tv_sec * 1000000000ULL ) + ( uint64_t ) xTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompare( const void * pv1,
+                       const void * pv2 )
+{
+    const uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+    return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReport( uint64_t * pullTimes,
+                       size_t xCount )
+{
+    uint64_t ullTotal = 0;
+    size_t x;
+
+    if( xCount == 0 )
+    {
+        printf( " %6s %10s %10s %10s", "-", "-", "-", "-" );
+        return;
+    }
+
+    for( x = 0; x < xCount; x++ )
+    {
+        ullTotal += pullTimes[ x ];
+    }
+
+    qsort( pullTimes, xCount, sizeof( uint64_t ), prvCompare );
+    printf( " %6llu %10llu %10llu %10llu",
+            ( unsigned long long ) ( ullTotal / xCount ),
+            ( unsigned long long ) pullTimes[ ( xCount * 99 ) / 100 ],
+            ( unsigned long long ) pullTimes[ ( xCount * 999 ) / 1000 ],
+            ( unsigned long long ) pullTimes[ xCount - 1 ] );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReplay( const BenchHeap_t * pxHeap,
+                       const BenchTrace_t * pxTrace )
+{
+    static void * pvBlocks[ benchMAX_IDS ];
+    uint64_t * pullMallocTimes = malloc( pxTrace->xCount * sizeof( uint64_t ) );
+    uint64_t * pullFreeTimes = malloc( pxTrace->xCount * sizeof( uint64_t ) );
+    size_t xMallocs = 0, xFrees = 0, xFailures = 0, x;
+    uint64_t ullStart, ullEnd;
+    const BenchOp_t * pxOp;
+    HeapStats_t xStats;
+
+    if( ( pullMallocTimes == NULL ) || ( pullFreeTimes == NULL ) )
+    {
+        fprintf( stderr, "heapbench: out of memory\n" );
+        exit( 2 );
+    }
+
+    for( x = 0; x < pxTrace->xCount; x++ )
+    {
+        pxOp = &( pxTrace->pxOps[ x ] );
+
+        if( pxOp->cOp == 'a' )
+        {
+            if( pvBlocks[ pxOp->uId ] != NULL )
+            {
+                /* The trace reused a live id - treat it as a leak. */
+                pvBlocks[ pxOp->uId ] = NULL;
+            }
+
+            ullStart = prvNow();
+            pvBlocks[ pxOp->uId ] = pxHeap->pvMalloc( pxOp->xSize );
+            ullEnd = prvNow();
+            pullMallocTimes[ xMallocs++ ] = ullEnd - ullStart;
+
+            if( pvBlocks[ pxOp->uId ] == NULL )
+            {
+                xFailures++;
+            }
+            else
+            {
+                /* Touch the block so a heap that hands out overlapping
+                 * blocks corrupts itself visibly. */
+                memset( pvBlocks[ pxOp->uId ], 0xa5, pxOp->xSize );
+            }
+        }
+        else if( pvBlocks[ pxOp->uId ] != NULL )
+        {
+            ullStart = prvNow();
+            pxHeap->vFree( pvBlocks[ pxOp->uId ] );
+            ullEnd = prvNow();
+            pullFreeTimes[ xFrees++ ] = ullEnd - ullStart;
+            pvBlocks[ pxOp->uId ] = NULL;
+        }
+    }
+
+    printf( "%-10s %-7s", pxTrace->pcName, pxHeap->pcName );
+    prvReport( pullMallocTimes, xMallocs );
+    prvReport( pullFreeTimes, xFrees );
+    printf( " %8zu", xFailures );
+
+    if( pxHeap->vGetHeapStats != NULL )
+    {
+        pxHeap->vGetHeapStats( &xStats );
+        printf( " %8zu %8zu\n", xStats.xNumberOfFreeBlocks, xStats.xSizeOfLargestFreeBlockInBytes );
+    }
+    else
+    {
+        printf( " %8s %8s\n", "-", "-" );
+    }
+
+    /* Return everything so the next trace starts from an empty heap. */
+    for( x = 0; x < benchMAX_IDS; x++ )
+    {
+        if( pvBlocks[ x ] != NULL )
+        {
+            pxHeap->vFree( pvBlocks[ x ] );
+            pvBlocks[ x ] = NULL;
+        }
+    }
+
+    free( pullMallocTimes );
+    free( pullFreeTimes );
+}
+/*-----------------------------------------------------------*/
+
+/* Defines a heap_6 region larger than its largest block, then allocates half
+ * and seven eighths of the largest free block.  Allocating all of it would
+ * fail by design, as heap_6 rounds a request up to the next size class. */
+static int prvCheckLargeRegion( void )
+{
+    HeapRegion_t xRegions[] = { { ucHeap6LargeRegion, sizeof( ucHeap6LargeRegion ), 0 }, { NULL, 0, 0 } };
+    HeapStats_t xStats;
+    size_t xLargest, x;
+    void * pvBlock;
+    const size_t xEighths[] = { 4, 7, 4 };
+
+    heap6l_vPortDefineHeapRegions( xRegions );
+    heap6l_vPortGetHeapStats( &xStats );
+    xLargest = xStats.xSizeOfLargestFreeBlockInBytes;
+
+    for( x = 0; x < ( sizeof( xEighths ) / sizeof( xEighths[ 0 ] ) ); x++ )
+    {
+        pvBlock = heap6l_pvPortMalloc( ( xLargest / 8 ) * xEighths[ x ] );
+
+        if( ( xLargest < ( benchLARGE_REGION / 4 ) ) || ( pvBlock == NULL ) )
+        {
+            printf( "heap_6 with a %u KB region: %u/8 of a %u byte largest block failed\n",
+                    ( unsigned ) ( benchLARGE_REGION / 1024 ), ( unsigned ) xEighths[ x ], ( unsigned ) xLargest );
+            return 1;
+        }
+
+        heap6l_vPortFree( pvBlock );
+    }
+
+    heap6l_vPortGetHeapStats( &xStats );
+    printf( "heap_6 with a %u KB region: %u byte largest block, 7/8 of it allocated\n\n",
+            ( unsigned ) ( benchLARGE_REGION / 1024 ), ( unsigned ) xLargest );
+
+    return ( xStats.xSizeOfLargestFreeBlockInBytes == xLargest ) ? 0 : 1;
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    BenchTrace_t xTraces[ 16 ];
+    size_t xNumTraces = 0, xOps = benchDEFAULT_OPS, xHeap, xTrace;
+    int iArg;
+    HeapRegion_t xRegions5[] = { { ucHeap5Region, sizeof( ucHeap5Region ), 0 }, { NULL, 0, 0 } };
+    HeapRegion_t xRegions6[] = { { ucHeap6Region, sizeof( ucHeap6Region ), 0 }, { NULL, 0, 0 } };
+
+    for( iArg = 1; iArg < argc; iArg++ )
+    {
+        if( ( strcmp( argv[ iArg ], "-n" ) == 0 ) && ( iArg + 1 < argc ) )
+        {
+            xOps = strtoul( argv[ ++iArg ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ iArg ], "-s" ) == 0 ) && ( iArg + 1 < argc ) )
+        {
+            ulSeed = ( uint32_t ) strtoul( argv[ ++iArg ], NULL, 0 );
+
+            if( ulSeed == 0U )
+            {
+                ulSeed = 1U;
+            }
+        }
+        else if( xNumTraces < ( sizeof( xTraces ) / sizeof( xTraces[ 0 ] ) ) )
+        {
+            xTraces[ xNumTraces++ ] = prvLoadTrace( argv[ iArg ] );
+        }
+    }
+
+    if( xNumTraces == 0 )
+    {
+        xTraces[ xNumTraces++ ] = prvMakeRandomTrace( xOps );
+        xTraces[ xNumTraces++ ] = prvMakeFragmentTrace( xOps );
+        xTraces[ xNumTraces++ ] = prvMakeFifoTrace( xOps );
+    }
+
+    if( prvCheckLargeRegion() != 0 )
+    {
+        return 1;
+    }
+
+    heap5_vPortDefineHeapRegions( xRegions5 );
+    heap6_vPortDefineHeapRegions( xRegions6 );
+
+    printf( "Times in ns.  %u byte heaps.\n", ( unsigned ) configTOTAL_HEAP_SIZE );
+    printf( "%-10s %-7s %6s %10s %10s %10s %6s %10s %10s %10s %8s %8s %8s\n",
+            "trace", "heap",
+            "malloc", "p99", "p99.9", "max",
+            "free", "p99", "p99.9", "max",
+            "failed", "fblocks", "largest" );
+
+    for( xTrace = 0; xTrace < xNumTraces; xTrace++ )
+    {
+        for( xHeap = 0; xHeap < benchNUM_HEAPS; xHeap++ )
+        {
+            prvReplay( &( xHeaps[ xHeap ] ), &( xTraces[ xTrace ] ) );
+        }
+    }
+
+    return 0;
+}
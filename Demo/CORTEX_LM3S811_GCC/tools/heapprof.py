@@ -0,0 +1,325 @@
+#!/usr/bin/env python3
+"""
+Allocation profiler for the FreeRTOS heap trace.
+
+Reads the HEAPTHZ/HEAPT lines the demo prints over the UART when
+configUSE_HEAP_TRACE is 1, symbolizes the call sites against the demo image
+and reports:
+
+    call sites      allocations, failures, bytes and lifetimes per call site
+    fragmentation   free heap and the largest free block over time
+    lifetimes       how long blocks live between pvPortMalloc() and vPortFree()
+
+Sizes are block sizes, including the heap's block header, as both
+pvPortMalloc() and vPortFree() record the size of the block itself.  A free
+whose size differs from its allocation's is counted and reported, as it means
+the trace and the heap disagree.
+
+A call site is the return address recorded by pvPortMalloc(), so objects
+created through the kernel (tasks, queues, semaphores) show the kernel
+function that allocated them rather than the application code above it.
+
+The largest free block is estimated by laying out the blocks that are live at
+each point in the trace within the heap array (ucHeap, found with nm, or given
+with --heap-start and --heap-size).  It is only exact when no records were
+dropped and the trace starts at the first allocation, and needs --header to
+match the size of the heap's block header.
+
+Usage:
+    heapprof.py --axf gcc/RTOSDemo.axf uart.log
+    heapprof.py --header 16 --buckets 20 uart.log
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+LIFETIME_BUCKETS = 16
+
+
+class Record:
+    def __init__( self, op, address, caller, time, size, free ):
+        self.op = op
+        self.address = address
+        self.caller = caller
+        self.time = time
+        self.size = size
+        self.free = free
+
+
+class Site:
+    def __init__( self, name ):
+        self.name = name
+        self.allocs = 0
+        self.failed = 0
+        self.freed = 0
+        self.bytes = 0
+        self.live = 0
+        self.live_bytes = 0
+        self.lifetimes = []
+
+
+def load_log( path ):
+    """Return the counter frequency, the records dropped and the records."""
+    counter_hz = None
+    dropped = 0
+    records = []
+    wrap = 0
+    last = None
+
+    with open( path, errors = "replace" ) as f:
+        for line in f:
+            # vSendStringToUART() sends a NUL after every string.
+            fields = line.replace( "\0", "" ).strip().split( "," )
+
+            if fields[ 0 ] == "HEAPTHZ" and len( fields ) >= 3:
+                counter_hz = float( fields[ 1 ] )
+                dropped = max( dropped, int( fields[ 2 ] ) )
+            elif fields[ 0 ] == "HEAPT" and len( fields ) >= 7:
+                time = int( fields[ 4 ] )
+
+                # Time stamps are 32 bits wide and records arrive in order.
+                if last is not None and time < last:
+                    wrap += 1 << 32
+
+                last = time
+                records.append( Record( fields[ 1 ], int( fields[ 2 ], 16 ), int( fields[ 3 ], 16 ),
+                                        time + wrap, int( fields[ 5 ] ), int( fields[ 6 ] ) ) )
+
+    if counter_hz is None:
+        raise ValueError( "%s: no HEAPTHZ line found - is configUSE_HEAP_TRACE set to 1?" % path )
+
+    return counter_hz, dropped, records
+
+
+def symbolize( addresses, axf, addr2line ):
+    """Map each return address to 'function file:line'."""
+    names = { a: "0x%08x" % a for a in addresses }
+
+    if not axf or not addresses:
+        return names
+
+    # A return address points after the call, and has bit 0 set on Thumb, so
+    # look up the byte before it to get the line of the call itself.
+    ordered = sorted( addresses )
+    pcs = [ "0x%x" % ( ( a & ~1 ) - 1 ) for a in ordered if a > 1 ]
+
+    try:
+        out = subprocess.run( [ addr2line, "-f", "-e", axf ] + pcs, capture_output = True, text = True, check = True ).stdout
+    except ( OSError, subprocess.CalledProcessError ) as e:
+        print( "heapprof: cannot run %s: %s" % ( addr2line, e ), file = sys.stderr )
+        return names
+
+    lines = out.splitlines()
+
+    for i, a in enumerate( a for a in ordered if a > 1 ):
+        if 2 * i + 1 >= len( lines ):
+            break
+
+        function, location = lines[ 2 * i ], lines[ 2 * i + 1 ]
+
+        if function != "??":
+            names[ a ] = "%s %s" % ( function, os.path.basename( location ) )
+
+    return names
+
+
+def heap_bounds( axf, nm ):
+    """Return ( start, size ) of ucHeap in the image, or None."""
+    if not axf:
+        return None
+
+    try:
+        out = subprocess.run( [ nm, "-S", axf ], capture_output = True, text = True, check = True ).stdout
+    except ( OSError, subprocess.CalledProcessError ) as e:
+        print( "heapprof: cannot run %s: %s" % ( nm, e ), file = sys.stderr )
+        return None
+
+    for line in out.splitlines():
+        fields = line.split()
+
+        if len( fields ) == 4 and fields[ 3 ] == "ucHeap":
+            return int( fields[ 0 ], 16 ), int( fields[ 1 ], 16 )
+
+    return None
+
+
+def largest_gap( live, header, start, size ):
+    """Largest free span in [start, start + size) not covered by a live block."""
+    largest = 0
+    cursor = start
+
+    for address in sorted( live ):
+        block = address - header
+
+        if block > cursor:
+            largest = max( largest, block - cursor )
+
+        cursor = max( cursor, block + live[ address ] )
+
+    return max( largest, start + size - cursor )
+
+
+def to_ms( ticks, counter_hz ):
+    return ticks * 1000.0 / counter_hz
+
+
+def median( values ):
+    values = sorted( values )
+    return values[ len( values ) // 2 ] if values else 0
+
+
+def report( path, counter_hz, dropped, records, args ):
+    callers = { r.caller for r in records }
+    names = symbolize( callers, args.axf, args.addr2line )
+
+    if args.heap_start is not None and args.heap_size is not None:
+        bounds = ( args.heap_start, args.heap_size )
+    else:
+        bounds = heap_bounds( args.axf, args.nm )
+
+    sites = {}
+    live = {}           # address -> block size
+    owner = {}          # address -> ( site, time allocated )
+    unmatched = 0
+    mismatched = 0
+    samples = []
+    start = records[ 0 ].time
+    span = max( records[ -1 ].time - start, 1 )
+    next_sample = 0
+
+    for r in records:
+        if r.op == "m":
+            site = sites.setdefault( r.caller, Site( names[ r.caller ] ) )
+            site.allocs += 1
+
+            if r.address == 0:
+                site.failed += 1
+            else:
+                site.bytes += r.size
+                site.live += 1
+                site.live_bytes += r.size
+                live[ r.address ] = r.size
+                owner[ r.address ] = ( site, r.time )
+        elif r.address in owner:
+            site, allocated = owner.pop( r.address )
+            site.freed += 1
+            site.live -= 1
+            size = live.pop( r.address )
+            site.live_bytes -= size
+            site.lifetimes.append( r.time - allocated )
+
+            if size != r.size:
+                mismatched += 1
+        else:
+            # Freeing a block allocated before the trace started, or whose
+            # allocation record was dropped.
+            unmatched += 1
+
+        # Sample the heap at the end of each of the report's time buckets.
+        while next_sample < args.buckets and r.time - start >= span * ( next_sample + 1 ) / args.buckets:
+            largest = largest_gap( live, args.header, bounds[ 0 ], bounds[ 1 ] ) if bounds else None
+            samples.append( ( r.time - start, r.free, len( live ), largest ) )
+            next_sample += 1
+
+    print( "%s: %d records over %.1f ms, %d dropped, %d frees of untraced blocks" %
+           ( path, len( records ), to_ms( span, counter_hz ), dropped, unmatched ) )
+
+    if dropped or unmatched:
+        print( "  the trace is incomplete, so live block counts and the largest free block are estimates" )
+
+    if mismatched:
+        print( "  %d frees recorded a different block size from their allocation" % mismatched )
+
+    print()
+    print( "  Call sites by allocations" )
+    print( "  %7s %6s %6s %8s %6s %5s %8s %10s %10s  %s" %
+           ( "ALLOCS", "FAILED", "FREED", "BYTES", "AVG", "LIVE", "LIVE B", "MED LIFE", "MAX LIFE", "SITE" ) )
+
+    for site in sorted( sites.values(), key = lambda s: ( -s.allocs, s.name ) ):
+        ok = site.allocs - site.failed
+        average = site.bytes // ok if ok else 0
+        life = "%.1f ms" % to_ms( median( site.lifetimes ), counter_hz ) if site.lifetimes else "-"
+        longest = "%.1f ms" % to_ms( max( site.lifetimes ), counter_hz ) if site.lifetimes else "-"
+        print( "  %7d %6d %6d %8d %6d %5d %8d %10s %10s  %s" %
+               ( site.allocs, site.failed, site.freed, site.bytes, average, site.live, site.live_bytes, life, longest, site.name ) )
+
+    print()
+    print( "  Fragmentation over time%s" % ( "" if bounds else " (heap array unknown - largest free block not estimated)" ) )
+    print( "  %10s %8s %6s %8s %6s" % ( "TIME ms", "FREE", "LIVE", "LARGEST", "FRAG%" ) )
+
+    for time, free, blocks, largest in samples:
+        if largest is None:
+            print( "  %10.1f %8d %6d %8s %6s" % ( to_ms( time, counter_hz ), free, blocks, "-", "-" ) )
+        else:
+            largest = min( largest, free )
+            fragmentation = 100.0 * ( 1.0 - largest / free ) if free else 0.0
+            print( "  %10.1f %8d %6d %8d %6.1f" % ( to_ms( time, counter_hz ), free, blocks, largest, fragmentation ) )
+
+    lifetimes = [ l for s in sites.values() for l in s.lifetimes ]
+    histogram = [ 0 ] * LIFETIME_BUCKETS
+
+    for l in lifetimes:
+        bucket = min( int( to_ms( l, counter_hz ) ).bit_length(), LIFETIME_BUCKETS - 1 )
+        histogram[ bucket ] += 1
+
+    print()
+    print( "  Block lifetimes (%d freed, %d still live)" % ( len( lifetimes ), len( live ) ) )
+
+    if lifetimes:
+        widest = max( histogram )
+
+        for bucket, count in enumerate( histogram ):
+            if count == 0:
+                continue
+
+            low = 1 << ( bucket - 1 ) if bucket > 0 else 0
+
+            if bucket == 0:
+                label = "< 1 ms"
+            elif bucket == LIFETIME_BUCKETS - 1:
+                label = ">= %d ms" % low
+            elif low == 1:
+                label = "1 ms"
+            else:
+                label = "%d-%d ms" % ( low, 2 * low - 1 )
+
+            print( "  %14s %7d  %s" % ( label, count, "#" * max( 1, count * 40 // widest ) ) )
+
+    print()
+
+
+def number( text ):
+    return int( text, 0 )
+
+
+def main():
+    parser = argparse.ArgumentParser( description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter )
+    parser.add_argument( "logs", nargs = "+", help = "UART captures containing HEAPT lines" )
+    parser.add_argument( "--axf", help = "the image the trace was taken from, used to name the call sites" )
+    parser.add_argument( "--addr2line", default = "arm-none-eabi-addr2line" )
+    parser.add_argument( "--nm", default = "arm-none-eabi-nm" )
+    parser.add_argument( "--header", type = int, default = 8, help = "size of the heap's block header in bytes" )
+    parser.add_argument( "--heap-start", type = number, help = "start of the heap array, instead of ucHeap" )
+    parser.add_argument( "--heap-size", type = number, help = "size of the heap array, instead of ucHeap" )
+    parser.add_argument( "--buckets", type = int, default = 10, help = "number of fragmentation samples" )
+    args = parser.parse_args()
+
+    if args.buckets < 1:
+        parser.error( "--buckets must be at least 1" )
+
+    for path in args.logs:
+        counter_hz, dropped, records = load_log( path )
+
+        if not records:
+            print( "%s: no heap trace records" % path )
+            continue
+
+        report( path, counter_hz, dropped, records, args )
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit( main() )
@@ -0,0 +1,60 @@
+/*
+ * Configuration used only to build the FreeRTOS kernel into the host tests.
+ * Each test includes the source file it tests, so can call its static
+ * functions and read its static variables.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION                1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 0
+#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 20000000 )
+#define configTICK_RATE_HZ                  ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 64 )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 64 * 1024 ) )
+#define configMAX_TASK_NAME_LEN             ( 10 )
+#define configUSE_16_BIT_TICKS              0
+#define configMAX_PRIORITIES                ( 5 )
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configUSE_MALLOC_FAILED_HOOK        0
+
+/* Start a little before the tick count overflows, so every test crosses an
+ * overflow. */
+#define configINITIAL_TICK_COUNT            ( ( TickType_t ) ( 0UL - 1000UL ) )
+
+/* The list end marker is a full list item, as at -O2 the host compiler's
+ * aliasing rules otherwise break the walks of the timer lists. */
+#define configUSE_MINI_LIST_ITEM            0
+
+/* The timer service task is below the highest priority, so a test task
+ * created at the highest priority stays the running task when the scheduler is
+ * started. */
+#define configUSE_TIMERS                    1
+#define configTIMER_TASK_PRIORITY           ( configMAX_PRIORITIES - 2 )
+#define configTIMER_QUEUE_LENGTH            10
+#define configTIMER_TASK_STACK_DEPTH        configMINIMAL_STACK_SIZE
+#define configUSE_HARD_TIMERS               1
+#define configUSE_TIMER_BATCH_COMMANDS      1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES    2
+
+/* The high resolution time base and compare are simulated by
+ * test_hr_timers.c. */
+extern uint32_t ulHostHRTimerGetTime( void );
+extern void vHostHRTimerSetCompare( uint32_t ulDelay );
+extern void vHostHRTimerStopCompare( void );
+#define configUSE_HR_TIMERS                 1
+#define configHR_TIMER_FREQUENCY_HZ         ( 1000000UL )
+#define portHR_TIMER_GET_TIME()             ulHostHRTimerGetTime()
+#define portHR_TIMER_SET_COMPARE( ulDelay )    vHostHRTimerSetCompare( ulDelay )
+#define portHR_TIMER_STOP_COMPARE()         vHostHRTimerStopCompare()
+
+#define configUSE_MEMORY_POOLS              1
+#define INCLUDE_eTaskGetState               1
+
+#define configASSERT( x )                   assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
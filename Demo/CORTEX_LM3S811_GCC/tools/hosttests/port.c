@@ -0,0 +1,44 @@
+/*
+ * The port layer for the host tests.  The tasks never run, so only the stack is
+ * set up, and starting the scheduler returns at once with the scheduler marked
+ * as running and the highest priority task as the running task.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    ( void ) pxCode;
+    ( void ) pvParameters;
+
+    return pxTopOfStack - 16;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+}
+
+/* Set by a test to run whatever runs when a task yields, such as the task a
+ * blocked task waits for, as the task cannot be switched out.  The hook
+ * switches tasks itself, so a yield from within the hook does nothing. */
+void ( * pxHostYieldHook )( void ) = NULL;
+
+void vPortYield( void )
+{
+    static BaseType_t xInHook = pdFALSE;
+
+    if( ( pxHostYieldHook != NULL ) && ( xInHook == pdFALSE ) )
+    {
+        xInHook = pdTRUE;
+        pxHostYieldHook();
+        xInHook = pdFALSE;
+    }
+}
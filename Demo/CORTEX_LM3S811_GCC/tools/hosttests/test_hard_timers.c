@@ -0,0 +1,153 @@
+/*
+ * test_hard_timers - checks that hard timers expire from the tick interrupt.
+ *
+ * timers.c is built in so the timer queue can be checked.  The scheduler is
+ * never started.  Instead the test calls xTaskIncrementTick() as the tick
+ * interrupt does, and checks that:
+ *
+ * + An auto-reload hard timer's callback is called from inside
+ *   xTaskIncrementTick() on every tick that is a multiple of its period after
+ *   it was started, and on no other tick, across a tick count overflow.
+ * + A one-shot hard timer's callback is called once, on the tick it expires,
+ *   after which the timer is no longer active.
+ * + The callbacks are still called on time while the scheduler is suspended,
+ *   and not again when xTaskResumeAll() catches up with the pended ticks.
+ * + A hard timer stopped from its own callback is not called again.
+ * + No command for a hard timer is sent to the timer service task.
+ *
+ * Usage:
+ *     test_hard_timers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Built in so the timer queue can be read directly. */
+#include "timers.c"
+
+#define testTICKS               5000UL
+#define testPERIODIC_PERIOD     7UL
+#define testONE_SHOT_PERIOD     50UL
+#define testSTOPPED_PERIOD      11UL
+#define testSTOPPED_EXPIRIES    3UL
+#define testSUSPEND_START       100UL
+#define testSUSPEND_END         130UL
+
+/* The ticks the test has stepped, so the tick the interrupt is processing
+ * whether or not the scheduler is suspended. */
+static unsigned long ulTicks = 0;
+
+/* Set while xTaskIncrementTick() is called as the tick interrupt. */
+static BaseType_t xInTickInterrupt = pdFALSE;
+
+static unsigned long ulPeriodicCalls = 0, ulOneShotCalls = 0, ulStoppedCalls = 0;
+static BaseType_t xErrorDetected = pdFALSE;
+
+static void prvIdleTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+static void prvCheck( BaseType_t xCondition,
+                      const char * pcMessage )
+{
+    if( xCondition == pdFALSE )
+    {
+        fprintf( stderr, "test_hard_timers: %s at tick %lu\n", pcMessage, ulTicks );
+        xErrorDetected = pdTRUE;
+    }
+}
+
+static void prvPeriodicCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+
+    prvCheck( xInTickInterrupt, "periodic callback not called from the tick" );
+    prvCheck( ( ulTicks % testPERIODIC_PERIOD ) == 0UL, "periodic callback out of phase" );
+    ulPeriodicCalls++;
+}
+
+static void prvOneShotCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+
+    prvCheck( xInTickInterrupt, "one-shot callback not called from the tick" );
+    prvCheck( ulTicks == testONE_SHOT_PERIOD, "one-shot callback on the wrong tick" );
+    ulOneShotCalls++;
+}
+
+static void prvStoppedCallback( TimerHandle_t xTimer )
+{
+    ulStoppedCalls++;
+
+    if( ulStoppedCalls == testSTOPPED_EXPIRIES )
+    {
+        ( void ) xTimerStopFromISR( xTimer, NULL );
+    }
+}
+
+static void prvTick( void )
+{
+    ulTicks++;
+    xInTickInterrupt = pdTRUE;
+    ( void ) xTaskIncrementTick();
+    xInTickInterrupt = pdFALSE;
+}
+
+int main( void )
+{
+    TimerHandle_t xPeriodic, xOneShot, xStopped;
+
+    /* A task for the tick to run in, as the scheduler is not started. */
+    xTaskCreate( prvIdleTask, "Test", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
+
+    xPeriodic = xTimerCreate( "Periodic", testPERIODIC_PERIOD, pdTRUE, NULL, prvPeriodicCallback );
+    xOneShot = xTimerCreate( "OneShot", testONE_SHOT_PERIOD, pdFALSE, NULL, prvOneShotCallback );
+    xStopped = xTimerCreate( "Stopped", testSTOPPED_PERIOD, pdTRUE, NULL, prvStoppedCallback );
+
+    if( ( xPeriodic == NULL ) || ( xOneShot == NULL ) || ( xStopped == NULL ) )
+    {
+        return 1;
+    }
+
+    vTimerSetHard( xPeriodic );
+    vTimerSetHard( xOneShot );
+    vTimerSetHard( xStopped );
+
+    prvCheck( ( xTimerStart( xPeriodic, 0 ) == pdPASS ) &&
+              ( xTimerStart( xOneShot, 0 ) == pdPASS ) &&
+              ( xTimerStart( xStopped, 0 ) == pdPASS ), "start failed" );
+
+    while( ulTicks < testTICKS )
+    {
+        if( ulTicks == testSUSPEND_START )
+        {
+            vTaskSuspendAll();
+        }
+
+        prvTick();
+
+        if( ulTicks == testSUSPEND_END )
+        {
+            ( void ) xTaskResumeAll();
+        }
+    }
+
+    prvCheck( ( TickType_t ) ( xTaskGetTickCount() - configINITIAL_TICK_COUNT ) == ( TickType_t ) testTICKS, "tick count wrong" );
+    prvCheck( xTaskGetTickCount() < ( TickType_t ) configINITIAL_TICK_COUNT, "tick count did not overflow" );
+    prvCheck( ulPeriodicCalls == ( testTICKS / testPERIODIC_PERIOD ), "periodic callback count wrong" );
+    prvCheck( ulOneShotCalls == 1UL, "one-shot callback count wrong" );
+    prvCheck( xTimerIsTimerActive( xOneShot ) == pdFALSE, "one-shot timer still active" );
+    prvCheck( ulStoppedCalls == testSTOPPED_EXPIRIES, "stopped timer called again" );
+    prvCheck( xTimerIsTimerActive( xStopped ) == pdFALSE, "stopped timer still active" );
+    prvCheck( uxQueueMessagesWaiting( xTimerQueue ) == ( UBaseType_t ) 0, "command sent to the timer service task" );
+
+    if( xErrorDetected != pdFALSE )
+    {
+        return 1;
+    }
+
+    printf( "test_hard_timers: %lu ticks, %lu periodic and %lu one-shot callbacks - passed\n", ulTicks, ulPeriodicCalls, ulOneShotCalls );
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * test_hr_timers - checks that high resolution timers expire on time and that
+ * periodic timers stay in phase.
+ *
+ * hrtimers.c is built in so each timer's next expiry time can be read.  The
+ * 32-bit time base and the compare interrupt are simulated: the time jumps to
+ * each armed compare, plus a random interrupt latency, and the test then calls
+ * xHRTimerInterruptHandler() as the port's interrupt handler does.  The time
+ * base starts 1M counts before it wraps and runs for 20M counts.  The test
+ * checks that:
+ *
+ * + Every callback is called at or after its timer's expiry time, and no more
+ *   than the interrupt latency after it.
+ * + A periodic timer is reloaded to exactly a whole number of periods after
+ *   its first expiry, however late the interrupt, so it does not drift.
+ * + When the interrupt is held off for several periods the missed expiries
+ *   are skipped, with the callback called once, rather than called in a row.
+ * + A one-shot timer is called once, after which it is no longer active.
+ * + A periodic timer stopped from its own callback is not called again.
+ *
+ * Usage:
+ *     test_hr_timers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Built in so each timer's expiry time can be read directly. */
+#include "hrtimers.c"
+
+#define testRUN_TIME            20000000UL
+#define testSTART_TIME          ( ( uint32_t ) 0xfff00000UL )
+#define testMAX_LATENCY         64UL
+#define testHOLD_OFF            3500UL
+#define testHOLD_OFF_AFTER      1000UL
+#define testSTOP_AFTER          5UL
+#define testTIMERS              4
+
+typedef struct TEST_TIMER
+{
+    HRTimerHandle_t xTimer;
+    uint32_t ulDelay;
+    uint32_t ulPeriod;
+    uint32_t ulExpected;     /* The time the timer should next expire at. */
+    unsigned long ulCalls;
+    unsigned long ulSkipped; /* Expiries skipped because the interrupt was late. */
+} TestTimer_t;
+
+/* Two periodic timers, a one-shot timer and a periodic timer that stops
+ * itself. */
+static TestTimer_t xTimers[ testTIMERS ] =
+{
+    { NULL, 500,    1000, 0, 0, 0 },
+    { NULL, 1,      777,  0, 0, 0 },
+    { NULL, 123456, 0,    0, 0, 0 },
+    { NULL, 2000,   3000, 0, 0, 0 }
+};
+
+/* The simulated time base and compare. */
+static uint32_t ulTimeNow = testSTART_TIME;
+static uint32_t ulCompareTime = 0;
+static BaseType_t xCompareArmed = pdFALSE;
+
+/* Extra latency for the next interrupt, to hold it off for several periods. */
+static uint32_t ulExtraLatency = 0;
+
+static uint32_t ulRandomState = 0x2545f491UL;
+static BaseType_t xErrorDetected = pdFALSE;
+
+uint32_t ulHostHRTimerGetTime( void )
+{
+    return ulTimeNow;
+}
+
+void vHostHRTimerSetCompare( uint32_t ulDelay )
+{
+    ulCompareTime = ulTimeNow + ulDelay;
+    xCompareArmed = pdTRUE;
+}
+
+void vHostHRTimerStopCompare( void )
+{
+    xCompareArmed = pdFALSE;
+}
+
+/* xorshift32, so the latencies are the same whatever the C library. */
+static uint32_t prvRandom( void )
+{
+    ulRandomState ^= ulRandomState << 13;
+    ulRandomState ^= ulRandomState >> 17;
+    ulRandomState ^= ulRandomState << 5;
+
+    return ulRandomState;
+}
+
+static void prvCheck( BaseType_t xCondition,
+                      const char * pcMessage,
+                      int iTimer )
+{
+    if( xCondition == pdFALSE )
+    {
+        fprintf( stderr, "test_hr_timers: timer %d %s at time %08lx\n", iTimer, pcMessage, ( unsigned long ) ulTimeNow );
+        xErrorDetected = pdTRUE;
+    }
+}
+
+static void prvCallback( HRTimerHandle_t xTimer,
+                         BaseType_t * pxHigherPriorityTaskWoken )
+{
+    const int iTimer = ( int ) ( intptr_t ) pvHRTimerGetTimerID( xTimer );
+    TestTimer_t * const pxTimer = &( xTimers[ iTimer ] );
+    const uint32_t ulLate = ulTimeNow - pxTimer->ulExpected;
+
+    ( void ) pxHigherPriorityTaskWoken;
+
+    prvCheck( ( ulLate <= ( testMAX_LATENCY + testHOLD_OFF ) ), "called early or too late", iTimer );
+    pxTimer->ulCalls++;
+
+    if( pxTimer->ulPeriod != 0U )
+    {
+        /* The next expiry is the first whole period after now. */
+        pxTimer->ulExpected += pxTimer->ulPeriod;
+
+        while( ( ulTimeNow - pxTimer->ulExpected ) < hrtimerMAX_DELAY )
+        {
+            pxTimer->ulExpected += pxTimer->ulPeriod;
+            pxTimer->ulSkipped++;
+        }
+
+        prvCheck( ( ( HRTimer_t * ) xTimer )->ulExpiryTime == pxTimer->ulExpected, "reloaded out of phase", iTimer );
+    }
+
+    if( ( iTimer == 0 ) && ( pxTimer->ulCalls == testHOLD_OFF_AFTER ) )
+    {
+        ulExtraLatency = testHOLD_OFF;
+    }
+
+    if( ( iTimer == 3 ) && ( pxTimer->ulCalls == testSTOP_AFTER ) )
+    {
+        vHRTimerStopFromISR( xTimer );
+    }
+}
+
+int main( void )
+{
+    int i;
+
+    for( i = 0; i < testTIMERS; i++ )
+    {
+        xTimers[ i ].xTimer = xHRTimerCreate( prvCallback, ( void * ) ( intptr_t ) i );
+
+        if( xTimers[ i ].xTimer == NULL )
+        {
+            return 1;
+        }
+
+        xTimers[ i ].ulExpected = ulTimeNow + xTimers[ i ].ulDelay;
+        prvCheck( xHRTimerStart( xTimers[ i ].xTimer, xTimers[ i ].ulDelay, xTimers[ i ].ulPeriod ) == pdPASS, "not started", i );
+    }
+
+    prvCheck( xHRTimerStart( xTimers[ 0 ].xTimer, hrtimerMAX_DELAY + 1UL, 0 ) == pdFAIL, "started with too long a delay", 0 );
+
+    while( ( uint32_t ) ( ulTimeNow - testSTART_TIME ) < testRUN_TIME )
+    {
+        if( xCompareArmed == pdFALSE )
+        {
+            prvCheck( pdFALSE, "compare not armed", -1 );
+            break;
+        }
+
+        ulTimeNow = ulCompareTime + ( prvRandom() % testMAX_LATENCY ) + ulExtraLatency;
+        ulExtraLatency = 0;
+        ( void ) xHRTimerInterruptHandler();
+    }
+
+    prvCheck( ulTimeNow < testSTART_TIME, "time base did not wrap", -1 );
+    prvCheck( xTimers[ 0 ].ulSkipped >= ( testHOLD_OFF / xTimers[ 0 ].ulPeriod ), "no expiries skipped", 0 );
+    prvCheck( xTimers[ 2 ].ulCalls == 1UL, "one-shot count wrong", 2 );
+    prvCheck( xHRTimerIsTimerActive( xTimers[ 2 ].xTimer ) == pdFALSE, "one-shot still active", 2 );
+    prvCheck( xTimers[ 3 ].ulCalls == testSTOP_AFTER, "called after it was stopped", 3 );
+    prvCheck( xHRTimerIsTimerActive( xTimers[ 3 ].xTimer ) == pdFALSE, "still active after it was stopped", 3 );
+
+    for( i = 0; i < 2; i++ )
+    {
+        /* Every period up to the last expiry was either called or skipped. */
+        prvCheck( ( xTimers[ i ].ulCalls + xTimers[ i ].ulSkipped ) ==
+                  ( ( uint32_t ) ( xTimers[ i ].ulExpected - testSTART_TIME - xTimers[ i ].ulDelay ) / xTimers[ i ].ulPeriod ), "count wrong", i );
+    }
+
+    if( xErrorDetected != pdFALSE )
+    {
+        return 1;
+    }
+
+    printf( "test_hr_timers: %lu and %lu periodic callbacks, %lu expiries skipped - passed\n",
+            xTimers[ 0 ].ulCalls, xTimers[ 1 ].ulCalls, xTimers[ 0 ].ulSkipped + xTimers[ 1 ].ulSkipped );
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * test_mempool - checks that a task blocks on an empty memory pool until a
+ * block is freed or its timeout expires.
+ *
+ * mempool.c is built in so the tasks waiting on the pool can be read.  The
+ * scheduler is started, which returns at once with the test's allocating task
+ * as the running task.  When the allocating task blocks on the empty pool,
+ * its yield calls the test's hook, which switches to the next task, frees a
+ * block or steps the tick count, and switches back.  The test checks that:
+ *
+ * + xPoolCreate() returns NULL, without allocating, for sizes that overflow.
+ * + An allocation from an empty pool that does not wait returns NULL.
+ * + A task blocked on the pool is unblocked by vPoolFree() or
+ *   vPoolFreeFromISR(), and is given the freed block.
+ * + If the freed block is taken by an interrupt before the unblocked task
+ *   runs, the task blocks again rather than returning NULL.
+ * + A task blocked on the pool is unblocked on the tick its timeout expires,
+ *   and not before, and then returns NULL.
+ * + The pool's statistics count every allocation, free, failure and block.
+ *
+ * Usage:
+ *     test_mempool
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Built in so the tasks waiting on the pool can be read directly. */
+#include "mempool.c"
+
+#define testBLOCK_SIZE          24
+#define testBLOCK_COUNT         4
+#define testTIMEOUT             10
+
+static PoolHandle_t xPool;
+static TaskHandle_t xAllocatingTask;
+
+/* What the hook does when the allocating task blocks: the block to free, from
+ * an interrupt or not, the number of times to take the freed block back, or
+ * the number of ticks to step if nothing is freed. */
+static void * pvBlockToFree = NULL;
+static BaseType_t xFreeFromISR = pdFALSE;
+static unsigned long ulSteals = 0;
+static TickType_t xTicksToTimeOut = 0;
+
+/* The number of times the allocating task has blocked. */
+static unsigned long ulBlocks = 0;
+
+static BaseType_t xErrorDetected = pdFALSE;
+
+static void prvAllocatingTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+static void prvCheck( BaseType_t xCondition,
+                      const char * pcMessage )
+{
+    if( xCondition == pdFALSE )
+    {
+        fprintf( stderr, "test_mempool: %s\n", pcMessage );
+        xErrorDetected = pdTRUE;
+    }
+}
+
+/* Runs when the allocating task yields. */
+static void prvYieldHook( void )
+{
+    Pool_t * const pxPool = xPool;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    TickType_t xTick;
+
+    /* Only act once the allocating task is waiting on the pool. */
+    if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+    {
+        ulBlocks++;
+        prvCheck( listGET_OWNER_OF_HEAD_ENTRY( &( pxPool->xTasksWaitingToAllocate ) ) == xAllocatingTask, "allocating task not waiting on the pool" );
+
+        vTaskSwitchContext();
+        prvCheck( xTaskGetCurrentTaskHandle() != xAllocatingTask, "blocked task still running" );
+
+        if( xTicksToTimeOut != ( TickType_t ) 0 )
+        {
+            /* Nothing is freed, so the allocation times out. */
+            for( xTick = 1; xTick < xTicksToTimeOut; xTick++ )
+            {
+                ( void ) xTaskIncrementTick();
+                prvCheck( eTaskGetState( xAllocatingTask ) == eBlocked, "unblocked before its timeout" );
+            }
+
+            ( void ) xTaskIncrementTick();
+            prvCheck( eTaskGetState( xAllocatingTask ) == eReady, "not unblocked when its timeout expired" );
+        }
+        else
+        {
+            if( xFreeFromISR != pdFALSE )
+            {
+                vPoolFreeFromISR( xPool, pvBlockToFree, &xHigherPriorityTaskWoken );
+                prvCheck( xHigherPriorityTaskWoken != pdFALSE, "higher priority task woken not set" );
+            }
+            else
+            {
+                vPoolFree( xPool, pvBlockToFree );
+            }
+
+            prvCheck( eTaskGetState( xAllocatingTask ) == eReady, "not unblocked when a block was freed" );
+
+            if( ulSteals > 0UL )
+            {
+                /* An interrupt takes the block before the task runs. */
+                ulSteals--;
+                pvBlockToFree = pvPoolAllocFromISR( xPool );
+                prvCheck( pvBlockToFree != NULL, "freed block not available" );
+            }
+        }
+
+        vTaskSwitchContext();
+        prvCheck( xTaskGetCurrentTaskHandle() == xAllocatingTask, "allocating task not switched back in" );
+    }
+}
+
+int main( void )
+{
+    void * pvBlocks[ testBLOCK_COUNT ];
+    void * pvBlock;
+    PoolStats_t xStats;
+    size_t xFreeHeap;
+    int i;
+
+    /* Sizes that overflow when rounded up, multiplied or added to the pool
+     * structure must fail rather than allocate a small pool. */
+    xFreeHeap = xPortGetFreeHeapSize();
+    prvCheck( xPoolCreate( SIZE_MAX, 1 ) == NULL, "block size overflow not caught" );
+    prvCheck( xPoolCreate( 16, ( UBaseType_t ) ( SIZE_MAX / 16 ) + 2 ) == NULL, "storage size overflow not caught" );
+    prvCheck( xPoolCreate( SIZE_MAX - 15, 1 ) == NULL, "pool size overflow not caught" );
+    prvCheck( xPortGetFreeHeapSize() == xFreeHeap, "overflowing pool allocated" );
+
+    xPool = xPoolCreate( testBLOCK_SIZE, testBLOCK_COUNT );
+    xTaskCreate( prvAllocatingTask, "Alloc", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &xAllocatingTask );
+
+    if( ( xPool == NULL ) || ( xAllocatingTask == NULL ) )
+    {
+        return 1;
+    }
+
+    vTaskStartScheduler();
+    prvCheck( xTaskGetCurrentTaskHandle() == xAllocatingTask, "allocating task not running" );
+    pxHostYieldHook = prvYieldHook;
+
+    /* Empty the pool. */
+    for( i = 0; i < testBLOCK_COUNT; i++ )
+    {
+        pvBlocks[ i ] = pvPoolAlloc( xPool, 0 );
+        prvCheck( pvBlocks[ i ] != NULL, "allocation from the pool failed" );
+    }
+
+    prvCheck( pvPoolAlloc( xPool, 0 ) == NULL, "allocation from an empty pool succeeded" );
+    prvCheck( ulBlocks == 0UL, "allocation that does not wait blocked" );
+
+    /* Block until a task frees a block. */
+    pvBlockToFree = pvBlocks[ 0 ];
+    pvBlock = pvPoolAlloc( xPool, testTIMEOUT );
+    prvCheck( ( ulBlocks == 1UL ) && ( pvBlock == pvBlocks[ 0 ] ), "not given the block freed by a task" );
+
+    /* Block until an interrupt frees a block. */
+    ulBlocks = 0;
+    xFreeFromISR = pdTRUE;
+    pvBlockToFree = pvBlocks[ 1 ];
+    pvBlock = pvPoolAlloc( xPool, testTIMEOUT );
+    prvCheck( ( ulBlocks == 1UL ) && ( pvBlock == pvBlocks[ 1 ] ), "not given the block freed by an interrupt" );
+
+    /* Block, and block again when the freed block is taken first. */
+    ulBlocks = 0;
+    xFreeFromISR = pdFALSE;
+    ulSteals = 1;
+    pvBlockToFree = pvBlocks[ 2 ];
+    pvBlock = pvPoolAlloc( xPool, testTIMEOUT );
+    prvCheck( ulBlocks == 2UL, "did not block again when the freed block was taken" );
+    prvCheck( pvBlock == pvBlocks[ 2 ], "not given the block freed the second time" );
+
+    /* Block until the timeout expires. */
+    ulBlocks = 0;
+    xTicksToTimeOut = testTIMEOUT;
+    pvBlock = pvPoolAlloc( xPool, testTIMEOUT );
+    prvCheck( ( ulBlocks == 1UL ) && ( pvBlock == NULL ), "allocation did not time out" );
+    xTicksToTimeOut = 0;
+
+    vPoolGetStats( xPool, &xStats );
+    prvCheck( ( xStats.uxFreeBlocks == 0 ) && ( xStats.uxMinimumEverFreeBlocks == 0 ), "free block counts wrong" );
+    prvCheck( xStats.ulAllocations == ( uint32_t ) ( testBLOCK_COUNT + 4 ), "allocation count wrong" );
+    prvCheck( xStats.ulFrees == ( uint32_t ) 4, "free count wrong" );
+    prvCheck( xStats.ulFailedAllocations == ( uint32_t ) 2, "failed allocation count wrong" );
+    prvCheck( xStats.ulBlockedAllocations == ( uint32_t ) 5, "blocked allocation count wrong" );
+
+    pxHostYieldHook = NULL;
+
+    for( i = 0; i < testBLOCK_COUNT; i++ )
+    {
+        vPoolFree( xPool, pvBlocks[ i ] );
+    }
+
+    prvCheck( uxPoolGetFreeBlockCount( xPool ) == ( UBaseType_t ) testBLOCK_COUNT, "blocks not returned" );
+
+    if( xErrorDetected != pdFALSE )
+    {
+        return 1;
+    }
+
+    printf( "test_mempool: passed\n" );
+
+    return 0;
+}
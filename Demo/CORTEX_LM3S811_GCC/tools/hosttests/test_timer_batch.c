@@ -0,0 +1,202 @@
+/*
+ * test_timer_batch - checks that a batch of timer commands is carried out in
+ * one go and that the sending task is told when it is complete.
+ *
+ * timers.c is built in so the timer service task's command processing can be
+ * called directly.  The scheduler is started, which returns at once with the
+ * test's sending task as the running task.  When the sending task blocks for
+ * the batch to complete, its yield calls the test's hook, which switches to the
+ * timer service task, processes the timer queue, and switches back.  The test
+ * checks that:
+ *
+ * + Before the scheduler is started a batch is carried out directly.
+ * + A batch sent by a task is carried out by the timer service task, in order,
+ *   for both soft and hard timers, and not before the sender has blocked.
+ * + A batch sent from the timer service task is carried out directly.
+ * + A notification left pending at configTIMER_BATCH_NOTIFICATION_INDEX does
+ *   not end the wait early, and another notification sent to that index while
+ *   the batch is outstanding does not end it either and is not lost.
+ * + The notification at the other index is not touched.
+ * + A batch that cannot be queued in time fails without blocking.
+ *
+ * Usage:
+ *     test_timer_batch
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Built in so the timer queue can be processed directly. */
+#include "timers.c"
+
+#define testTIMERS              4
+#define testNEW_PERIOD          50
+#define testHARD_PERIOD         20
+#define testOTHER_INDEX         ( ( configTIMER_BATCH_NOTIFICATION_INDEX + 1 ) % configTASK_NOTIFICATION_ARRAY_ENTRIES )
+#define testOTHER_VALUE         0x55UL
+#define testFOREIGN_BIT         0x01UL
+
+static TimerHandle_t xTimers[ testTIMERS ];
+static TimerHandle_t xHardTimer;
+static TaskHandle_t xSendingTask;
+
+/* The number of times the sending task has blocked, and the number of those on
+ * which the hook only sends another notification to the batch index. */
+static unsigned long ulBlocks = 0, ulForeignNotifications = 0;
+
+static BaseType_t xErrorDetected = pdFALSE;
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+}
+
+static void prvSendingTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+static void prvCheck( BaseType_t xCondition,
+                      const char * pcMessage )
+{
+    if( xCondition == pdFALSE )
+    {
+        fprintf( stderr, "test_timer_batch: %s\n", pcMessage );
+        xErrorDetected = pdTRUE;
+    }
+}
+
+static void prvSetCommand( TimerBatchCommand_t * pxCommand,
+                           TimerHandle_t xTimer,
+                           BaseType_t xCommandID,
+                           TickType_t xOptionalValue )
+{
+    pxCommand->xTimer = xTimer;
+    pxCommand->xCommandID = xCommandID;
+    pxCommand->xOptionalValue = xOptionalValue;
+}
+
+/* Runs when the sending task yields as it blocks waiting for its batch. */
+static void prvSendingTaskBlocking( void )
+{
+    TimerBatchCommand_t xCommand;
+
+    ulBlocks++;
+
+    if( ulForeignNotifications > 0UL )
+    {
+        /* Something else notifies the sender at the batch index first. */
+        ulForeignNotifications--;
+        ( void ) xTaskNotifyIndexed( xSendingTask, configTIMER_BATCH_NOTIFICATION_INDEX, testFOREIGN_BIT, eSetBits );
+    }
+    else
+    {
+        /* The batch is still on the queue, so was not carried out before the
+         * sender blocked. */
+        prvCheck( uxQueueMessagesWaiting( xTimerQueue ) == ( UBaseType_t ) 1, "batch not queued" );
+
+        /* The sender is blocked, so the timer service task runs. */
+        vTaskSwitchContext();
+        prvCheck( xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle(), "timer service task not switched in" );
+
+        /* A batch sent from the timer service task is carried out directly. */
+        prvSetCommand( &xCommand, xTimers[ 3 ], tmrCOMMAND_START, xTaskGetTickCount() );
+        prvCheck( xTimerSendCommandBatch( &xCommand, 1, 0 ) == pdPASS, "batch from the timer service task failed" );
+        prvCheck( xTimerIsTimerActive( xTimers[ 3 ] ) != pdFALSE, "batch from the timer service task not carried out" );
+
+        prvProcessReceivedCommands();
+
+        /* The sender has been notified, so is switched back in. */
+        vTaskSwitchContext();
+        prvCheck( xTaskGetCurrentTaskHandle() == xSendingTask, "sending task not unblocked" );
+    }
+}
+
+int main( void )
+{
+    TimerBatchCommand_t xCommands[ 5 ];
+    uint32_t ulValue;
+    int i;
+
+    for( i = 0; i < testTIMERS; i++ )
+    {
+        xTimers[ i ] = xTimerCreate( "Timer", 10 + i, pdTRUE, NULL, prvCallback );
+    }
+
+    xHardTimer = xTimerCreate( "Hard", 10, pdTRUE, NULL, prvCallback );
+    xTaskCreate( prvSendingTask, "Sender", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &xSendingTask );
+
+    if( ( xTimers[ testTIMERS - 1 ] == NULL ) || ( xHardTimer == NULL ) || ( xSendingTask == NULL ) )
+    {
+        return 1;
+    }
+
+    vTimerSetHard( xHardTimer );
+
+    /* Before the scheduler is started the batch is carried out directly. */
+    prvSetCommand( &xCommands[ 0 ], xTimers[ 0 ], tmrCOMMAND_START, xTaskGetTickCount() );
+    prvSetCommand( &xCommands[ 1 ], xHardTimer, tmrCOMMAND_START, xTaskGetTickCount() );
+    prvCheck( xTimerSendCommandBatch( xCommands, 2, 0 ) == pdPASS, "batch before the scheduler started failed" );
+    prvCheck( ( xTimerIsTimerActive( xTimers[ 0 ] ) != pdFALSE ) && ( xTimerIsTimerActive( xHardTimer ) != pdFALSE ), "batch before the scheduler started not carried out" );
+    prvCheck( uxQueueMessagesWaiting( xTimerQueue ) == ( UBaseType_t ) 0, "batch before the scheduler started queued" );
+
+    vTaskStartScheduler();
+    prvCheck( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING, "scheduler not running" );
+    prvCheck( xTaskGetCurrentTaskHandle() == xSendingTask, "sending task not running" );
+    pxHostYieldHook = prvSendingTaskBlocking;
+
+    /* A batch sent with a completion notification left pending, and a value at
+     * the other index. */
+    ( void ) xTaskNotifyIndexed( xSendingTask, testOTHER_INDEX, testOTHER_VALUE, eSetValueWithOverwrite );
+    ( void ) xTaskNotifyIndexed( xSendingTask, configTIMER_BATCH_NOTIFICATION_INDEX, tmrBATCH_COMPLETE, eSetBits );
+    prvSetCommand( &xCommands[ 0 ], xTimers[ 0 ], tmrCOMMAND_STOP, 0 );
+    prvSetCommand( &xCommands[ 1 ], xTimers[ 1 ], tmrCOMMAND_CHANGE_PERIOD, testNEW_PERIOD );
+    prvSetCommand( &xCommands[ 2 ], xTimers[ 2 ], tmrCOMMAND_START, xTaskGetTickCount() );
+    prvSetCommand( &xCommands[ 3 ], xTimers[ 2 ], tmrCOMMAND_STOP, 0 );
+    prvSetCommand( &xCommands[ 4 ], xHardTimer, tmrCOMMAND_CHANGE_PERIOD, testHARD_PERIOD );
+    prvCheck( xTimerSendCommandBatch( xCommands, 5, 0 ) == pdPASS, "batch failed" );
+    prvCheck( ulBlocks == 1UL, "sender did not wait for the batch" );
+    prvCheck( xTimerIsTimerActive( xTimers[ 0 ] ) == pdFALSE, "stop not carried out" );
+    prvCheck( ( xTimerIsTimerActive( xTimers[ 1 ] ) != pdFALSE ) && ( xTimerGetPeriod( xTimers[ 1 ] ) == testNEW_PERIOD ), "change period not carried out" );
+    prvCheck( xTimerIsTimerActive( xTimers[ 2 ] ) == pdFALSE, "commands not carried out in order" );
+    prvCheck( ( xTimerIsTimerActive( xHardTimer ) != pdFALSE ) && ( xTimerGetPeriod( xHardTimer ) == testHARD_PERIOD ), "hard timer command not carried out" );
+    prvCheck( xTaskNotifyStateClearIndexed( xSendingTask, configTIMER_BATCH_NOTIFICATION_INDEX ) == pdFALSE, "completion left pending" );
+    prvCheck( ( ulTaskNotifyValueClearIndexed( xSendingTask, configTIMER_BATCH_NOTIFICATION_INDEX, 0 ) & tmrBATCH_COMPLETE ) == 0UL, "completion bit not cleared" );
+    prvCheck( xTaskNotifyStateClearIndexed( xSendingTask, testOTHER_INDEX ) != pdFALSE, "other index notification lost" );
+    prvCheck( ulTaskNotifyValueClearIndexed( xSendingTask, testOTHER_INDEX, 0 ) == testOTHER_VALUE, "other index value changed" );
+
+    /* A batch with another notification sent to the batch index while it is
+     * outstanding. */
+    ulBlocks = 0;
+    ulForeignNotifications = 1;
+    ( void ) xTimerStop( xTimers[ 3 ], 0 );
+    prvProcessReceivedCommands();
+    prvSetCommand( &xCommands[ 0 ], xTimers[ 0 ], tmrCOMMAND_START, xTaskGetTickCount() );
+    prvCheck( xTimerSendCommandBatch( xCommands, 1, 0 ) == pdPASS, "batch with another notification failed" );
+    prvCheck( ulBlocks == 2UL, "other notification ended the wait" );
+    prvCheck( xTimerIsTimerActive( xTimers[ 0 ] ) != pdFALSE, "batch with another notification not carried out" );
+    ulValue = ulTaskNotifyValueClearIndexed( xSendingTask, configTIMER_BATCH_NOTIFICATION_INDEX, testFOREIGN_BIT );
+    prvCheck( ulValue == testFOREIGN_BIT, "other notification value lost" );
+
+    /* A batch that cannot be queued. */
+    ulBlocks = 0;
+
+    while( xTimerReset( xTimers[ 1 ], 0 ) != pdFAIL )
+    {
+    }
+
+    prvSetCommand( &xCommands[ 0 ], xTimers[ 0 ], tmrCOMMAND_STOP, 0 );
+    prvCheck( xTimerSendCommandBatch( xCommands, 1, 0 ) == pdFAIL, "batch sent to a full queue" );
+    prvCheck( ulBlocks == 0UL, "sender blocked on a batch that was not sent" );
+    prvProcessReceivedCommands();
+    prvCheck( xTimerIsTimerActive( xTimers[ 0 ] ) != pdFALSE, "batch that was not sent carried out" );
+
+    if( xErrorDetected != pdFALSE )
+    {
+        return 1;
+    }
+
+    printf( "test_timer_batch: passed\n" );
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * Configuration used only to build the FreeRTOS kernel and
+ * Demo/Common/Minimal/PendingReadyBurst.c into prbbench.
+ * configPENDING_READY_LIST_DRAIN_BATCH is set on the command line by the
+ * prbbench rule in the demo Makefile.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION                1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 0
+#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 20000000 )
+#define configTICK_RATE_HZ                  ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 64 )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 1024 * 1024 ) )
+#define configMAX_TASK_NAME_LEN             ( 10 )
+#define configUSE_16_BIT_TICKS              0
+#define configMAX_PRIORITIES                ( 5 )
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configUSE_MALLOC_FAILED_HOOK        0
+
+/* The list end marker is a full list item, as at -O2 the host compiler's
+ * aliasing rules otherwise break the walks of the delayed and pending ready
+ * lists that prbbench exercises. */
+#define configUSE_MINI_LIST_ITEM            0
+
+#define INCLUDE_vTaskSuspend                1
+#define INCLUDE_vTaskDelay                  1
+
+/* Gives prbbench access to the current task, see
+ * freertos_tasks_c_additions.h. */
+#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H    1
+
+/* PendingReadyBurst.c times each drain of the pending ready list with a host
+ * clock in nanoseconds.  prbbench also counts the tasks each drain moves. */
+unsigned long ulPRBBenchTimestamp( void );
+void vPendingReadyBurstDrainStart( void );
+void vPRBBenchDrainEnd( unsigned long uxTasksMoved );
+
+#define prbGET_TIMESTAMP()                                ( ( uint32_t ) ulPRBBenchTimestamp() )
+#define traceTASK_RESUME_ALL_DRAIN_START()                vPendingReadyBurstDrainStart()
+#define traceTASK_RESUME_ALL_DRAIN_END( uxTasksMoved )    vPRBBenchDrainEnd( uxTasksMoved )
+
+#define configASSERT( x )                   assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,19 @@
+/*
+ * Included at the end of tasks.c (configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H is
+ * 1), so prbbench can make a task the current task before it runs the task's
+ * blocking call.
+ */
+
+void vPRBBenchSetCurrentTask( TaskHandle_t xTask )
+{
+    pxCurrentTCB = xTask;
+}
+
+/* The host portYIELD_WITHIN_API() does not switch away, so ulTaskNotifyTake()
+ * goes on to clear the waiting state it set before blocking.  On the target the
+ * task is switched out with the state still set, which is what lets
+ * vTaskNotifyGiveFromISR() ready it again. */
+void vPRBBenchLeaveCurrentTaskWaiting( void )
+{
+    pxCurrentTCB->ucNotifyState[ 0 ] = taskWAITING_NOTIFICATION;
+}
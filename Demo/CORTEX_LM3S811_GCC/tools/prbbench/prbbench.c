@@ -0,0 +1,195 @@
+/*
+ * prbbench - runs the PendingReadyBurst test on the host and reports how long
+ * xTaskResumeAll() keeps interrupts masked while it drains the burst.
+ *
+ * The kernel and Demo/Common/Minimal/PendingReadyBurst.c are built for the host
+ * with configPENDING_READY_LIST_DRAIN_BATCH set one way or the other (see the
+ * prbbench rule in the demo Makefile).  The LM3S811 has too little RAM for the
+ * test's waiter tasks, so prbbench stands in for the scheduler instead.  It
+ * runs each waiter's ulTaskNotifyTake() with that waiter made the current task,
+ * so the waiters block on their notification as they would on the target.
+ * Each burst then does what the test's controller task and tick hook do:
+ * suspend the scheduler, call vPendingReadyBurstPeriodicISR() to notify every
+ * waiter, and resume the scheduler, which drains the pending ready list.
+ * Every waiter is then run to check it was readied once.
+ *
+ * The drain is timed through the trace macros mapped onto PendingReadyBurst.c
+ * in FreeRTOSConfig.h.  Printed are the number of tasks readied by each burst,
+ * the most tasks moved in one critical section, and the median and fastest of
+ * the longest masked drain of each burst, in nanoseconds.  The task counts are
+ * the same on the target; the times are host times and only compare the two
+ * builds.
+ *
+ * Usage:
+ *     prbbench [-b bursts]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Built in so the test's waiter handles, burst request and drain timing can be
+ * driven and read directly. */
+#include "PendingReadyBurst.c"
+
+#define benchDEFAULT_BURSTS    1000UL
+
+/* Defined in freertos_tasks_c_additions.h. */
+void vPRBBenchSetCurrentTask( TaskHandle_t xTask );
+void vPRBBenchLeaveCurrentTaskWaiting( void );
+
+/* The most tasks moved by one drain. */
+static UBaseType_t uxMostMoved = 0;
+
+/* Mapped onto traceTASK_RESUME_ALL_DRAIN_END() in FreeRTOSConfig.h. */
+void vPRBBenchDrainEnd( UBaseType_t uxTasksMoved )
+{
+    if( uxTasksMoved > uxMostMoved )
+    {
+        uxMostMoved = uxTasksMoved;
+    }
+
+    vPendingReadyBurstDrainEnd( uxTasksMoved );
+}
+
+/* The scheduler is never started and the tasks never run. */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    ( void ) pxCode;
+    ( void ) pvParameters;
+
+    return pxTopOfStack - 16;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+}
+
+unsigned long ulPRBBenchTimestamp( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC, &xTime );
+
+    return ( unsigned long ) xTime.tv_sec * 1000000000UL + ( unsigned long ) xTime.tv_nsec;
+}
+
+/* Runs a waiter up to its next blocking call, counting the wake up it has
+ * consumed, as prvWaiterTask() does. */
+static void prvRunWaiter( UBaseType_t uxIndex,
+                          BaseType_t xCountWakeUp )
+{
+    vPRBBenchSetCurrentTask( xWaiters[ uxIndex ] );
+
+    /* The waiter has been notified, so the first call does not block. */
+    if( ( xCountWakeUp != pdFALSE ) && ( ulTaskNotifyTake( pdTRUE, portMAX_DELAY ) != 0UL ) )
+    {
+        ulWaiterCycles[ uxIndex ]++;
+    }
+
+    /* Nothing has notified the waiter, so it blocks. */
+    ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    vPRBBenchLeaveCurrentTaskWaiting();
+}
+
+static int prvCompare( const void * pv1,
+                       const void * pv2 )
+{
+    const uint32_t ul1 = *( const uint32_t * ) pv1, ul2 = *( const uint32_t * ) pv2;
+
+    return ( ul1 > ul2 ) - ( ul1 < ul2 );
+}
+
+int main( int argc,
+          char ** argv )
+{
+    unsigned long ulBursts = benchDEFAULT_BURSTS, ul;
+    uint32_t * pulMaxMasked;
+    UBaseType_t x;
+    int i;
+
+    for( i = 1; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "-b" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulBursts = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [-b bursts]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    if( ulBursts == 0 )
+    {
+        fprintf( stderr, "prbbench: the burst count must not be 0\n" );
+        return 2;
+    }
+
+    pulMaxMasked = malloc( ulBursts * sizeof( uint32_t ) );
+
+    if( pulMaxMasked == NULL )
+    {
+        return 1;
+    }
+
+    vStartPendingReadyBurstTasks( tskIDLE_PRIORITY + 2 );
+
+    for( x = 0; x < prbNUMBER_OF_WAITERS; x++ )
+    {
+        prvRunWaiter( x, pdFALSE );
+    }
+
+    for( ul = 0; ul < ulBursts; ul++ )
+    {
+        ulMaxMaskedTime = 0;
+
+        /* prvControllerTask(), with the tick hook's call made directly. */
+        vTaskSuspendAll();
+        {
+            xBurstRequested = pdTRUE;
+            vPendingReadyBurstPeriodicISR();
+            configASSERT( xBurstRequested == pdFALSE );
+
+            xDrainingBurst = pdTRUE;
+        }
+        ( void ) xTaskResumeAll();
+        xDrainingBurst = pdFALSE;
+
+        pulMaxMasked[ ul ] = ulMaxMaskedTime;
+
+        for( x = 0; x < prbNUMBER_OF_WAITERS; x++ )
+        {
+            prvRunWaiter( x, pdTRUE );
+
+            if( ulWaiterCycles[ x ] != ( ul + 1UL ) )
+            {
+                fprintf( stderr, "prbbench: waiter %lu missed burst %lu\n", ( unsigned long ) x, ul );
+                return 1;
+            }
+        }
+    }
+
+    qsort( pulMaxMasked, ulBursts, sizeof( uint32_t ), prvCompare );
+
+    printf( "batch %-4u %u tasks per burst  %3u tasks per critical section  masked %6lu ns median  %6lu ns fastest  (%lu bursts)\n",
+            ( unsigned ) configPENDING_READY_LIST_DRAIN_BATCH,
+            ( unsigned ) prbNUMBER_OF_WAITERS,
+            ( unsigned ) uxMostMoved,
+            ( unsigned long ) pulMaxMasked[ ulBursts / 2UL ],
+            ( unsigned long ) pulMaxMasked[ 0 ],
+            ulBursts );
+
+    free( pulMaxMasked );
+
+    return 0;
+}
@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+"""
+Schedulability and response time analysis for FreeRTOS task sets.
+
+The task set is read either from a CSV description (see tasksets/) or from
+the SCHEDHZ/SCHED lines the demo prints over the UART when
+configRECORD_JOB_TIMES is 1.  The analysis accounts for the FreeRTOS tick:
+periods are converted to whole ticks the way the source code converts them,
+the tick interrupt itself steals processor time, and a task of equal priority
+can run a full job before the task under analysis (round robin time slicing).
+
+The period_unit column of a CSV task set says how the period reaches the
+kernel:
+    ms          pdMS_TO_TICKS( period ), truncated to whole ticks
+    ms_div      period / portTICK_PERIOD_MS, which is 0 above 1000 Hz
+    ticks       a literal tick count
+Sporadic and background tasks are not quantised.
+
+Usage:
+    rta.py tasksets/lm3s811_demo.csv
+    rta.py --tick-rate 100 tasksets/common_minimal.csv
+    rta.py --log uart.txt --policy both
+
+The exit status is 1 if any task set analysed is not schedulable.
+"""
+
+import argparse
+import csv
+import math
+import sys
+
+KINDS = ( "periodic", "sporadic", "background" )
+UNITS = ( "ms", "ms_div", "ticks" )
+BREAKDOWN_LIMIT = 64
+
+
+class Task:
+    def __init__( self, name, priority, period_ms, wcet_ms, deadline_ms, kind, unit = "ms" ):
+        self.name = name
+        self.priority = priority
+        self.period_ms = period_ms
+        self.unit = unit
+        self.wcet_ms = wcet_ms
+        self.deadline_ms = deadline_ms
+        self.kind = kind
+
+        # Filled in by quantise().
+        self.period = 0.0
+        self.deadline = 0.0
+        self.cost = 0.0
+        self.problem = ""
+
+    def quantise( self, tick_rate, switch_cost_ms ):
+        """Convert the task's timing to what the kernel will actually do."""
+        self.cost = self.wcet_ms + 2.0 * switch_cost_ms
+        self.deadline = self.deadline_ms if self.deadline_ms > 0 else self.period_ms
+
+        if self.kind == "periodic":
+            # The conversions truncate, so a periodic task is released every
+            # whole number of ticks - possibly 0 ticks, in which case the task
+            # never blocks.
+            if self.unit == "ticks":
+                ticks = int( self.period_ms )
+            elif self.unit == "ms_div":
+                tick_period_ms = 1000 // tick_rate
+
+                if tick_period_ms == 0:
+                    ticks = 0
+                    self.problem = "portTICK_PERIOD_MS is 0 at this tick rate"
+                else:
+                    ticks = int( self.period_ms ) // tick_period_ms
+            else:
+                ticks = int( ( self.period_ms * tick_rate ) // 1000 )
+
+            if ticks == 0 and not self.problem:
+                self.problem = "period below tick resolution - never blocks"
+
+            self.period = ticks * 1000.0 / tick_rate
+
+            if self.deadline_ms <= 0:
+                self.deadline = self.period
+        else:
+            self.period = self.period_ms
+
+
+def load_csv( path ):
+    tasks = []
+
+    with open( path, newline = "" ) as f:
+        rows = [ r for r in csv.reader( f ) if r and not r[ 0 ].lstrip().startswith( "#" ) ]
+
+    header = [ h.strip() for h in rows[ 0 ] ]
+
+    for row in rows[ 1: ]:
+        r = dict( zip( header, [ c.strip() for c in row ] ) )
+        kind = r.get( "kind" ) or "periodic"
+        unit = r.get( "period_unit" ) or "ms"
+
+        if kind not in KINDS:
+            raise ValueError( "%s: unknown kind '%s' for task %s" % ( path, kind, r[ "name" ] ) )
+
+        if unit not in UNITS:
+            raise ValueError( "%s: unknown period unit '%s' for task %s" % ( path, unit, r[ "name" ] ) )
+
+        tasks.append( Task( r[ "name" ],
+                            int( r[ "priority" ] ),
+                            float( r.get( "period" ) or 0 ),
+                            float( r[ "wcet_ms" ] ),
+                            float( r.get( "deadline_ms" ) or 0 ),
+                            kind,
+                            unit ) )
+
+    return tasks, None
+
+
+def load_log( path ):
+    """Read the last SCHED report printed by the top task."""
+    counter_hz = None
+    tick_rate = None
+    latest = {}
+
+    with open( path, errors = "replace" ) as f:
+        for line in f:
+            fields = line.strip().strip( "\0" ).split( "," )
+
+            if fields[ 0 ] == "SCHEDHZ" and len( fields ) >= 3:
+                counter_hz = float( fields[ 1 ] )
+                tick_rate = int( fields[ 2 ] )
+            elif fields[ 0 ] == "SCHED" and len( fields ) >= 6:
+                latest[ fields[ 1 ] ] = fields[ 1: ]
+
+    if counter_hz is None:
+        raise ValueError( "%s: no SCHEDHZ line found - is configRECORD_JOB_TIMES set to 1?" % path )
+
+    tasks = []
+    to_ms = 1000.0 / counter_hz
+
+    for name, ( _, priority, interval, job, jobs ) in latest.items():
+        interval_ms = int( interval ) * to_ms
+        job_ms = int( job ) * to_ms
+
+        if name == "IDLE":
+            continue
+
+        if int( jobs ) == 0:
+            print( "%s: %s has not run yet and is not analysed" % ( path, name ), file = sys.stderr )
+            continue
+
+        if int( jobs ) == 1:
+            if int( job ) != 0:
+                print( "%s: %s has only run once so its period is unknown" % ( path, name ), file = sys.stderr )
+                continue
+
+            # Still in its first job - the task has never blocked, so it
+            # competes for all the time left by higher priority tasks.
+            kind = "background"
+        else:
+            kind = "sporadic"
+
+        tasks.append( Task( name, int( priority ), interval_ms, job_ms, 0, kind ) )
+
+    return tasks, tick_rate
+
+
+def tick_task( tick_rate, tick_cost_ms ):
+    t = Task( "<tick>", sys.maxsize, 1000.0 / tick_rate, tick_cost_ms, 0, "periodic" )
+    t.period = t.deadline = t.period_ms
+    t.cost = tick_cost_ms
+    return t
+
+
+def fixed_priority( tasks, tick, scale = 1.0 ):
+    """
+    Classic response time analysis.  Returns one (task, R, reason) tuple per
+    task, where R is None if the task is not schedulable.
+    """
+    results = []
+
+    for t in tasks:
+        if t.kind == "background":
+            results.append( ( t, None, "background - no deadline" ) )
+            continue
+
+        if t.period <= 0:
+            results.append( ( t, None, t.problem or "period is 0" ) )
+            continue
+
+        # Higher priority tasks preempt.  Equal priority tasks share the
+        # processor in time slices, so in the worst case each of them runs a
+        # full job first.
+        interferers = [ i for i in tasks if i is not t and i.priority >= t.priority ]
+        hogs = [ i.name for i in interferers if i.kind == "background" or i.period <= 0 ]
+
+        if hogs:
+            results.append( ( t, None, "starved by " + " ".join( hogs ) ) )
+            continue
+
+        cost = t.cost * scale
+        w = cost
+        r = None
+
+        while w <= t.deadline:
+            demand = cost + math.ceil( w / tick.period ) * tick.cost
+            demand += sum( math.ceil( w / i.period ) * i.cost * scale for i in interferers )
+
+            if demand <= w + 1e-9:
+                r = w
+                break
+
+            w = demand
+
+        results.append( ( t, r, "" if r is not None else "misses deadline" ) )
+
+    return results
+
+
+def edf_demand( tasks, tick, scale = 1.0 ):
+    """
+    Processor demand analysis for preemptive EDF.  FreeRTOS schedules by fixed
+    priority; this shows whether the same task set would fit if deadlines
+    were used instead.  Returns (schedulable, utilisation, reason).
+    """
+    # Background tasks have no deadline, so only ever run when no job with a
+    # deadline is pending.
+    rt = [ t for t in tasks if t.kind != "background" ]
+
+    if any( t.period <= 0 for t in rt ):
+        return False, float( "inf" ), "a task has a period below the tick resolution"
+
+    jobs = [ ( t.period, t.deadline, t.cost * scale ) for t in rt ] + [ ( tick.period, tick.deadline, tick.cost ) ]
+    u = sum( c / p for p, _, c in jobs )
+
+    if u > 1.0:
+        return False, u, "utilisation above 100%"
+
+    # Length of the synchronous busy period bounds the interval to check.
+    length = sum( c for _, _, c in jobs )
+
+    for _ in range( 10000 ):
+        nxt = sum( math.ceil( length / p ) * c for p, _, c in jobs )
+
+        if nxt <= length + 1e-9:
+            break
+
+        length = nxt
+
+    points = sorted( { k * p + d for p, d, _ in jobs for k in range( int( length // p ) + 1 ) if k * p + d <= length } )
+
+    for t in points:
+        demand = sum( ( math.floor( ( t - d ) / p ) + 1 ) * c for p, d, c in jobs if t >= d )
+
+        if demand > t + 1e-9:
+            return False, u, "demand %.3f ms exceeds %.3f ms" % ( demand, t )
+
+    return True, u, ""
+
+
+def breakdown( check, tasks, tick ):
+    """Largest factor the task costs can be scaled by and stay schedulable."""
+    lo, hi = 0.0, float( BREAKDOWN_LIMIT )
+
+    if not check( tasks, tick, 1e-6 ):
+        return 0.0
+
+    for _ in range( 40 ):
+        mid = ( lo + hi ) / 2
+
+        if check( tasks, tick, mid ):
+            lo = mid
+        else:
+            hi = mid
+
+    return lo
+
+
+def scaling( factor ):
+    return "more than x%d" % BREAKDOWN_LIMIT if factor >= BREAKDOWN_LIMIT - 1e-6 else "x%.2f" % factor
+
+
+def fp_ok( tasks, tick, scale ):
+    return all( r is not None or t.kind == "background" for t, r, _ in fixed_priority( tasks, tick, scale ) )
+
+
+def edf_ok( tasks, tick, scale ):
+    return edf_demand( tasks, tick, scale )[ 0 ]
+
+
+def analyse( name, tasks, args ):
+    tick = tick_task( args.tick_rate, args.tick_cost_us / 1000.0 )
+
+    for t in tasks:
+        t.quantise( args.tick_rate, args.switch_cost_us / 1000.0 )
+
+    tasks.sort( key = lambda t: -t.priority )
+    util = sum( t.cost / t.period for t in tasks if t.kind != "background" and t.period > 0 ) + tick.cost / tick.period
+    ok = True
+
+    print( "%s at configTICK_RATE_HZ=%d (tick %.3f ms, tick cost %.1f us, switch cost %.1f us)" %
+           ( name, args.tick_rate, tick.period, args.tick_cost_us, args.switch_cost_us ) )
+    print( "  utilisation %.1f%% (headroom %.1f%%)" % ( util * 100, ( 1 - util ) * 100 ) )
+
+    if args.policy in ( "fp", "both" ):
+        print( "  %-10s %4s %10s %9s %10s %10s  %s" % ( "TASK", "PRIO", "PERIOD ms", "COST ms", "DEADLN ms", "WCRT ms", "" ) )
+
+        for t, r, reason in fixed_priority( tasks, tick ):
+            period = "-" if t.kind == "background" else "%.3f" % t.period
+            deadline = "-" if t.kind == "background" else "%.3f" % t.deadline
+            wcrt = "-" if r is None else "%.3f" % r
+            flag = "" if r is not None else ( "  " if t.kind == "background" else "  NOT SCHEDULABLE: " ) + reason
+
+            if r is None and t.kind != "background":
+                ok = False
+
+            print( "  %-10s %4d %10s %9.3f %10s %10s%s" % ( t.name, t.priority, period, t.cost, deadline, wcrt, flag ) )
+
+        print( "  fixed priority: %s, costs may grow by %s" %
+               ( "schedulable" if fp_ok( tasks, tick, 1.0 ) else "NOT SCHEDULABLE", scaling( breakdown( fp_ok, tasks, tick ) ) ) )
+
+    if args.policy in ( "edf", "both" ):
+        good, u, reason = edf_demand( tasks, tick )
+
+        if good:
+            print( "  EDF: schedulable, costs may grow by %s" % scaling( breakdown( edf_ok, tasks, tick ) ) )
+        else:
+            print( "  EDF: NOT SCHEDULABLE (%s)" % reason )
+
+        if args.policy == "edf":
+            ok = ok and good
+
+    print()
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser( description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter )
+    parser.add_argument( "tasksets", nargs = "*", help = "task set CSV files" )
+    parser.add_argument( "--log", action = "append", default = [], help = "UART capture containing SCHED lines" )
+    parser.add_argument( "--tick-rate", type = int, help = "configTICK_RATE_HZ (default 1000, or the rate in the log)" )
+    parser.add_argument( "--tick-cost-us", type = float, default = 10.0, help = "execution time of the tick interrupt" )
+    parser.add_argument( "--switch-cost-us", type = float, default = 5.0, help = "cost of one context switch" )
+    parser.add_argument( "--policy", choices = ( "fp", "edf", "both" ), default = "fp" )
+    args = parser.parse_args()
+
+    if not args.tasksets and not args.log:
+        parser.error( "no task set given" )
+
+    fixed_rate = args.tick_rate
+    ok = True
+
+    for path in args.tasksets:
+        tasks, _ = load_csv( path )
+        args.tick_rate = fixed_rate or 1000
+        ok = analyse( path, tasks, args ) and ok
+
+    for path in args.log:
+        tasks, rate = load_log( path )
+        args.tick_rate = fixed_rate or rate or 1000
+        ok = analyse( path, tasks, args ) and ok
+
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit( main() )
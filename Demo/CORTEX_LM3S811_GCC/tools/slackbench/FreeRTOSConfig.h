@@ -0,0 +1,36 @@
+/*
+ * Configuration used only to build the FreeRTOS kernel and timers.c into
+ * slackbench.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION                1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 0
+#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 20000000 )
+#define configTICK_RATE_HZ                  ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 64 )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 64 * 1024 ) )
+#define configMAX_TASK_NAME_LEN             ( 10 )
+#define configUSE_16_BIT_TICKS              0
+#define configMAX_PRIORITIES                ( 5 )
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configUSE_MALLOC_FAILED_HOOK        0
+
+/* The list end marker is a full list item, as at -O2 the host compiler's
+ * aliasing rules otherwise break the walks of the timer lists. */
+#define configUSE_MINI_LIST_ITEM            0
+
+#define configUSE_TIMERS                    1
+#define configTIMER_TASK_PRIORITY           ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH            10
+#define configTIMER_TASK_STACK_DEPTH        configMINIMAL_STACK_SIZE
+#define configUSE_TIMER_SLACK               1
+
+#define configASSERT( x )                   assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
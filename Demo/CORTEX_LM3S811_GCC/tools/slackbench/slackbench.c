@@ -0,0 +1,203 @@
+/*
+ * slackbench - runs a periodic software timer workload on the host and reports
+ * how often the timer service task wakes to process it, with and without timer
+ * slack.
+ *
+ * timers.c is built in so its processing functions can be called directly.
+ * The scheduler is never started.  Instead slackbench steps the tick count and
+ * does what the timer service task does: when the tick count reaches the time
+ * the task would unblock at it processes every expired timer, then works out
+ * the next time to unblock from prvGetCoalescedWakeTime(), as
+ * prvProcessTimerOrBlockTask() does.
+ *
+ * The workload is benchNUMBER_OF_TIMERS auto-reload timers with the periods in
+ * xPeriods[], started at staggered times as independent drivers would start
+ * them.  Each timer is given a slack of the given percentage of its period
+ * with xTimerSetSlack().  Printed are the timer expiries and the wake ups that
+ * processed them per second, from vTimerGetWakeupStats(), and the latest any
+ * callback ran after its timer's expiry time.  slackbench fails if a callback
+ * runs later than its own timer's slack.  With a slack of 0 every expiry
+ * time is a wake up of its own unless two timers happen to expire on the same
+ * tick.
+ *
+ * Usage:
+ *     slackbench [-s slack percent] [-t seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Built in so the timer service task's processing can be run directly. */
+#include "timers.c"
+
+#define benchNUMBER_OF_TIMERS    ( sizeof( xPeriods ) / sizeof( xPeriods[ 0 ] ) )
+#define benchDEFAULT_SECONDS     600UL
+
+/* Sensor polling, watchdog feeding, LED blinking and protocol timeouts. */
+static const TickType_t xPeriods[] =
+{
+    pdMS_TO_TICKS( 100 ), pdMS_TO_TICKS( 150 ), pdMS_TO_TICKS( 200 ), pdMS_TO_TICKS( 250 ),
+    pdMS_TO_TICKS( 300 ), pdMS_TO_TICKS( 500 ), pdMS_TO_TICKS( 700 ), pdMS_TO_TICKS( 1000 )
+};
+
+/* The latest a callback has run after its timer's expiry time. */
+static TickType_t xMostLate = 0;
+
+/* Set if a callback runs later than its timer's slack allows. */
+static BaseType_t xErrorDetected = pdFALSE;
+
+/* The scheduler is never started and the tasks never run. */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    ( void ) pxCode;
+    ( void ) pvParameters;
+
+    return pxTopOfStack - 16;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+}
+
+static void prvIdleTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+/* The expiry being processed is the one before the timer's reloaded expiry
+ * time. */
+static void prvCallback( TimerHandle_t xTimer )
+{
+    const Timer_t * const pxTimer = xTimer;
+    const TickType_t xLate = xTaskGetTickCount() - ( listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) - pxTimer->xTimerPeriodInTicks );
+
+    if( xLate > xMostLate )
+    {
+        xMostLate = xLate;
+    }
+
+    if( xLate > pxTimer->xTimerSlackInTicks )
+    {
+        xErrorDetected = pdTRUE;
+    }
+}
+
+/* prvProcessTimerOrBlockTask() up to the point the task would block, returning
+ * the tick count it would block until. */
+static TickType_t prvRunTimerTask( void )
+{
+    TickType_t xNextExpireTime, xTimeNow;
+    BaseType_t xListWasEmpty, xTimerListsWereSwitched;
+
+    for( ; ; )
+    {
+        xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+        if( ( xListWasEmpty != pdFALSE ) || ( xNextExpireTime > xTimeNow ) )
+        {
+            break;
+        }
+
+        prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+    }
+
+    xTimerTaskHasBlocked = pdTRUE;
+
+    return ( xListWasEmpty != pdFALSE ) ? portMAX_DELAY : prvGetCoalescedWakeTime( xNextExpireTime );
+}
+
+int main( int argc,
+          char ** argv )
+{
+    TimerHandle_t xTimers[ benchNUMBER_OF_TIMERS ];
+    unsigned long ulSlackPercent = 0, ulSeconds = benchDEFAULT_SECONDS;
+    uint32_t ulExpiries, ulWakeups;
+    TickType_t xWakeTime = 0, xTicks, xTick;
+    UBaseType_t x;
+    int i;
+
+    for( i = 1; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "-s" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulSlackPercent = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ i ], "-t" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulSeconds = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [-s slack percent] [-t seconds]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    if( ( ulSlackPercent >= 100UL ) || ( ulSeconds == 0UL ) )
+    {
+        fprintf( stderr, "slackbench: the slack must be under 100%% and the time not 0\n" );
+        return 2;
+    }
+
+    /* A task for the tick to run in, as the timer service task is not
+     * created. */
+    xTaskCreate( prvIdleTask, "Bench", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
+    prvCheckForValidListAndQueue();
+
+    for( x = 0; x < benchNUMBER_OF_TIMERS; x++ )
+    {
+        xTimers[ x ] = xTimerCreate( "Bench", xPeriods[ x ], pdTRUE, NULL, prvCallback );
+
+        if( ( xTimers[ x ] == NULL ) || ( xTimerSetSlack( xTimers[ x ], ( xPeriods[ x ] * ulSlackPercent ) / 100UL ) != pdPASS ) )
+        {
+            return 1;
+        }
+    }
+
+    xTicks = ( TickType_t ) ( ulSeconds * configTICK_RATE_HZ );
+
+    for( xTick = 0; xTick < xTicks; xTick++ )
+    {
+        /* Start the timers at staggered times.  Each start command wakes the
+         * timer service task. */
+        if( ( ( xTick % 37U ) == 0U ) && ( ( xTick / 37U ) < benchNUMBER_OF_TIMERS ) )
+        {
+            prvProcessTimerCommand( tmrCOMMAND_START, xTimers[ xTick / 37U ], xTick );
+            xWakeTime = xTick;
+        }
+
+        if( xTick >= xWakeTime )
+        {
+            xWakeTime = prvRunTimerTask();
+        }
+
+        ( void ) xTaskIncrementTick();
+    }
+
+    if( xErrorDetected != pdFALSE )
+    {
+        fprintf( stderr, "slackbench: a callback ran after its timer's slack\n" );
+        return 1;
+    }
+
+    vTimerGetWakeupStats( &ulExpiries, &ulWakeups );
+
+    printf( "slack %2lu%%  %u timers  %7.2f expiries/s  %7.2f wakeups/s  %4u ticks latest callback  (%lu s)\n",
+            ulSlackPercent,
+            ( unsigned ) benchNUMBER_OF_TIMERS,
+            ( double ) ulExpiries / ( double ) ulSeconds,
+            ( double ) ulWakeups / ( double ) ulSeconds,
+            ( unsigned ) xMostLate,
+            ulSeconds );
+
+    return 0;
+}
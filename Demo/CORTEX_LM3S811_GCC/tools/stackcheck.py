@@ -0,0 +1,425 @@
+#!/usr/bin/env python3
+"""
+Worst case stack depth of each FreeRTOS task, found at build time.
+
+Reads the call graphs GCC writes when the sources are compiled with
+-fcallgraph-info=su (one .ci file per object, giving each function's frame size
+as -fstack-usage would) and the preprocessed sources written by -save-temps
+(.i files), which are searched for the xTaskCreate() and xTaskCreateStatic()
+calls that name each task's entry function and stack depth.
+
+The worst case for a task is the deepest path through the call graph from its
+entry function, plus the stack its saved context needs, which is read from
+portTASK_CONTEXT_STACK_WORDS in the port's portmacro.h.  Interrupts are
+assumed to run on their own stack, as they do on the Cortex-M ports, so the
+context is the only interrupt cost a task's stack has to carry.
+
+The result is only a bound if the call graph is complete.  Calls through
+function pointers, calls to functions compiled without -fcallgraph-info
+(libdriver.a, libc, libgcc), recursion and frames of unbounded dynamic size
+are listed against each task they affect.  Use --assume to give the stack
+used by an uncompiled function, and --call to add the targets of a function's
+indirect calls.
+
+Usage:
+    stackcheck.py --portmacro portmacro.h gcc/stack
+    stackcheck.py --assume UARTCharPut=8 --call prvTimerTask=vMyCallback gcc/stack
+
+The exit status is 1 if the worst case of any task exceeds its stack.
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+CREATE_FUNCTIONS = ( "xTaskCreate", "xTaskCreateStatic" )
+INDIRECT = "__indirect_call"
+
+NODE = re.compile( r'node: \{ title: "([^"]+)" label: "([^"]*)"' )
+EDGE = re.compile( r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"' )
+FRAME = re.compile( r"\\n(\d+) bytes \(([a-z,]+)\)" )
+CAST = re.compile( r"\(\s*(?:const\s+|volatile\s+)*(?:unsigned|signed|char|short|int|long|[A-Za-z_]\w*_t)(?:\s+(?:char|short|int|long))*\s*\)" )
+SUFFIX = re.compile( r"\b(0[xX][0-9a-fA-F]+|\d+)[uUlL]+\b" )
+
+
+class Function:
+    def __init__( self, name, label ):
+        self.name = name
+        self.frame = None
+        self.dynamic = False
+        self.calls = set()
+
+        frame = FRAME.search( label )
+
+        if frame:
+            self.frame = int( frame.group( 1 ) )
+            self.dynamic = frame.group( 2 ) == "dynamic"
+
+
+class Task:
+    def __init__( self, name, entry, depth, source, creator ):
+        self.name = name
+        self.entry = entry
+        self.depth = depth
+        self.source = source
+        self.creator = creator
+
+
+class Result:
+    """The deepest path below one function and what makes it uncertain."""
+
+    def __init__( self, depth = 0, path = (), unknown = (), indirect = (), recursive = (), dynamic = () ):
+        self.depth = depth
+        self.path = path
+        self.unknown = frozenset( unknown )
+        self.indirect = frozenset( indirect )
+        self.recursive = frozenset( recursive )
+        self.dynamic = frozenset( dynamic )
+
+
+def load_callgraphs( directory ):
+    """Return the functions of every .ci file, keyed by call graph title."""
+    functions = {}
+    files = sorted( glob.glob( os.path.join( directory, "*.ci" ) ) )
+
+    if not files:
+        raise ValueError( "%s: no .ci files - was it compiled with -fcallgraph-info=su?" % directory )
+
+    for path in files:
+        with open( path ) as f:
+            for line in f:
+                node = NODE.match( line )
+
+                if node:
+                    function = Function( node.group( 1 ), node.group( 2 ) )
+
+                    # A function called from another file appears there as an
+                    # external node without a frame size.
+                    if function.name not in functions or function.frame is not None:
+                        if function.name in functions:
+                            function.calls = functions[ function.name ].calls
+
+                        functions[ function.name ] = function
+
+                    continue
+
+                edge = EDGE.match( line )
+
+                if edge:
+                    functions.setdefault( edge.group( 1 ), Function( edge.group( 1 ), "" ) ).calls.add( edge.group( 2 ) )
+
+    return functions
+
+
+def split_arguments( text, start ):
+    """Split the argument list that opens at text[ start ] into strings."""
+    arguments = []
+    level = 0
+    current = ""
+    quote = None
+    i = start + 1
+
+    while i < len( text ):
+        c = text[ i ]
+
+        if quote:
+            current += c
+
+            if c == "\\":
+                current += text[ i + 1 ]
+                i += 1
+            elif c == quote:
+                quote = None
+        elif c in "\"'":
+            quote = c
+            current += c
+        elif c == "(":
+            level += 1
+            current += c
+        elif c == ")":
+            if level == 0:
+                arguments.append( current.strip() )
+                return arguments
+
+            level -= 1
+            current += c
+        elif c == "," and level == 0:
+            arguments.append( current.strip() )
+            current = ""
+        else:
+            current += c
+
+        i += 1
+
+    return None
+
+
+def evaluate( expression ):
+    """Value of a preprocessed integer constant expression, or None."""
+    expression = SUFFIX.sub( r"\1", CAST.sub( "", expression ) )
+
+    if not re.fullmatch( r"[\d\sxXa-fA-F()+\-*/%<>|&~]+", expression ):
+        return None
+
+    try:
+        return int( eval( expression.replace( "/", "//" ), { "__builtins__": {} } ) )
+    except ( SyntaxError, ZeroDivisionError, TypeError ):
+        return None
+
+
+def function_bodies( text ):
+    """Return ( start, end, name ) of each function defined in text."""
+    bodies = []
+    level = 0
+    statement = 0
+    start = 0
+    name = None
+
+    for i, c in enumerate( text ):
+        if c == "{":
+            if level == 0:
+                header = re.search( r"([A-Za-z_]\w*)\s*\([^;{}]*\)\s*$", text[ statement:i ] )
+                name = header.group( 1 ) if header else None
+                start = i
+
+            level += 1
+        elif c == "}":
+            level -= 1
+
+            if level == 0:
+                if name:
+                    bodies.append( ( start, i, name ) )
+
+                statement = i + 1
+        elif c == ";" and level == 0:
+            statement = i + 1
+
+    return bodies
+
+
+def find_tasks( directory ):
+    """Return the tasks created by the sources preprocessed into directory."""
+    tasks = []
+    call = re.compile( r"\b(%s)\s*\(" % "|".join( CREATE_FUNCTIONS ) )
+
+    for path in sorted( glob.glob( os.path.join( directory, "*.i" ) ) ):
+        with open( path, errors = "replace" ) as f:
+            text = "".join( line for line in f if not line.startswith( "#" ) )
+
+        source = os.path.basename( path )[ :-2 ] + ".c"
+        bodies = function_bodies( text )
+
+        for match in call.finditer( text ):
+            arguments = split_arguments( text, match.end() - 1 )
+
+            # Skip prototypes and the definitions, whose first parameter is
+            # declared with its type.
+            if not arguments or len( arguments ) < 3 or not re.fullmatch( r"[A-Za-z_]\w*", arguments[ 0 ] ):
+                continue
+
+            name = re.fullmatch( r'"(.*)"', arguments[ 1 ] )
+            creator = next( ( n for s, e, n in bodies if s < match.start() < e ), None )
+            tasks.append( Task( name.group( 1 ) if name else arguments[ 1 ], arguments[ 0 ], evaluate( arguments[ 2 ] ), source, creator ) )
+
+    return tasks
+
+
+def read_context_words( portmacro ):
+    with open( portmacro ) as f:
+        match = re.search( r"#\s*define\s+portTASK_CONTEXT_STACK_WORDS\s+(.+)", f.read() )
+
+    if not match:
+        raise ValueError( "%s: portTASK_CONTEXT_STACK_WORDS is not defined" % portmacro )
+
+    words = evaluate( match.group( 1 ).split( "/*" )[ 0 ] )
+
+    if words is None:
+        raise ValueError( "%s: cannot evaluate portTASK_CONTEXT_STACK_WORDS" % portmacro )
+
+    return words
+
+
+def resolve( functions, name, source = None ):
+    """Call graph title of a function named in source, static or not.  With
+    no source, a static function of that name in any file will do."""
+    if name in functions:
+        return name
+
+    # Static functions are qualified with the path the source was compiled as.
+    for title in functions:
+        path, _, function = title.rpartition( ":" )
+
+        if function == name and ( source is None or os.path.basename( path ) == source ):
+            return title
+
+    return None
+
+
+def created_tasks( functions, tasks ):
+    """The tasks whose xTaskCreate() call can be reached from main() or from
+    the entry function of another task that is created."""
+    reachable = set()
+    pending = [ "main" ]
+    created = []
+
+    while pending:
+        title = pending.pop()
+
+        if title in reachable or title not in functions:
+            continue
+
+        reachable.add( title )
+        pending.extend( functions[ title ].calls )
+
+        for task in tasks:
+            if task not in created and task.creator and resolve( functions, task.creator, task.source ) in reachable:
+                created.append( task )
+                pending.append( resolve( functions, task.entry, task.source ) or task.entry )
+
+    return [ t for t in tasks if t in created ]
+
+
+def deepest( functions, title, assumed, active, memo ):
+    if title in memo:
+        return memo[ title ]
+
+    if title == INDIRECT:
+        return Result()
+
+    function = functions.get( title )
+
+    if title in assumed:
+        return Result( assumed[ title ], ( title, ) )
+
+    if function is None or function.frame is None:
+        return Result( 0, ( title, ), unknown = ( title, ) )
+
+    active.add( title )
+    worst = Result()
+    unknown, indirect, recursive, dynamic = set(), set(), set(), set()
+
+    if function.dynamic:
+        dynamic.add( title )
+
+    for callee in sorted( function.calls ):
+        if callee == INDIRECT:
+            indirect.add( title )
+            continue
+
+        if callee in active:
+            recursive.add( callee )
+            continue
+
+        below = deepest( functions, callee, assumed, active, memo )
+        unknown |= below.unknown
+        indirect |= below.indirect
+        recursive |= below.recursive
+        dynamic |= below.dynamic
+
+        if below.depth > worst.depth or not worst.path:
+            worst = below
+
+    active.discard( title )
+    result = Result( function.frame + worst.depth, ( title, ) + worst.path, unknown, indirect, recursive, dynamic )
+
+    # A result that depends on a cycle still open above it would be wrong for
+    # other callers, so only remember complete ones.
+    if not ( recursive & active ):
+        memo[ title ] = result
+
+    return result
+
+
+def parse_pairs( values, what, convert ):
+    pairs = {}
+
+    for value in values:
+        name, _, rest = value.partition( "=" )
+
+        if not name or not rest:
+            raise ValueError( "%s must be NAME=VALUE, not '%s'" % ( what, value ) )
+
+        pairs.setdefault( name, [] ).extend( convert( v ) for v in rest.split( "," ) )
+
+    return pairs
+
+
+def main():
+    parser = argparse.ArgumentParser( description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter )
+    parser.add_argument( "directory", help = "directory holding the .ci and .i files" )
+    parser.add_argument( "--portmacro", default = "../../Source/portable/GCC/ARM_CM3/portmacro.h" )
+    parser.add_argument( "--word-size", type = int, default = 4, help = "bytes in a StackType_t" )
+    parser.add_argument( "--assume", action = "append", default = [], help = "FUNCTION=BYTES used by a function with no call graph" )
+    parser.add_argument( "--call", action = "append", default = [], help = "FUNCTION=TARGET[,TARGET] called through a pointer" )
+    parser.add_argument( "--paths", action = "store_true", help = "print the deepest call path of each task" )
+    args = parser.parse_args()
+
+    try:
+        functions = load_callgraphs( args.directory )
+        context = read_context_words( args.portmacro ) * args.word_size
+        assumed = { name: max( sizes ) for name, sizes in parse_pairs( args.assume, "--assume", int ).items() }
+        extra = parse_pairs( args.call, "--call", str )
+    except ( OSError, ValueError ) as e:
+        print( "stackcheck: %s" % e, file = sys.stderr )
+        return 2
+
+    for caller, targets in extra.items():
+        caller = resolve( functions, caller ) or caller
+
+        for target in targets:
+            functions.setdefault( caller, Function( caller, "" ) ).calls.add( resolve( functions, target ) or target )
+
+    found = find_tasks( args.directory )
+    tasks = created_tasks( functions, found )
+    ok = True
+
+    print( "Context: %d bytes per task (portTASK_CONTEXT_STACK_WORDS)" % context )
+    print()
+    print( "  %-12s %-24s %7s %7s %7s %6s  %s" % ( "TASK", "ENTRY", "STACK", "WORST", "SPARE", "WORDS", "UNCERTAIN" ) )
+
+    for task in tasks:
+        title = resolve( functions, task.entry, task.source )
+        result = deepest( functions, title or task.entry, assumed, set(), {} )
+        worst = result.depth + context
+        words = -( -worst // args.word_size )
+
+        notes = []
+
+        if title is None:
+            notes.append( "entry not found" )
+
+        for label, names in ( ( "unknown", result.unknown ), ( "indirect", result.indirect ),
+                              ( "recursive", result.recursive ), ( "dynamic", result.dynamic ) ):
+            if names:
+                notes.append( "%s: %s" % ( label, " ".join( sorted( n.split( ":" )[ -1 ] for n in names ) ) ) )
+
+        if task.depth is None:
+            stack = spare = "?"
+        else:
+            stack = str( task.depth )
+            spare = str( task.depth - words )
+
+            if words > task.depth:
+                ok = False
+
+        print( "  %-12s %-24s %7s %7d %7s %6d  %s" % ( task.name[ :12 ], task.entry[ :24 ], stack, worst, spare, words, "; ".join( notes ) ) )
+
+        if args.paths:
+            print( "      %s" % " -> ".join( "%s(%s)" % ( n.split( ":" )[ -1 ], functions[ n ].frame if n in functions and functions[ n ].frame is not None else assumed.get( n, "?" ) )
+                                           for n in result.path ) )
+
+    if len( tasks ) < len( found ):
+        print()
+        print( "  %d xTaskCreate() calls are not reached from main() and were left out" % ( len( found ) - len( tasks ) ) )
+
+    print()
+    print( "  STACK and SPARE are in words, WORST in bytes including the context.  WORDS is the" )
+    print( "  smallest stack that holds the worst case, ignoring anything listed as uncertain." )
+
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit( main() )
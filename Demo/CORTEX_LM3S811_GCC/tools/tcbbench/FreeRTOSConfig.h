@@ -0,0 +1,49 @@
+/*
+ * Configuration used only to build the FreeRTOS kernel into tcbbench.  The
+ * options that add members to the TCB follow the LM3S811 demo, so the TCB
+ * measured is the one the demo uses.  configUSE_TCB_HOT_COLD_SPLIT is set on
+ * the command line by the tcbbench rule in the demo Makefile.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION                       1
+#define configUSE_IDLE_HOOK                        0
+#define configUSE_TICK_HOOK                        0
+#define configCPU_CLOCK_HZ                         ( ( unsigned long ) 20000000 )
+#define configTICK_RATE_HZ                         ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE                   ( ( unsigned short ) 64 )
+#define configTOTAL_HEAP_SIZE                      ( ( size_t ) ( 2048 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                    ( 10 )
+#define configUSE_TRACE_FACILITY                   1
+#define configUSE_16_BIT_TICKS                     0
+#define configMAX_PRIORITIES                       ( 5 )
+#define configSUPPORT_DYNAMIC_ALLOCATION           1
+#define configUSE_MALLOC_FAILED_HOOK               0
+#define configCHECK_FOR_STACK_OVERFLOW             1
+#define configUSE_TASK_BUDGETS                     1
+#define configUSE_TIME_TRIGGERED_TASKS             1
+#define configGENERATE_RUN_TIME_STATS              1
+#define configRECORD_JOB_TIMES                     1
+#define configRECORD_WAKEUP_LATENCY                1
+#define configRECORD_CONTEXT_SWITCHES              1
+#define configUSE_TASK_HEAP_ACCOUNTING             1
+#define configRECORD_STACK_HEADROOM                1
+
+/* Cache lines are 64 bytes on most hosts. */
+#define configTCB_CACHE_LINE_SIZE                  64
+
+/* tcbbench advances the run time counter once per context switch. */
+extern unsigned long ulTCBBenchRunTime;
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()           ( ulTCBBenchRunTime )
+
+/* Gives tcbbench access to the TCB, see freertos_tasks_c_additions.h. */
+#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H  1
+
+#define configASSERT( x )                          assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,72 @@
+/*
+ * Included at the end of tasks.c (configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H is
+ * 1), so tcbbench can switch context the way a port does and see which parts
+ * of the TCB a context switch uses.
+ */
+
+#include <stddef.h>
+
+/* Counts the cache lines of xLineSize bytes that a member of pxTCB touches and
+ * no member before it has. */
+#define tcbbenchCOUNT_MEMBER( member )                                                                   \
+    {                                                                                                    \
+        size_t xFirst = ( ( size_t ) pxTCB + offsetof( TCB_t, member ) ) / xLineSize;                    \
+        size_t xLast = ( ( size_t ) pxTCB + offsetof( TCB_t, member ) + sizeof( pxTCB->member ) - 1U ) / xLineSize; \
+        size_t xLine;                                                                                    \
+                                                                                                         \
+        for( xLine = xFirst; xLine <= xLast; xLine++ )                                                   \
+        {                                                                                                \
+            size_t x;                                                                                    \
+                                                                                                         \
+            for( x = 0; ( x < uxLines ) && ( xLines[ x ] != xLine ); x++ )                               \
+            {                                                                                            \
+            }                                                                                            \
+                                                                                                         \
+            if( x == uxLines )                                                                           \
+            {                                                                                            \
+                xLines[ uxLines++ ] = xLine;                                                             \
+            }                                                                                            \
+        }                                                                                                \
+    }
+
+/* Stands in for a port's context switch: save the stack pointer of the task
+ * being switched out, select the next task and load its stack pointer. */
+void vTCBBenchSwitchContext( void )
+{
+    volatile StackType_t * pxSaved = pxCurrentTCB->pxTopOfStack;
+
+    pxCurrentTCB->pxTopOfStack = pxSaved;
+    vTaskSwitchContext();
+    pxSaved = pxCurrentTCB->pxTopOfStack;
+    ( void ) pxSaved;
+}
+
+/* Returns the number of cache lines of xLineSize bytes that the members of
+ * xTask's TCB used by every context switch to or from it span. */
+UBaseType_t uxTCBBenchSwitchLines( TaskHandle_t xTask, size_t xLineSize )
+{
+    const TCB_t * pxTCB = xTask;
+    size_t xLines[ 32 ];
+    UBaseType_t uxLines = 0;
+
+    tcbbenchCOUNT_MEMBER( pxTopOfStack );
+    tcbbenchCOUNT_MEMBER( xStateListItem );
+    tcbbenchCOUNT_MEMBER( uxPriority );
+    tcbbenchCOUNT_MEMBER( pxStack );
+    tcbbenchCOUNT_MEMBER( ulRunTimeCounter );
+    tcbbenchCOUNT_MEMBER( ulJobRunTime );
+    tcbbenchCOUNT_MEMBER( ulJobStartTime );
+    tcbbenchCOUNT_MEMBER( uxJobCount );
+    tcbbenchCOUNT_MEMBER( ucJobActive );
+    tcbbenchCOUNT_MEMBER( uxVoluntarySwitches );
+    tcbbenchCOUNT_MEMBER( uxInvoluntarySwitches );
+    tcbbenchCOUNT_MEMBER( ucReadyTimeValid );
+    tcbbenchCOUNT_MEMBER( pxLowestTopOfStack );
+
+    return uxLines;
+}
+
+size_t xTCBBenchTCBSize( void )
+{
+    return sizeof( TCB_t );
+}
@@ -0,0 +1,170 @@
+/*
+ * tcbbench - measures what the TCB layout costs a context switch on the host.
+ *
+ * The kernel is built for the host with the TCB laid out one way or the other
+ * (configUSE_TCB_HOT_COLD_SPLIT, see the tcbbench rule in the demo Makefile).
+ * tcbbench creates a number of tasks at the same priority and then switches
+ * between them round robin, doing what a port's context switch does around
+ * vTaskSwitchContext(), so each switch moves to a TCB that has not been used
+ * since every other task ran.  With enough tasks the TCBs no longer fit in the
+ * data cache and each switch pays for the cache lines of the TCB it uses.
+ *
+ * Printed for the layout built in are the size of the TCB, the average number
+ * of cache lines spanned by the TCB members a context switch uses, and the
+ * fastest of several timed runs in nanoseconds per switch.  The cache line
+ * count depends only on the layout, so it is the same on the target as on the
+ * host; the time is only meaningful on a host with a data cache.
+ *
+ * Usage:
+ *     tcbbench [-n tasks] [-s switches] [-l line size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define benchDEFAULT_TASKS       512
+#define benchDEFAULT_SWITCHES    2000000UL
+#define benchRUNS                5
+
+/* Defined in freertos_tasks_c_additions.h. */
+void vTCBBenchSwitchContext( void );
+UBaseType_t uxTCBBenchSwitchLines( TaskHandle_t xTask,
+                                   size_t xLineSize );
+size_t xTCBBenchTCBSize( void );
+
+unsigned long ulTCBBenchRunTime = 0;
+
+/* The scheduler is never started and the tasks never run. */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    ( void ) pxCode;
+    ( void ) pvParameters;
+
+    return pxTopOfStack - 16;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+}
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask,
+                                    char * pcTaskName )
+{
+    ( void ) xTask;
+    fprintf( stderr, "tcbbench: stack overflow in %s\n", pcTaskName );
+    exit( 1 );
+}
+
+static void prvTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+static double prvNow( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC, &xTime );
+
+    return ( double ) xTime.tv_sec * 1e9 + ( double ) xTime.tv_nsec;
+}
+
+int main( int argc,
+          char ** argv )
+{
+    unsigned long ulTasks = benchDEFAULT_TASKS, ulSwitches = benchDEFAULT_SWITCHES, ul;
+    size_t xLineSize = configTCB_CACHE_LINE_SIZE;
+    TaskHandle_t * pxTasks;
+    double dLines = 0.0, dBest = 0.0;
+    char cName[ 24 ]; /* "T" and the digits of any unsigned long. */
+    int i;
+
+    for( i = 1; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "-n" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulTasks = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ i ], "-s" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulSwitches = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ i ], "-l" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            xLineSize = ( size_t ) strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [-n tasks] [-s switches] [-l line size]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    if( ( ulTasks == 0 ) || ( xLineSize == 0 ) )
+    {
+        fprintf( stderr, "tcbbench: the task count and line size must not be 0\n" );
+        return 2;
+    }
+
+    pxTasks = malloc( ulTasks * sizeof( TaskHandle_t ) );
+
+    if( pxTasks == NULL )
+    {
+        return 1;
+    }
+
+    for( ul = 0; ul < ulTasks; ul++ )
+    {
+        snprintf( cName, sizeof( cName ), "T%lu", ul );
+
+        if( xTaskCreate( prvTask, cName, configMINIMAL_STACK_SIZE, NULL, 1, &( pxTasks[ ul ] ) ) != pdPASS )
+        {
+            fprintf( stderr, "tcbbench: out of heap after %lu tasks\n", ul );
+            return 1;
+        }
+
+        dLines += ( double ) uxTCBBenchSwitchLines( pxTasks[ ul ], xLineSize );
+    }
+
+    for( i = 0; i < benchRUNS; i++ )
+    {
+        double dStart = prvNow(), dTime;
+
+        for( ul = 0; ul < ulSwitches; ul++ )
+        {
+            ulTCBBenchRunTime++;
+            vTCBBenchSwitchContext();
+        }
+
+        dTime = ( prvNow() - dStart ) / ( double ) ulSwitches;
+
+        if( ( i == 0 ) || ( dTime < dBest ) )
+        {
+            dBest = dTime;
+        }
+    }
+
+    printf( "%-8s %5u bytes  %4.2f lines of %u bytes per switch  %6.2f ns per switch  (%lu tasks)\n",
+            ( configUSE_TCB_HOT_COLD_SPLIT == 1 ) ? "split" : "default",
+            ( unsigned ) xTCBBenchTCBSize(),
+            dLines / ( double ) ulTasks,
+            ( unsigned ) xLineSize,
+            dBest,
+            ulTasks );
+
+    free( pxTasks );
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+Viewer for the top report of the demo.
+
+Reads a UART capture taken with mainTOP_OUTPUT set to mainTOP_CSV or
+mainTOP_BINARY in main.c and prints each report as a table of the tasks and
+the interrupt handlers:
+
+    CPU% 2s         the share of the processor since the previous report
+    10s, 60s        the share averaged over the last 10 s and 60 s
+    STACK FREE      the least free stack the task has had, in words
+    VCSW            context switches away from the task since the previous
+                    report after it blocked, suspended or deleted itself
+    ICSW            context switches away from the task while it was still
+                    ready - preempted, time sliced, yielding or held by its
+                    CPU budget
+
+The other report lines in the capture (SCHED, IRQ, CRIT and so on) are text in
+either mode and are skipped.  Binary frames are found by their sync bytes and
+a frame with a bad checksum is dropped.  With --last only the last report is
+printed.
+
+Usage:
+    topview.py uart.log
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+FRAME_REPORT = 1
+FRAME_TASK = 2
+FRAME_ISR = 3
+
+
+class Report:
+    def __init__( self, tick, window, tasks ):
+        self.tick = tick
+        self.window = window
+        self.expected = tasks
+        self.tasks = []
+        self.isr = None
+
+
+def parse_csv( data ):
+    """Return the reports in the TOP, TOPT and TOPI lines of a capture."""
+    reports = []
+
+    # vSendStringToUART() sends a NUL after every string.
+    for line in data.decode( "ascii", errors = "replace" ).replace( "\0", "" ).splitlines():
+        fields = line.strip().split( "," )
+
+        try:
+            if fields[ 0 ] == "TOP" and len( fields ) >= 4:
+                reports.append( Report( *( int( field ) for field in fields[ 1:4 ] ) ) )
+            elif fields[ 0 ] == "TOPT" and len( fields ) >= 8 and reports:
+                reports[ -1 ].tasks.append( ( fields[ 1 ], *( int( field ) for field in fields[ 2:8 ] ) ) )
+            elif fields[ 0 ] == "TOPI" and len( fields ) >= 4 and reports:
+                reports[ -1 ].isr = tuple( int( field ) for field in fields[ 1:4 ] )
+        except ValueError:
+            # A line cut short by the start of the capture.
+            pass
+
+    return reports
+
+
+def parse_binary( data ):
+    """Return the reports in the binary frames of a capture."""
+    reports = []
+    offset = data.find( SYNC )
+
+    while 0 <= offset and offset + 4 <= len( data ):
+        kind, length = data[ offset + 2 ], data[ offset + 3 ]
+        end = offset + 4 + length
+
+        if end >= len( data ):
+            break
+
+        payload = data[ offset + 4:end ]
+
+        if ( kind + length + sum( payload ) + data[ end ] ) & 0xff != 0:
+            # Not a frame, or a damaged one - look for the next sync bytes.
+            offset = data.find( SYNC, offset + 1 )
+            continue
+
+        if kind == FRAME_REPORT and length == 9:
+            reports.append( Report( *struct.unpack( "<IIB", payload ) ) )
+        elif kind == FRAME_TASK and length >= 12 and reports:
+            name = payload[ 12: ].decode( "ascii", errors = "replace" )
+            reports[ -1 ].tasks.append( ( name, *struct.unpack( "<6H", payload[ :12 ] ) ) )
+        elif kind == FRAME_ISR and length == 6 and reports:
+            reports[ -1 ].isr = struct.unpack( "<3H", payload )
+
+        offset = data.find( SYNC, end + 1 )
+
+    return reports
+
+
+def percent( permille ):
+    return "%d.%d%%" % ( permille // 10, permille % 10 )
+
+
+def print_report( report ):
+    missing = report.expected - len( report.tasks )
+
+    print( "tick %d, %d run time counts%s" % ( report.tick, report.window, ", %d tasks missing" % missing if missing > 0 else "" ) )
+    print( "  %-10s %8s %8s %8s %10s %6s %6s" % ( "TASK", "CPU% 2s", "10s", "60s", "STACK FREE", "VCSW", "ICSW" ) )
+
+    for name, cpu, cpu10, cpu60, stack, voluntary, involuntary in sorted( report.tasks, key = lambda task: -task[ 1 ] ):
+        print( "  %-10s %8s %8s %8s %10d %6d %6d" % ( name, percent( cpu ), percent( cpu10 ), percent( cpu60 ), stack, voluntary, involuntary ) )
+
+    if report.isr is not None:
+        print( "  %-10s %8s %8s %8s" % ( "ISR", *( percent( cpu ) for cpu in report.isr ) ) )
+
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser( description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter )
+    parser.add_argument( "logs", nargs = "+", help = "UART captures containing top reports" )
+    parser.add_argument( "--last", action = "store_true", help = "print only the last report of each capture" )
+    args = parser.parse_args()
+
+    for path in args.logs:
+        with open( path, "rb" ) as f:
+            data = f.read()
+
+        reports = parse_binary( data ) or parse_csv( data )
+
+        if not reports:
+            print( "%s: no top reports found - is mainTOP_OUTPUT mainTOP_CSV or mainTOP_BINARY?" % path, file = sys.stderr )
+            return 1
+
+        print( "%s:" % path )
+
+        for report in reports[ -1: ] if args.last else reports:
+            print_report( report )
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit( main() )
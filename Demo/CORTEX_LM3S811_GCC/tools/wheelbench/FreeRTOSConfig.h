@@ -0,0 +1,47 @@
+/*
+ * Configuration used only to build the FreeRTOS kernel and timers.c into
+ * wheelbench.  configUSE_TIMER_WHEEL and configUSE_16_BIT_TICKS are set on the
+ * command line by the wheelbench rule in the demo Makefile.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION                1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 0
+#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 20000000 )
+#define configTICK_RATE_HZ                  ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 64 )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 256 * 1024 ) )
+#define configMAX_TASK_NAME_LEN             ( 10 )
+#define configMAX_PRIORITIES                ( 5 )
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configUSE_MALLOC_FAILED_HOOK        0
+
+#ifndef configUSE_16_BIT_TICKS
+    #define configUSE_16_BIT_TICKS          0
+#endif
+
+/* Start a little before the tick count overflows, so 32-bit ticks overflow
+ * within the run too. */
+#define configINITIAL_TICK_COUNT            ( ( TickType_t ) ( 0UL - 100000UL ) )
+
+/* The list end marker is a full list item, as at -O2 the host compiler's
+ * aliasing rules otherwise break the walks of the timer lists. */
+#define configUSE_MINI_LIST_ITEM            0
+
+#define configUSE_TIMERS                    1
+#define configTIMER_TASK_PRIORITY           ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH            10
+#define configTIMER_TASK_STACK_DEPTH        configMINIMAL_STACK_SIZE
+
+#ifndef configUSE_TIMER_WHEEL
+    #define configUSE_TIMER_WHEEL           1
+#endif
+
+#define configASSERT( x )                   assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,274 @@
+/*
+ * wheelbench - runs a workload of many long software timers on the host and
+ * reports what starting, stopping and expiring them costs, with or without
+ * configUSE_TIMER_WHEEL.
+ *
+ * timers.c is built in so its processing functions can be called directly.
+ * The scheduler is never started.  Instead wheelbench steps the tick count
+ * and, on each tick, processes a random number of timer commands, as the
+ * timer service task does when it receives them, and on a random two ticks in
+ * three runs the task's processing up to the point it would block, so timers
+ * are sometimes processed a tick or two late.  The random choices only depend
+ * on the seed, not on the build.
+ *
+ * Three quarters of the timers are one-shot protocol timeouts of between 200
+ * ticks and 30 seconds, mostly stopped or restarted before they expire, as a
+ * retransmission timer is.  The rest are auto-reload timers of between 10 ticks
+ * and 1 second.  The tick count starts 100000 ticks before it overflows (see
+ * FreeRTOSConfig.h), so the run crosses at least one overflow.
+ *
+ * Printed are the callbacks run, the average time to process a command and to
+ * run the task per callback, in nanoseconds, and a hash of the tick and timer
+ * of every callback.  The times are host times and only compare the builds.
+ * The hash must be the same with and without the wheel; -o writes the count
+ * and hash to a file for the wheelbench rule in the demo Makefile to compare.
+ *
+ * Usage:
+ *     wheelbench [-n timers] [-t ticks] [-o file]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Built in so the timer service task's processing can be run directly. */
+#include "timers.c"
+
+#define benchDEFAULT_TIMERS    500UL
+#define benchMAX_TIMERS        2000UL
+#define benchDEFAULT_TICKS     1000000UL
+
+static TimerHandle_t xTimers[ benchMAX_TIMERS ];
+
+static uint32_t ulRandomState = 0x2545f491UL;
+
+/* The callbacks run and an FNV-1a hash of the tick and timer of each. */
+static unsigned long ulCallbacks = 0;
+static uint32_t ulHash = 2166136261UL;
+
+/* The scheduler is never started and the tasks never run. */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    ( void ) pxCode;
+    ( void ) pvParameters;
+
+    return pxTopOfStack - 16;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+}
+
+static void prvIdleTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+static unsigned long prvTimestamp( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC, &xTime );
+
+    return ( unsigned long ) xTime.tv_sec * 1000000000UL + ( unsigned long ) xTime.tv_nsec;
+}
+
+/* xorshift32, so the workload is the same whatever the C library. */
+static uint32_t prvRandom( void )
+{
+    ulRandomState ^= ulRandomState << 13;
+    ulRandomState ^= ulRandomState >> 17;
+    ulRandomState ^= ulRandomState << 5;
+
+    return ulRandomState;
+}
+
+static void prvHash( uint32_t ulValue )
+{
+    UBaseType_t x;
+
+    for( x = 0; x < 4U; x++ )
+    {
+        ulHash = ( ulHash ^ ( ulValue & 0xffUL ) ) * 16777619UL;
+        ulValue >>= 8;
+    }
+}
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    ulCallbacks++;
+    prvHash( ( uint32_t ) xTaskGetTickCount() );
+    prvHash( ( uint32_t ) ( uintptr_t ) pvTimerGetTimerID( xTimer ) );
+}
+
+/* A period for timer uxIndex: a timeout for the one-shot timers and a polling
+ * period for the auto-reload timers. */
+static TickType_t prvPeriod( UBaseType_t uxIndex )
+{
+    TickType_t xPeriod;
+
+    if( ( uxIndex & 3U ) != 0U )
+    {
+        xPeriod = ( TickType_t ) ( 200UL + ( prvRandom() % 29800UL ) );
+    }
+    else
+    {
+        xPeriod = ( TickType_t ) ( 10UL + ( prvRandom() % 990UL ) );
+    }
+
+    return xPeriod;
+}
+
+/* prvProcessTimerOrBlockTask() up to the point the task would block. */
+static void prvRunTimerTask( void )
+{
+    TickType_t xNextExpireTime, xTimeNow;
+    BaseType_t xListWasEmpty, xTimerListsWereSwitched;
+
+    for( ; ; )
+    {
+        xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+        if( xTimerListsWereSwitched == pdFALSE )
+        {
+            if( ( xListWasEmpty != pdFALSE ) || ( xNextExpireTime > xTimeNow ) )
+            {
+                break;
+            }
+
+            prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+        }
+    }
+}
+
+int main( int argc,
+          char ** argv )
+{
+    unsigned long ulTimers = benchDEFAULT_TIMERS, ulTicks = benchDEFAULT_TICKS;
+    unsigned long ulTick, ulCommands = 0, ulCommandTime = 0, ulTaskTime = 0, ulStart;
+    const char * pcOutput = NULL;
+    FILE * pxFile;
+    TickType_t xTimeNow;
+    UBaseType_t x, uxCommands;
+    uint32_t ulChoice;
+    int i;
+
+    for( i = 1; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "-n" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulTimers = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ i ], "-t" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            ulTicks = strtoul( argv[ ++i ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ i ], "-o" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            pcOutput = argv[ ++i ];
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [-n timers] [-t ticks] [-o file]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    if( ( ulTimers == 0UL ) || ( ulTimers > benchMAX_TIMERS ) )
+    {
+        fprintf( stderr, "wheelbench: the number of timers must be from 1 to %lu\n", benchMAX_TIMERS );
+        return 2;
+    }
+
+    /* A task for the tick to run in, as the timer service task is not
+     * created. */
+    xTaskCreate( prvIdleTask, "Bench", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
+    prvCheckForValidListAndQueue();
+
+    for( x = 0; x < ulTimers; x++ )
+    {
+        xTimers[ x ] = xTimerCreate( "Bench", prvPeriod( x ), ( ( x & 3U ) == 0U ) ? pdTRUE : pdFALSE, ( void * ) ( uintptr_t ) x, prvCallback );
+
+        if( xTimers[ x ] == NULL )
+        {
+            return 1;
+        }
+    }
+
+    for( ulTick = 0; ulTick < ulTicks; ulTick++ )
+    {
+        uxCommands = ( UBaseType_t ) ( prvRandom() % 4UL );
+        xTimeNow = xTaskGetTickCount();
+
+        ulStart = prvTimestamp();
+
+        while( uxCommands > 0U )
+        {
+            x = ( UBaseType_t ) ( prvRandom() % ulTimers );
+            ulChoice = prvRandom() % 10UL;
+
+            if( ulChoice < 5UL )
+            {
+                /* Start or restart, with the command sent up to 2 ticks
+                 * before it is processed. */
+                prvProcessTimerCommand( tmrCOMMAND_RESET, xTimers[ x ], xTimeNow - ( TickType_t ) ( prvRandom() % 3UL ) );
+            }
+            else if( ulChoice < 8UL )
+            {
+                prvProcessTimerCommand( tmrCOMMAND_STOP, xTimers[ x ], 0 );
+            }
+            else
+            {
+                prvProcessTimerCommand( tmrCOMMAND_CHANGE_PERIOD, xTimers[ x ], prvPeriod( x ) );
+            }
+
+            uxCommands--;
+            ulCommands++;
+        }
+
+        ulCommandTime += prvTimestamp() - ulStart;
+
+        if( ( prvRandom() % 3UL ) != 0UL )
+        {
+            ulStart = prvTimestamp();
+            prvRunTimerTask();
+            ulTaskTime += prvTimestamp() - ulStart;
+        }
+
+        ( void ) xTaskIncrementTick();
+    }
+
+    printf( "wheel %d  %2u-bit ticks  %lu timers  %lu callbacks  %7.1f ns/command  %7.1f ns/callback  hash %08lx\n",
+            configUSE_TIMER_WHEEL,
+            ( unsigned ) ( sizeof( TickType_t ) * 8U ),
+            ulTimers,
+            ulCallbacks,
+            ( ulCommands != 0UL ) ? ( double ) ulCommandTime / ( double ) ulCommands : 0.0,
+            ( ulCallbacks != 0UL ) ? ( double ) ulTaskTime / ( double ) ulCallbacks : 0.0,
+            ( unsigned long ) ulHash );
+
+    if( pcOutput != NULL )
+    {
+        pxFile = fopen( pcOutput, "w" );
+
+        if( pxFile == NULL )
+        {
+            fprintf( stderr, "wheelbench: cannot write %s\n", pcOutput );
+            return 1;
+        }
+
+        fprintf( pxFile, "%lu %08lx\n", ulCallbacks, ( unsigned long ) ulHash );
+        fclose( pxFile );
+    }
+
+    return 0;
+}
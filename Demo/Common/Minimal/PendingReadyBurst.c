@@ -0,0 +1,264 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Measures how long xTaskResumeAll() keeps interrupts masked while it moves
+ * tasks from the pending ready list to the ready lists.
+ *
+ * prbNUMBER_OF_WAITERS waiter tasks block on their direct to task
+ * notification.  Periodically the controller task suspends the scheduler and
+ * asks vPendingReadyBurstPeriodicISR(), which must be called from the tick
+ * hook, to notify every waiter from the interrupt.  As the scheduler is
+ * suspended each notified waiter is held in the pending ready list, so when
+ * the controller calls xTaskResumeAll() the whole burst has to be moved to the
+ * ready lists.
+ *
+ * The time the drain holds interrupts masked is measured by mapping the drain
+ * trace macros onto this file, for example in FreeRTOSConfig.h:
+ *
+ * #define traceTASK_RESUME_ALL_DRAIN_START()                vPendingReadyBurstDrainStart()
+ * #define traceTASK_RESUME_ALL_DRAIN_END( uxTasksMoved )    vPendingReadyBurstDrainEnd( uxTasksMoved )
+ *
+ * and ulPendingReadyBurstGetMaxMaskedTime() returns the longest single drain
+ * seen during a burst, in prbGET_TIMESTAMP() units.  Run the test once with
+ * configPENDING_READY_LIST_DRAIN_BATCH set to 0, where the whole burst is
+ * moved in one critical section, and once with a batch size set, to compare
+ * the two.  Timestamps default to the run time stats counter, which needs to
+ * be considerably faster than the tick for the results to be meaningful.
+ * Demo/CORTEX_LM3S811_GCC/tools/prbbench runs the test on the host, for
+ * targets without the RAM for prbNUMBER_OF_WAITERS tasks.
+ *
+ * Each waiter counts its wake ups and the controller checks every waiter ran
+ * once per burst.
+ */
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "PendingReadyBurst.h"
+
+/* The number of tasks readied by each burst. */
+#ifndef prbNUMBER_OF_WAITERS
+    #define prbNUMBER_OF_WAITERS    ( 100 )
+#endif
+
+/* The timer used to time each drain. */
+#ifndef prbGET_TIMESTAMP
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        #define prbGET_TIMESTAMP()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+    #else
+        #error Define prbGET_TIMESTAMP() to return a free running timer value, or set configGENERATE_RUN_TIME_STATS to 1.
+    #endif
+#endif
+
+/* The time between bursts. */
+#define prbBURST_PERIOD          pdMS_TO_TICKS( 250 )
+
+/* The number of loops the controller waits for the interrupt to generate a
+ * burst before reporting an error.  The tick count does not advance while the
+ * scheduler is suspended so a loop count is used rather than a block time. */
+#define prbMAX_ISR_WAIT_LOOPS    ( 0xfffffUL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks readied by each burst.
+ */
+static void prvWaiterTask( void * pvParameters );
+
+/*
+ * The task that triggers each burst and checks the waiters ran.
+ */
+static void prvControllerTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* Handles of the waiter tasks, notified from the interrupt. */
+static TaskHandle_t xWaiters[ prbNUMBER_OF_WAITERS ] = { NULL };
+
+/* The number of times each waiter has run. */
+static volatile uint32_t ulWaiterCycles[ prbNUMBER_OF_WAITERS ] = { 0 };
+
+/* Set by the controller to request a burst, cleared by the interrupt once
+ * every waiter has been notified. */
+static volatile BaseType_t xBurstRequested = pdFALSE;
+
+/* pdTRUE while the controller is resuming the scheduler after a burst. */
+static volatile BaseType_t xDrainingBurst = pdFALSE;
+
+/* Drain timing. */
+static volatile uint32_t ulDrainStartTime = 0, ulMaxMaskedTime = 0;
+
+/* Latched to pdTRUE if a burst is not serviced. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented after each burst is checked. */
+static volatile uint32_t ulBurstCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartPendingReadyBurstTasks( UBaseType_t uxPriority )
+{
+    UBaseType_t x;
+
+    for( x = 0; x < prbNUMBER_OF_WAITERS; x++ )
+    {
+        xTaskCreate( prvWaiterTask, "PRBWait", configMINIMAL_STACK_SIZE, ( void * ) x, uxPriority, &( xWaiters[ x ] ) );
+    }
+
+    /* The controller runs below the waiters so a burst has always been
+     * consumed before the next is generated. */
+    configASSERT( uxPriority > tskIDLE_PRIORITY );
+    xTaskCreate( prvControllerTask, "PRBCtrl", configMINIMAL_STACK_SIZE, NULL, uxPriority - 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void * pvParameters )
+{
+    const UBaseType_t uxIndex = ( UBaseType_t ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        ulWaiterCycles[ uxIndex ]++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    volatile uint32_t ulLoops;
+    UBaseType_t x;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        vTaskDelay( prbBURST_PERIOD );
+
+        /* With the scheduler suspended the interrupt cannot move the waiters
+         * to the ready lists, so they accumulate in the pending ready list.
+         * The tick hook still runs while the scheduler is suspended. */
+        vTaskSuspendAll();
+        {
+            xBurstRequested = pdTRUE;
+
+            for( ulLoops = 0; ( xBurstRequested != pdFALSE ) && ( ulLoops < prbMAX_ISR_WAIT_LOOPS ); ulLoops++ )
+            {
+            }
+
+            xDrainingBurst = pdTRUE;
+        }
+        ( void ) xTaskResumeAll();
+        xDrainingBurst = pdFALSE;
+
+        if( xBurstRequested != pdFALSE )
+        {
+            xBurstRequested = pdFALSE;
+            xErrorDetected = pdTRUE;
+        }
+
+        /* The waiters run at a higher priority so have all run by the time
+         * the controller runs again. */
+        for( x = 0; x < prbNUMBER_OF_WAITERS; x++ )
+        {
+            if( ulWaiterCycles[ x ] != ( ulBurstCycles + 1UL ) )
+            {
+                xErrorDetected = pdTRUE;
+            }
+        }
+
+        ulBurstCycles++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPendingReadyBurstPeriodicISR( void )
+{
+    UBaseType_t x;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if( xBurstRequested != pdFALSE )
+    {
+        for( x = 0; x < prbNUMBER_OF_WAITERS; x++ )
+        {
+            vTaskNotifyGiveFromISR( xWaiters[ x ], &xHigherPriorityTaskWoken );
+        }
+
+        xBurstRequested = pdFALSE;
+
+        /* Called from the tick hook, so no yield is needed - and as the
+         * scheduler is suspended none could occur. */
+        ( void ) xHigherPriorityTaskWoken;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPendingReadyBurstDrainStart( void )
+{
+    ulDrainStartTime = prbGET_TIMESTAMP();
+}
+/*-----------------------------------------------------------*/
+
+void vPendingReadyBurstDrainEnd( UBaseType_t uxTasksMoved )
+{
+    uint32_t ulElapsed;
+
+    /* Only time drains that are part of a burst. */
+    if( ( xDrainingBurst != pdFALSE ) && ( uxTasksMoved != 0 ) )
+    {
+        ulElapsed = prbGET_TIMESTAMP() - ulDrainStartTime;
+
+        if( ulElapsed > ulMaxMaskedTime )
+        {
+            ulMaxMaskedTime = ulElapsed;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPendingReadyBurstGetMaxMaskedTime( void )
+{
+    return ulMaxMaskedTime;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xArePendingReadyBurstTasksStillRunning( void )
+{
+    static uint32_t ulLastBurstCycles = 0;
+    BaseType_t xReturn = pdPASS;
+
+    if( ( ulLastBurstCycles == ulBurstCycles ) || ( xErrorDetected != pdFALSE ) )
+    {
+        xReturn = pdFAIL;
+    }
+
+    ulLastBurstCycles = ulBurstCycles;
+
+    return xReturn;
+}
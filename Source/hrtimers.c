@@ -0,0 +1,532 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hrtimers.h"
+
+/* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e9021 !e961 !e750. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include high resolution timer functionality. */
+#if ( configUSE_HR_TIMERS == 1 )
+
+/* Bit definitions used in the ucStatus member of a timer structure. */
+    #define hrtimerSTATUS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x01 )
+
+/* The definition of the high resolution timers themselves. */
+    typedef struct HRTimerDef_t
+    {
+        ListItem_t xTimerListItem;                     /*<< Standard linked list item as used by all kernel features for event management. */
+        HRTimerCallbackFunction_t pxCallbackFunction;  /*<< The function that will be called when the timer expires. */
+        void * pvTimerID;                              /*<< An ID to identify the timer. */
+        uint32_t ulExpiryTime;                         /*<< The high resolution time at which the timer next expires.  Held here rather than in the list item as TickType_t may be only 16 bits wide. */
+        uint32_t ulPeriod;                             /*<< The reload period, or 0 for a one-shot timer. */
+        uint8_t ucStatus;                              /*<< Holds bits to say if the timer was statically allocated or not. */
+    } HRTimer_t;
+
+/*lint -save -e956 A manual analysis and inspection has been used to determine
+ * which static variables must be declared volatile. */
+
+/* The active timers, sorted by expiry time.  As the 32-bit time base wraps the
+ * list is not sorted by the absolute expiry time but by the expiry time relative
+ * to ulHRTimerBaseTime, which is never later than the earliest expiry time and
+ * is moved forward each time the compare interrupt executes.  Every active
+ * timer expires less than hrtimerMAX_DELAY counts after ulHRTimerBaseTime, so
+ * relative expiry times never wrap. */
+    PRIVILEGED_DATA static List_t xActiveHRTimerList;
+    PRIVILEGED_DATA static uint32_t ulHRTimerBaseTime = 0U;
+    PRIVILEGED_DATA static BaseType_t xHRTimerListInitialised = pdFALSE;
+
+/*lint -restore */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Initialise the active timer list the first time a timer is created.
+ */
+    static void prvCheckForValidList( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called after a high resolution timer has been created to initialise its
+ * members.
+ */
+    static void prvInitialiseNewHRTimer( HRTimerCallbackFunction_t pxCallbackFunction,
+                                         void * const pvTimerID,
+                                         HRTimer_t * pxNewTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Insert pxTimer into the active timer list in expiry time order, after any
+ * timer that expires at the same time.
+ */
+    static void prvInsertHRTimer( HRTimer_t * const pxTimer,
+                                  const uint32_t ulExpiryTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Start, or restart, pxTimer.  Must be called from within a critical section.
+ */
+    static BaseType_t prvStartHRTimer( HRTimer_t * const pxTimer,
+                                       const uint32_t ulDelay,
+                                       const uint32_t ulPeriod ) PRIVILEGED_FUNCTION;
+
+/*
+ * Stop pxTimer.  Must be called from within a critical section.
+ */
+    static void prvStopHRTimer( HRTimer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove an expired timer from the active list, reinsert it if it is periodic,
+ * then call its callback function.
+ */
+    static void prvExpireHRTimer( HRTimer_t * const pxTimer,
+                                  const uint32_t ulTimeNow,
+                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        HRTimerHandle_t xHRTimerCreate( HRTimerCallbackFunction_t pxCallbackFunction,
+                                        void * const pvTimerID )
+        {
+            HRTimer_t * pxNewTimer;
+
+            pxNewTimer = ( HRTimer_t * ) pvPortMalloc( sizeof( HRTimer_t ) );
+
+            if( pxNewTimer != NULL )
+            {
+                pxNewTimer->ucStatus = 0x00;
+                prvInitialiseNewHRTimer( pxCallbackFunction, pvTimerID, pxNewTimer );
+            }
+
+            return pxNewTimer;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        HRTimerHandle_t xHRTimerCreateStatic( HRTimerCallbackFunction_t pxCallbackFunction,
+                                              void * const pvTimerID,
+                                              StaticHRTimer_t * pxTimerBuffer )
+        {
+            HRTimer_t * pxNewTimer;
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticHRTimer_t equals the size of the real
+                 * timer structure. */
+                volatile size_t xSize = sizeof( StaticHRTimer_t );
+                configASSERT( xSize == sizeof( HRTimer_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            /* A pointer to a StaticHRTimer_t structure MUST be provided, use it. */
+            configASSERT( pxTimerBuffer );
+            pxNewTimer = ( HRTimer_t * ) pxTimerBuffer; /*lint !e740 !e9087 StaticHRTimer_t is a pointer to a HRTimer_t, so guaranteed to be aligned and sized correctly (checked by an assert()), so this is safe. */
+
+            if( pxNewTimer != NULL )
+            {
+                pxNewTimer->ucStatus = hrtimerSTATUS_IS_STATICALLY_ALLOCATED;
+                prvInitialiseNewHRTimer( pxCallbackFunction, pvTimerID, pxNewTimer );
+            }
+
+            return pxNewTimer;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewHRTimer( HRTimerCallbackFunction_t pxCallbackFunction,
+                                         void * const pvTimerID,
+                                         HRTimer_t * pxNewTimer )
+    {
+        configASSERT( pxCallbackFunction );
+
+        prvCheckForValidList();
+
+        pxNewTimer->pxCallbackFunction = pxCallbackFunction;
+        pxNewTimer->pvTimerID = pvTimerID;
+        pxNewTimer->ulExpiryTime = 0U;
+        pxNewTimer->ulPeriod = 0U;
+        vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
+        listSET_LIST_ITEM_OWNER( &( pxNewTimer->xTimerListItem ), pxNewTimer );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCheckForValidList( void )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( xHRTimerListInitialised == pdFALSE )
+            {
+                vListInitialise( &xActiveHRTimerList );
+                xHRTimerListInitialised = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInsertHRTimer( HRTimer_t * const pxTimer,
+                                  const uint32_t ulExpiryTime )
+    {
+        ListItem_t * pxIterator;
+        ListItem_t * const pxNewListItem = &( pxTimer->xTimerListItem );
+        ListItem_t * const pxListEnd = ( ListItem_t * ) &( xActiveHRTimerList.xListEnd ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+        const uint32_t ulRelativeExpiryTime = ulExpiryTime - ulHRTimerBaseTime;
+        const HRTimer_t * pxNextTimer;
+
+        pxTimer->ulExpiryTime = ulExpiryTime;
+
+        /* vListInsert() cannot be used as it orders by absolute item value, so
+         * walk the list comparing expiry times relative to ulHRTimerBaseTime
+         * instead. */
+        for( pxIterator = pxListEnd; pxIterator->pxNext != pxListEnd; pxIterator = pxIterator->pxNext )
+        {
+            pxNextTimer = ( const HRTimer_t * ) listGET_LIST_ITEM_OWNER( pxIterator->pxNext );
+
+            if( ( pxNextTimer->ulExpiryTime - ulHRTimerBaseTime ) > ulRelativeExpiryTime )
+            {
+                break;
+            }
+        }
+
+        pxNewListItem->pxNext = pxIterator->pxNext;
+        pxNewListItem->pxNext->pxPrevious = pxNewListItem;
+        pxNewListItem->pxPrevious = pxIterator;
+        pxIterator->pxNext = pxNewListItem;
+        pxNewListItem->pxContainer = &xActiveHRTimerList;
+
+        ( xActiveHRTimerList.uxNumberOfItems )++;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvStartHRTimer( HRTimer_t * const pxTimer,
+                                       const uint32_t ulDelay,
+                                       const uint32_t ulPeriod )
+    {
+        BaseType_t xReturn = pdFAIL;
+        uint32_t ulTimeNow;
+
+        if( ( ulDelay <= hrtimerMAX_DELAY ) && ( ulPeriod <= hrtimerMAX_DELAY ) )
+        {
+            if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+            {
+                ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            ulTimeNow = portHR_TIMER_GET_TIME();
+
+            /* With no timers active the base time can move straight to now.
+             * Otherwise it is left where the last compare interrupt put it,
+             * which is no later than the earliest expiry time. */
+            if( listLIST_IS_EMPTY( &xActiveHRTimerList ) != pdFALSE )
+            {
+                ulHRTimerBaseTime = ulTimeNow;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxTimer->ulPeriod = ulPeriod;
+            prvInsertHRTimer( pxTimer, ulTimeNow + ulDelay );
+
+            /* If the timer is now the first to expire the compare must be moved
+             * earlier.  Otherwise it is already armed for an earlier timer. */
+            if( listGET_OWNER_OF_HEAD_ENTRY( &xActiveHRTimerList ) == pxTimer ) /*lint !e9087 !e9079 void * is used as this macro is used with tasks too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            {
+                portHR_TIMER_SET_COMPARE( ( ulDelay == 0U ) ? 1U : ulDelay );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvStopHRTimer( HRTimer_t * const pxTimer )
+    {
+        if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+        {
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+            /* If other timers are still active the compare is left armed.  If
+             * it was armed for this timer the interrupt will find nothing has
+             * expired and rearm for the next timer. */
+            if( listLIST_IS_EMPTY( &xActiveHRTimerList ) != pdFALSE )
+            {
+                portHR_TIMER_STOP_COMPARE();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xHRTimerStart( HRTimerHandle_t xTimer,
+                              uint32_t ulDelay,
+                              uint32_t ulPeriod )
+    {
+        BaseType_t xReturn;
+        HRTimer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        taskENTER_CRITICAL();
+        {
+            xReturn = prvStartHRTimer( pxTimer, ulDelay, ulPeriod );
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xHRTimerStartFromISR( HRTimerHandle_t xTimer,
+                                     uint32_t ulDelay,
+                                     uint32_t ulPeriod )
+    {
+        BaseType_t xReturn;
+        UBaseType_t uxSavedInterruptStatus;
+        HRTimer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            xReturn = prvStartHRTimer( pxTimer, ulDelay, ulPeriod );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vHRTimerStop( HRTimerHandle_t xTimer )
+    {
+        HRTimer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        taskENTER_CRITICAL();
+        {
+            prvStopHRTimer( pxTimer );
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vHRTimerStopFromISR( HRTimerHandle_t xTimer )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        HRTimer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            prvStopHRTimer( pxTimer );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    void vHRTimerDelete( HRTimerHandle_t xTimer )
+    {
+        HRTimer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        vHRTimerStop( xTimer );
+
+        /* Only free the timer's memory if it was allocated dynamically. */
+        if( ( pxTimer->ucStatus & hrtimerSTATUS_IS_STATICALLY_ALLOCATED ) == 0 )
+        {
+            vPortFree( pxTimer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xHRTimerIsTimerActive( HRTimerHandle_t xTimer )
+    {
+        BaseType_t xReturn;
+        HRTimer_t * pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        taskENTER_CRITICAL();
+        {
+            if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvHRTimerGetTimerID( const HRTimerHandle_t xTimer )
+    {
+        HRTimer_t * const pxTimer = xTimer;
+
+        configASSERT( xTimer );
+
+        return pxTimer->pvTimerID;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulHRTimerGetTime( void )
+    {
+        return portHR_TIMER_GET_TIME();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvExpireHRTimer( HRTimer_t * const pxTimer,
+                                  const uint32_t ulTimeNow,
+                                  BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        uint32_t ulTimeLate;
+
+        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+        if( pxTimer->ulPeriod != 0U )
+        {
+            /* Reload in phase with the original expiry time.  If the interrupt
+             * was held off for longer than a period the missed expiries are
+             * skipped rather than the callback being called several times in a
+             * row. */
+            ulTimeLate = ulTimeNow - pxTimer->ulExpiryTime;
+            prvInsertHRTimer( pxTimer, ulTimeNow + ( pxTimer->ulPeriod - ( ulTimeLate % pxTimer->ulPeriod ) ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxTimer->pxCallbackFunction( pxTimer, pxHigherPriorityTaskWoken );
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xHRTimerInterruptHandler( void )
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        UBaseType_t uxSavedInterruptStatus;
+        HRTimer_t * pxTimer;
+        uint32_t ulTimeNow;
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            for( ; ; )
+            {
+                /* Sample the time on each iteration so timers that expire while
+                 * callbacks are executing are processed now rather than after
+                 * another interrupt. */
+                ulTimeNow = portHR_TIMER_GET_TIME();
+
+                if( listLIST_IS_EMPTY( &xActiveHRTimerList ) != pdFALSE )
+                {
+                    portHR_TIMER_STOP_COMPARE();
+                    break;
+                }
+
+                pxTimer = listGET_OWNER_OF_HEAD_ENTRY( &xActiveHRTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                if( ( pxTimer->ulExpiryTime - ulHRTimerBaseTime ) > ( ulTimeNow - ulHRTimerBaseTime ) )
+                {
+                    /* The earliest timer has not expired.  Every remaining timer
+                     * expires after now so the base time can move up to now,
+                     * then arm the compare for the earliest timer. */
+                    ulHRTimerBaseTime = ulTimeNow;
+                    portHR_TIMER_SET_COMPARE( pxTimer->ulExpiryTime - ulTimeNow );
+                    break;
+                }
+
+                prvExpireHRTimer( pxTimer, ulTimeNow, &xHigherPriorityTaskWoken );
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        return xHigherPriorityTaskWoken;
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include high resolution timer functionality.  This #if is closed at the
+ * very bottom of this file.  If you want to include high resolution timers
+ * then ensure configUSE_HR_TIMERS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_HR_TIMERS == 1 */
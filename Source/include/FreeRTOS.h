@@ -355,6 +355,34 @@
 
 #endif /* configUSE_TIMERS */
 
+#ifndef configUSE_TIMER_WHEEL
+
+/* Set to 1 to hold the active software timers in a hierarchical timing wheel,
+ * rather than in the list sorted by expiry time, so starting, resetting and
+ * stopping a timer, and finding and removing the next timer to expire, take a
+ * time that does not depend on the number of active timers or how far ahead
+ * they expire.  A timer that expires more than configTIMER_WHEEL_SLOTS ticks
+ * ahead is moved down the wheel as its expiry time approaches, which can wake
+ * the timer service task without a timer expiring - at most once per level of
+ * the wheel for each timer.  The timers that expire after the tick count next
+ * overflows are moved into the wheel when it overflows. */
+    #define configUSE_TIMER_WHEEL    0
+#endif
+
+#ifndef configTIMER_WHEEL_SLOTS
+
+/* The number of slots in each level of the timing wheel.  Must be a power of 2
+ * from 4 to 256.  The wheel has enough levels for the slots to cover every bit
+ * of TickType_t, so with 16 slots and 32-bit ticks it has 8 levels.  Each slot
+ * costs a List_t and one bit.  More slots mean fewer levels, so fewer moves
+ * down the wheel, but more RAM. */
+    #define configTIMER_WHEEL_SLOTS    16
+#endif
+
+#if ( ( configUSE_TIMER_WHEEL == 1 ) && ( ( configTIMER_WHEEL_SLOTS & ( configTIMER_WHEEL_SLOTS - 1 ) ) != 0 ) )
+    #error configTIMER_WHEEL_SLOTS must be a power of 2.
+#endif
+
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
     #define portSET_INTERRUPT_MASK_FROM_ISR()    0
 #endif
@@ -643,6 +671,29 @@
     #define traceTASK_INCREMENT_TICK( xTickCount )
 #endif
 
+#ifndef traceTASK_RESUME_ALL_DRAIN_START
+
+/* Called inside the critical section in which xTaskResumeAll() moves tasks
+ * from the pending ready list to the ready lists. */
+    #define traceTASK_RESUME_ALL_DRAIN_START()
+#endif
+
+#ifndef traceTASK_RESUME_ALL_DRAIN_END
+
+/* Called before leaving the critical section opened after
+ * traceTASK_RESUME_ALL_DRAIN_START().  uxTasksMoved is the number of tasks moved
+ * in the critical section. */
+    #define traceTASK_RESUME_ALL_DRAIN_END( uxTasksMoved )
+#endif
+
+#ifndef traceTASK_BUDGET_EXHAUSTED
+    #define traceTASK_BUDGET_EXHAUSTED( pxTCB )
+#endif
+
+#ifndef traceTASK_RELEASE_OVERRUN
+    #define traceTASK_RELEASE_OVERRUN( pxTCB )
+#endif
+
 #ifndef traceTIMER_CREATE
     #define traceTIMER_CREATE( pxNewTimer )
 #endif
@@ -659,6 +710,10 @@
     #define traceTIMER_EXPIRED( pxTimer )
 #endif
 
+#ifndef traceTIMER_HARD_CALLBACK_OVERRUN
+    #define traceTIMER_HARD_CALLBACK_OVERRUN( pxTimer, ulCallbackTime )
+#endif
+
 #ifndef traceTIMER_COMMAND_RECEIVED
     #define traceTIMER_COMMAND_RECEIVED( pxTimer, xMessageID, xMessageValue )
 #endif
@@ -807,6 +862,38 @@
     #define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceHEAP_QUOTA_EXCEEDED
+    #define traceHEAP_QUOTA_EXCEEDED( xWantedSize )
+#endif
+
+#ifndef traceMEMORY_POOL_CREATE
+    #define traceMEMORY_POOL_CREATE( pxPool )
+#endif
+
+#ifndef traceMEMORY_POOL_DELETE
+    #define traceMEMORY_POOL_DELETE( pxPool )
+#endif
+
+#ifndef traceBLOCKING_ON_MEMORY_POOL
+    #define traceBLOCKING_ON_MEMORY_POOL( pxPool )
+#endif
+
+#ifndef traceMEMORY_POOL_ALLOC
+    #define traceMEMORY_POOL_ALLOC( pxPool, pvBlock )
+#endif
+
+#ifndef traceMEMORY_POOL_ALLOC_FROM_ISR
+    #define traceMEMORY_POOL_ALLOC_FROM_ISR( pxPool, pvBlock )
+#endif
+
+#ifndef traceMEMORY_POOL_FREE
+    #define traceMEMORY_POOL_FREE( pxPool, pvBlock )
+#endif
+
+#ifndef traceMEMORY_POOL_FREE_FROM_ISR
+    #define traceMEMORY_POOL_FREE_FROM_ISR( pxPool, pvBlock )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
     #define configGENERATE_RUN_TIME_STATS    0
 #endif
@@ -941,6 +1028,294 @@
     #define configUSE_POSIX_ERRNO    0
 #endif
 
+#ifndef configUSE_TASK_BUDGETS
+    #define configUSE_TASK_BUDGETS    0
+#endif
+
+#if ( ( configUSE_TASK_BUDGETS == 1 ) && ( configUSE_PREEMPTION == 0 ) )
+    #error configUSE_TASK_BUDGETS requires configUSE_PREEMPTION to be set to 1 as budgets are enforced from the tick interrupt.
+#endif
+
+#ifndef configUSE_TASK_HEAP_ACCOUNTING
+
+/* Set to 1 to have heap_4.c and heap_5.c record which task allocated each
+ * block, so the heap used by each task is reported in TaskStatus_t and can be
+ * limited with vTaskSetHeapQuota(). */
+    #define configUSE_TASK_HEAP_ACCOUNTING    0
+#endif
+
+#ifndef configUSE_HEAP_TRACE
+
+/* Set to 1 to have heap_2.c, heap_4.c and heap_5.c record each allocation and
+ * free in the ring buffer implemented by heap_trace.c. */
+    #define configUSE_HEAP_TRACE    0
+#endif
+
+#ifndef configHEAP_TRACE_BUFFER_LENGTH
+    #define configHEAP_TRACE_BUFFER_LENGTH    32
+#endif
+
+#ifndef configRECORD_STACK_HEADROOM
+
+/* Set to 1 to have each context switch record the deepest stack pointer saved
+ * for the task, at the cost of one compare per switch, and to make the
+ * constant time uxTaskGetStackHeadroom() available. */
+    #define configRECORD_STACK_HEADROOM    0
+#endif
+
+#ifndef configUSE_TCB_HOT_COLD_SPLIT
+
+/* Set to 1 to start the TCB members that are not used on each context switch
+ * and tick on a new cache line, and to align each TCB to a cache line, so the
+ * members that are used share as few cache lines as possible.  Only worth
+ * doing on cores with a data cache. */
+    #define configUSE_TCB_HOT_COLD_SPLIT    0
+#endif
+
+#ifndef configTCB_CACHE_LINE_SIZE
+    #define configTCB_CACHE_LINE_SIZE    32
+#endif
+
+#if ( configUSE_TCB_HOT_COLD_SPLIT == 1 )
+    #ifndef portCACHE_LINE_ALIGNED
+        #ifdef __GNUC__
+            #define portCACHE_LINE_ALIGNED    __attribute__( ( aligned( configTCB_CACHE_LINE_SIZE ) ) )
+        #else
+            #error Missing definition:  portCACHE_LINE_ALIGNED must be defined to align a structure member to configTCB_CACHE_LINE_SIZE bytes when configUSE_TCB_HOT_COLD_SPLIT is set to 1.
+        #endif
+    #endif
+#endif
+
+#ifndef configUSE_FAST_HEAP_REGION_FOR_TASKS
+
+/* Set to 1 to allocate task stacks and TCBs from the heap_5.c regions marked
+ * heapREGION_FAST, which shortens context switches on parts with tightly
+ * coupled memory.  Requires heap_5.c. */
+    #define configUSE_FAST_HEAP_REGION_FOR_TASKS    0
+#endif
+
+#ifndef portHEAP_TRACE_CALLER
+
+/* Returns the return address of the function it is used in, which the heap
+ * trace records as the call site of pvPortMalloc() and vPortFree(). */
+    #if defined( __GNUC__ )
+        #define portHEAP_TRACE_CALLER()    __builtin_return_address( 0 )
+    #else
+        #define portHEAP_TRACE_CALLER()    NULL
+    #endif
+#endif
+
+#ifndef configRECORD_CRITICAL_SECTION_TIMES
+
+/* Set to 1 to have the port time each outermost critical section, and the
+ * kernel each outermost scheduler suspension, and keep the longest of each
+ * with the call site that entered it in the tables implemented by
+ * portable/Common/critical_profile.c. */
+    #define configRECORD_CRITICAL_SECTION_TIMES    0
+#endif
+
+#ifndef configCRITICAL_SECTION_TOP_COUNT
+
+/* The number of call sites kept for each kind of region, longest first. */
+    #define configCRITICAL_SECTION_TOP_COUNT    10
+#endif
+
+#ifndef configCRITICAL_SECTION_BUCKETS
+
+/* Bucket 0 counts regions that took no time, bucket n those that took
+ * [ 2^(n-1), 2^n ) timer counts, and the last bucket also counts everything
+ * above that. */
+    #define configCRITICAL_SECTION_BUCKETS    16
+#endif
+
+#if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+    #ifndef portCRITICAL_SECTION_TIMER_VALUE
+        #error Missing definition:  portCRITICAL_SECTION_TIMER_VALUE() must return a free running 32-bit count, ideally of processor cycles, when configRECORD_CRITICAL_SECTION_TIMES is set to 1.
+    #endif
+
+    #ifndef portCRITICAL_SECTION_CALLER
+
+/* Returns the return address of the function it is used in, which is recorded
+ * as the call site that entered a critical section or suspended the
+ * scheduler. */
+        #if defined( __GNUC__ )
+            #define portCRITICAL_SECTION_CALLER()    __builtin_return_address( 0 )
+        #else
+            #define portCRITICAL_SECTION_CALLER()    NULL
+        #endif
+    #endif
+#endif
+
+#ifndef configUSE_TIME_TRIGGERED_TASKS
+    #define configUSE_TIME_TRIGGERED_TASKS    0
+#endif
+
+#ifndef configRECORD_JOB_TIMES
+    #define configRECORD_JOB_TIMES    0
+#endif
+
+#if ( ( configRECORD_JOB_TIMES == 1 ) && ( configGENERATE_RUN_TIME_STATS == 0 ) )
+    #error configRECORD_JOB_TIMES requires configGENERATE_RUN_TIME_STATS to be set to 1 as jobs are timed with the run time stats counter.
+#endif
+
+#ifndef configRECORD_CONTEXT_SWITCHES
+
+/* Set to 1 to count, for each task, the context switches away from it that it
+ * caused by leaving the Ready state, and those it did not, such as being
+ * preempted. */
+    #define configRECORD_CONTEXT_SWITCHES    0
+#endif
+
+#ifndef configUSE_TASK_ITERATOR
+
+/* Set to 1 to include vTaskIteratorStart() and xTaskIteratorNext(), which
+ * report the tasks one at a time instead of all at once like
+ * uxTaskGetSystemState().  Adds two pointers to each TCB. */
+    #define configUSE_TASK_ITERATOR    0
+#endif
+
+#if ( ( configUSE_TASK_ITERATOR == 1 ) && ( configUSE_TRACE_FACILITY != 1 ) )
+    #error configUSE_TASK_ITERATOR requires configUSE_TRACE_FACILITY to be set to 1 as the iterator fills in TaskStatus_t structures.
+#endif
+
+#ifndef configUSE_HARD_TIMERS
+
+/* Set to 1 to allow software timers to be made hard timers with
+ * vTimerSetHard().  The callback of a hard timer is called from the tick
+ * interrupt rather than from the timer service task. */
+    #define configUSE_HARD_TIMERS    0
+#endif
+
+#if ( ( configUSE_HARD_TIMERS == 1 ) && ( configUSE_TIMERS == 0 ) )
+    #error configUSE_HARD_TIMERS requires configUSE_TIMERS to be set to 1.
+#endif
+
+#ifndef configHARD_TIMER_MAX_CALLBACK_TIME
+
+/* The longest a hard timer callback may execute for, in
+ * configHARD_TIMER_GET_TIME() units.  A hard timer whose callback takes longer
+ * is stopped.  0 disables the check. */
+    #define configHARD_TIMER_MAX_CALLBACK_TIME    0
+#endif
+
+#if ( ( configUSE_HARD_TIMERS == 1 ) && ( configHARD_TIMER_MAX_CALLBACK_TIME > 0 ) && !defined( configHARD_TIMER_GET_TIME ) )
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        #define configHARD_TIMER_GET_TIME()    portGET_RUN_TIME_COUNTER_VALUE()
+    #else
+        #error Define configHARD_TIMER_GET_TIME() to return a free running timer value, or set configGENERATE_RUN_TIME_STATS to 1, to check hard timer callback execution times.
+    #endif
+#endif
+
+#ifndef configUSE_TIMER_SLACK
+
+/* Set to 1 to allow a slack time to be set on software timers with
+ * xTimerSetSlack().  The timer service task then wakes once for all the
+ * timers whose slack windows overlap rather than once per timer. */
+    #define configUSE_TIMER_SLACK    0
+#endif
+
+#if ( ( configUSE_TIMER_SLACK == 1 ) && ( configUSE_TIMER_WHEEL == 1 ) )
+    #error configUSE_TIMER_SLACK cannot be used with configUSE_TIMER_WHEEL as slack windows are found by walking the active timers in expiry order.
+#endif
+
+#ifndef configUSE_TIMER_BATCH_COMMANDS
+
+/* Set to 1 to include xTimerSendCommandBatch(), which sends any number of timer
+ * commands to the timer service task in one message. */
+    #define configUSE_TIMER_BATCH_COMMANDS    0
+#endif
+
+#if ( configUSE_TIMER_BATCH_COMMANDS == 1 )
+    #if ( configUSE_TIMERS == 0 )
+        #error configUSE_TIMER_BATCH_COMMANDS requires configUSE_TIMERS to be set to 1.
+    #endif
+
+    #if ( configUSE_TASK_NOTIFICATIONS == 0 )
+        #error configUSE_TIMER_BATCH_COMMANDS requires configUSE_TASK_NOTIFICATIONS to be set to 1 as the timer service task notifies the sender when a batch is complete.
+    #endif
+
+    #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 0 ) && ( configUSE_MUTEXES == 0 ) )
+        #error configUSE_TIMER_BATCH_COMMANDS requires INCLUDE_xTaskGetCurrentTaskHandle or configUSE_MUTEXES to be set to 1.
+    #endif
+#endif
+
+#ifndef configTIMER_BATCH_NOTIFICATION_INDEX
+
+/* The task notification index the timer service task uses to tell a task its
+ * command batch is complete. */
+    #define configTIMER_BATCH_NOTIFICATION_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#ifndef configUSE_HR_TIMERS
+
+/* Set to 1 to include the high resolution timer API in hrtimers.c.  High
+ * resolution timers expire at the resolution of a port supplied hardware
+ * compare channel rather than at the resolution of the tick. */
+    #define configUSE_HR_TIMERS    0
+#endif
+
+#if ( configUSE_HR_TIMERS == 1 )
+    #ifndef configHR_TIMER_FREQUENCY_HZ
+        #error configHR_TIMER_FREQUENCY_HZ must be set to the frequency of the high resolution timer time base when configUSE_HR_TIMERS is set to 1.
+    #endif
+
+    #ifndef portHR_TIMER_GET_TIME
+        #error portHR_TIMER_GET_TIME() must return the value of a free running 32-bit up counter when configUSE_HR_TIMERS is set to 1.
+    #endif
+
+    #ifndef portHR_TIMER_SET_COMPARE
+        #error portHR_TIMER_SET_COMPARE( ulDelay ) must arm the high resolution timer interrupt to fire ulDelay counts from now when configUSE_HR_TIMERS is set to 1.
+    #endif
+
+    #ifndef portHR_TIMER_STOP_COMPARE
+        #error portHR_TIMER_STOP_COMPARE() must disarm the high resolution timer interrupt when configUSE_HR_TIMERS is set to 1.
+    #endif
+#endif
+
+#ifndef configUSE_MEMORY_POOLS
+
+/* Set to 1 to include the fixed size block memory pool API in mempool.c. */
+    #define configUSE_MEMORY_POOLS    0
+#endif
+
+#ifndef configPENDING_READY_LIST_DRAIN_BATCH
+
+/* When greater than 0, xTaskResumeAll() moves tasks from the pending ready list
+ * to the ready lists at most this many at a time, leaving the critical section
+ * between batches, so the time interrupts are masked does not grow with the
+ * number of tasks readied while the scheduler was suspended.  0 moves all the
+ * tasks in one critical section. */
+    #define configPENDING_READY_LIST_DRAIN_BATCH    0
+#endif
+
+#ifndef configRECORD_WAKEUP_LATENCY
+    #define configRECORD_WAKEUP_LATENCY    0
+#endif
+
+#if ( ( configRECORD_WAKEUP_LATENCY == 1 ) && ( configGENERATE_RUN_TIME_STATS == 0 ) )
+    #error configRECORD_WAKEUP_LATENCY requires configGENERATE_RUN_TIME_STATS to be set to 1 as latencies are measured with the run time stats counter.
+#endif
+
+#ifndef configWAKEUP_LATENCY_BUCKETS
+
+/* Bucket 0 counts zero latencies, bucket n counts latencies in the range
+ * [ 2^(n-1), 2^n ) run time counter units, and the last bucket also counts
+ * everything above that. */
+    #define configWAKEUP_LATENCY_BUCKETS    12
+#endif
+
+#ifndef configRECORD_INTERRUPT_RUN_TIME
+
+/* Set to 1 to have the run time of interrupt handlers, reported by the
+ * application with vTaskAddInterruptRunTime(), taken off the run time of the
+ * tasks they interrupted. */
+    #define configRECORD_INTERRUPT_RUN_TIME    0
+#endif
+
+#if ( ( configRECORD_INTERRUPT_RUN_TIME == 1 ) && ( configGENERATE_RUN_TIME_STATS == 0 ) )
+    #error configRECORD_INTERRUPT_RUN_TIME requires configGENERATE_RUN_TIME_STATS to be set to 1 as interrupt time is taken off the run time stats of the tasks.
+#endif
+
 #ifndef configUSE_SB_COMPLETED_CALLBACK
 
 /* By default per-instance callbacks are not enabled for stream buffer or message buffer. */
@@ -1262,16 +1637,57 @@ typedef struct xSTATIC_TCB
     StaticListItem_t xDummy3[ 2 ];
     UBaseType_t uxDummy5;
     void * pxDummy6;
-    uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ];
+    #if ( configUSE_TCB_HOT_COLD_SPLIT == 0 )
+        uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ];
+    #endif
     #if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
         void * pxDummy8;
     #endif
     #if ( portCRITICAL_NESTING_IN_TCB == 1 )
         UBaseType_t uxDummy9;
     #endif
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulDummy16;
+    #endif
+    #if ( configUSE_POSIX_ERRNO == 1 )
+        int iDummy22;
+    #endif
+    #if ( configRECORD_JOB_TIMES == 1 )
+        configRUN_TIME_COUNTER_TYPE ulDummy28[ 4 ];
+        UBaseType_t uxDummy29;
+        uint8_t ucDummy30;
+    #endif
+    #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+        UBaseType_t uxDummy36[ 2 ];
+    #endif
+    #if ( configRECORD_STACK_HEADROOM == 1 )
+        void * pxDummy35;
+    #endif
+    #if ( configRECORD_WAKEUP_LATENCY == 1 )
+        configRUN_TIME_COUNTER_TYPE ulDummy31[ 2 ];
+        uint8_t ucDummy33;
+        uint16_t usDummy32[ configWAKEUP_LATENCY_BUCKETS ];
+    #endif
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        TickType_t xDummy23[ 4 ];
+        UBaseType_t uxDummy24;
+        uint8_t ucDummy38;
+    #endif
+    #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+        TickType_t xDummy25;
+        StaticListItem_t xDummy39;
+        UBaseType_t uxDummy26;
+        uint8_t ucDummy27;
+    #endif
+    #if ( configUSE_TCB_HOT_COLD_SPLIT == 1 )
+        uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ] portCACHE_LINE_ALIGNED;
+    #endif
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy10[ 2 ];
     #endif
+    #if ( configUSE_TASK_ITERATOR == 1 )
+        void * pxDummy37[ 2 ];
+    #endif
     #if ( configUSE_MUTEXES == 1 )
         UBaseType_t uxDummy12[ 2 ];
     #endif
@@ -1281,9 +1697,6 @@ typedef struct xSTATIC_TCB
     #if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
         void * pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
     #endif
-    #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        configRUN_TIME_COUNTER_TYPE ulDummy16;
-    #endif
     #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
         configTLS_BLOCK_TYPE xDummy17;
     #endif
@@ -1294,12 +1707,11 @@ typedef struct xSTATIC_TCB
     #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
         uint8_t uxDummy20;
     #endif
-
     #if ( INCLUDE_xTaskAbortDelay == 1 )
         uint8_t ucDummy21;
     #endif
-    #if ( configUSE_POSIX_ERRNO == 1 )
-        int iDummy22;
+    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        size_t xDummy34[ 3 ];
     #endif
 } StaticTask_t;
 
@@ -1398,9 +1810,45 @@ typedef struct xSTATIC_TIMER
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy7;
     #endif
+    #if ( configUSE_TIMER_SLACK == 1 )
+        TickType_t xDummy9;
+    #endif
     uint8_t ucDummy8;
 } StaticTimer_t;
 
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the real structure used by high resolution timers is
+ * not accessible to the application.  The structure below is the same size and
+ * alignment as the real structure so can be used to statically allocate a high
+ * resolution timer with xHRTimerCreateStatic().
+ */
+typedef struct xSTATIC_HR_TIMER
+{
+    StaticListItem_t xDummy1;
+    TaskFunction_t pvDummy2;
+    void * pvDummy3;
+    uint32_t ulDummy4[ 2 ];
+    uint8_t ucDummy5;
+} StaticHRTimer_t;
+
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the real structure used by memory pools is not
+ * accessible to the application.  The structure below is the same size and
+ * alignment as the real structure so can be used to statically allocate a
+ * memory pool with xPoolCreateStatic().
+ */
+typedef struct xSTATIC_POOL
+{
+    void * pvDummy1[ 2 ];
+    size_t xDummy2;
+    UBaseType_t uxDummy3[ 3 ];
+    StaticList_t xDummy4;
+    uint32_t ulDummy5[ 4 ];
+    uint8_t ucDummy6;
+} StaticPool_t;
+
 /*
  * In line with software engineering best practice, especially when supplying a
  * library that is likely to change in future versions, FreeRTOS implements a
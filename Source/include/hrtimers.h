@@ -0,0 +1,217 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef HR_TIMERS_H
+#define HR_TIMERS_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include hrtimers.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*-----------------------------------------------------------
+* MACROS AND DEFINITIONS
+*----------------------------------------------------------*/
+
+/**
+ * Converts a time in microseconds to a time in high resolution timer counts.
+ */
+#define pdUS_TO_HR_TICKS( xTimeInUs )    ( ( uint32_t ) ( ( ( uint64_t ) ( xTimeInUs ) * ( uint64_t ) configHR_TIMER_FREQUENCY_HZ ) / ( uint64_t ) 1000000U ) )
+
+/**
+ * The longest delay or period a high resolution timer can be started with.
+ * Expiry times are compared relative to each other, so must lie within half
+ * the range of the 32-bit time base of each other.
+ */
+#define hrtimerMAX_DELAY    ( ( uint32_t ) 0x7fffffffUL )
+
+/**
+ * Type by which high resolution timers are referenced.
+ */
+struct HRTimerDef_t;
+typedef struct HRTimerDef_t * HRTimerHandle_t;
+
+/*
+ * Defines the prototype to which high resolution timer callback functions must
+ * conform.  Callbacks execute in the context of the high resolution timer
+ * interrupt, so can only call interrupt safe API functions, and should set
+ * *pxHigherPriorityTaskWoken to pdTRUE if they unblock a task that has a
+ * priority above the interrupted task.
+ */
+typedef void (* HRTimerCallbackFunction_t)( HRTimerHandle_t xTimer,
+                                            BaseType_t * pxHigherPriorityTaskWoken );
+
+/*-----------------------------------------------------------
+* HIGH RESOLUTION TIMER API
+*----------------------------------------------------------*/
+
+/**
+ * HRTimerHandle_t xHRTimerCreate( HRTimerCallbackFunction_t pxCallbackFunction,
+ *                                 void * pvTimerID );
+ *
+ * Creates a high resolution timer and returns a handle by which it can be
+ * referenced, or NULL if there was insufficient heap to create it.  The timer
+ * is created dormant.  Use xHRTimerStart() to start it.
+ *
+ * Unlike the software timers in timers.h, high resolution timers are not
+ * driven by the tick.  Active timers are held in a list sorted by expiry time,
+ * and a one-shot hardware compare is armed for the earliest expiry through the
+ * portHR_TIMER_SET_COMPARE() port hook, so timers expire with the resolution
+ * of the hardware time base (configHR_TIMER_FREQUENCY_HZ) without increasing
+ * configTICK_RATE_HZ.  The port's compare interrupt handler must call
+ * xHRTimerInterruptHandler().
+ *
+ * @param pxCallbackFunction The function to call, from the high resolution
+ * timer interrupt, when the timer expires.
+ *
+ * @param pvTimerID An identifier assigned to the timer, retrieved with
+ * pvHRTimerGetTimerID().
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    HRTimerHandle_t xHRTimerCreate( HRTimerCallbackFunction_t pxCallbackFunction,
+                                    void * const pvTimerID ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * HRTimerHandle_t xHRTimerCreateStatic( HRTimerCallbackFunction_t pxCallbackFunction,
+ *                                       void * pvTimerID,
+ *                                       StaticHRTimer_t * pxTimerBuffer );
+ *
+ * As xHRTimerCreate(), but the memory used to hold the timer is provided by
+ * pxTimerBuffer rather than allocated from the FreeRTOS heap.
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    HRTimerHandle_t xHRTimerCreateStatic( HRTimerCallbackFunction_t pxCallbackFunction,
+                                          void * const pvTimerID,
+                                          StaticHRTimer_t * pxTimerBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * BaseType_t xHRTimerStart( HRTimerHandle_t xTimer,
+ *                           uint32_t ulDelay,
+ *                           uint32_t ulPeriod );
+ *
+ * Starts, or restarts, a high resolution timer so it expires ulDelay counts of
+ * the high resolution time base from now.  If ulPeriod is not zero the timer
+ * then expires every ulPeriod counts, in phase with the first expiry, until it
+ * is stopped.  If ulPeriod is zero the timer is a one-shot timer.  Use
+ * pdUS_TO_HR_TICKS() to convert from microseconds.
+ *
+ * Unlike xTimerStart() the timer is started before the function returns, as
+ * there is no timer service task to send a command to.
+ *
+ * @return pdPASS if the timer was started, or pdFAIL if ulDelay or ulPeriod is
+ * greater than hrtimerMAX_DELAY.
+ */
+BaseType_t xHRTimerStart( HRTimerHandle_t xTimer,
+                          uint32_t ulDelay,
+                          uint32_t ulPeriod ) PRIVILEGED_FUNCTION;
+
+/**
+ * BaseType_t xHRTimerStartFromISR( HRTimerHandle_t xTimer,
+ *                                  uint32_t ulDelay,
+ *                                  uint32_t ulPeriod );
+ *
+ * A version of xHRTimerStart() that can be called from an interrupt service
+ * routine, including from a high resolution timer callback.
+ */
+BaseType_t xHRTimerStartFromISR( HRTimerHandle_t xTimer,
+                                 uint32_t ulDelay,
+                                 uint32_t ulPeriod ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vHRTimerStop( HRTimerHandle_t xTimer );
+ *
+ * Stops a high resolution timer.  The timer's callback will not be called
+ * again until the timer is restarted.  Stopping a dormant timer has no effect.
+ */
+void vHRTimerStop( HRTimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vHRTimerStopFromISR( HRTimerHandle_t xTimer );
+ *
+ * A version of vHRTimerStop() that can be called from an interrupt service
+ * routine, including from a high resolution timer callback.
+ */
+void vHRTimerStopFromISR( HRTimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vHRTimerDelete( HRTimerHandle_t xTimer );
+ *
+ * Stops a high resolution timer and frees the memory used to hold it if it was
+ * created with xHRTimerCreate().
+ */
+void vHRTimerDelete( HRTimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * BaseType_t xHRTimerIsTimerActive( HRTimerHandle_t xTimer );
+ *
+ * @return pdTRUE if the timer has been started and has not yet expired (one-shot
+ * timers) or been stopped, otherwise pdFALSE.
+ */
+BaseType_t xHRTimerIsTimerActive( HRTimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * void * pvHRTimerGetTimerID( HRTimerHandle_t xTimer );
+ *
+ * @return The identifier assigned to the timer when it was created.
+ */
+void * pvHRTimerGetTimerID( const HRTimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * uint32_t ulHRTimerGetTime( void );
+ *
+ * @return The current value of the high resolution time base, which counts at
+ * configHR_TIMER_FREQUENCY_HZ and wraps at 2^32.
+ */
+uint32_t ulHRTimerGetTime( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * BaseType_t xHRTimerInterruptHandler( void );
+ *
+ * Must be called by the port's high resolution timer compare interrupt handler
+ * after it has cleared the interrupt.  Calls the callback of each timer that
+ * has expired then arms the compare for the next expiry.
+ *
+ * @return pdTRUE if a callback unblocked a task of higher priority than the
+ * interrupted task, in which case the handler should request a context switch
+ * with portYIELD_FROM_ISR() or portEND_SWITCHING_ISR().
+ */
+BaseType_t xHRTimerInterruptHandler( void ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+#endif /* HR_TIMERS_H */
@@ -0,0 +1,234 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include mempool.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*-----------------------------------------------------------
+* MACROS AND DEFINITIONS
+*----------------------------------------------------------*/
+
+/**
+ * The number of bytes each block of a pool created with a block size of
+ * xBlockSize actually occupies.  Blocks are at least large enough to hold a
+ * pointer, and are a multiple of portBYTE_ALIGNMENT bytes so every block is
+ * aligned.
+ */
+#define poolBLOCK_SIZE( xBlockSize )                                                                 \
+    ( ( ( ( ( xBlockSize ) < sizeof( void * ) ) ? sizeof( void * ) : ( size_t ) ( xBlockSize ) ) + \
+        ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/**
+ * The size, in bytes, of the storage area that must be passed to
+ * xPoolCreateStatic() to create a pool of uxBlockCount blocks of xBlockSize
+ * bytes.
+ */
+#define poolSTORAGE_SIZE( xBlockSize, uxBlockCount )    ( poolBLOCK_SIZE( xBlockSize ) * ( size_t ) ( uxBlockCount ) )
+
+/**
+ * Type by which memory pools are referenced.
+ */
+struct PoolDef_t;
+typedef struct PoolDef_t * PoolHandle_t;
+
+/**
+ * Used with vPoolGetStats() to obtain information on the use of a pool.
+ */
+typedef struct xPOOL_STATS
+{
+    size_t xBlockSize;                     /* The size of each block, as returned by poolBLOCK_SIZE(). */
+    UBaseType_t uxBlockCount;              /* The number of blocks in the pool. */
+    UBaseType_t uxFreeBlocks;              /* The number of blocks not currently allocated. */
+    UBaseType_t uxMinimumEverFreeBlocks;   /* The fewest blocks that have been free since the pool was created. */
+    uint32_t ulAllocations;                /* The number of successful allocations. */
+    uint32_t ulFrees;                      /* The number of blocks returned to the pool. */
+    uint32_t ulFailedAllocations;          /* The number of allocations that returned NULL because the pool was empty. */
+    uint32_t ulBlockedAllocations;         /* The number of times a task blocked waiting for a block to be freed. */
+} PoolStats_t;
+
+/*-----------------------------------------------------------
+* MEMORY POOL API
+*----------------------------------------------------------*/
+
+/**
+ * PoolHandle_t xPoolCreate( size_t xBlockSize,
+ *                           UBaseType_t uxBlockCount );
+ *
+ * Creates a pool of uxBlockCount fixed size blocks of at least xBlockSize bytes
+ * each, and returns a handle by which the pool can be referenced, or NULL if
+ * there was insufficient heap to create it.  The pool structure and all its
+ * blocks are obtained from the FreeRTOS heap with a single call to
+ * pvPortMalloc().
+ *
+ * Unlike pvPortMalloc(), allocating a block from and returning a block to a
+ * pool never suspends the scheduler and never searches.  Free blocks are held
+ * on a singly linked list that is only updated within the port's interrupt
+ * mask, for a fixed handful of instructions, so pvPoolAlloc() and vPoolFree()
+ * take the same short time however many blocks are in use, and have interrupt
+ * safe forms.  A task can also block, with a timeout, until a block is freed.
+ *
+ * @param xBlockSize The number of bytes required from each block.
+ *
+ * @param uxBlockCount The number of blocks in the pool.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    PoolHandle_t xPoolCreate( size_t xBlockSize,
+                              UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * PoolHandle_t xPoolCreateStatic( size_t xBlockSize,
+ *                                 UBaseType_t uxBlockCount,
+ *                                 uint8_t * pucPoolStorage,
+ *                                 StaticPool_t * pxPoolBuffer );
+ *
+ * As xPoolCreate(), but the memory used to hold the pool is provided by the
+ * application.
+ *
+ * @param pucPoolStorage An array of at least
+ * poolSTORAGE_SIZE( xBlockSize, uxBlockCount ) bytes, aligned to
+ * portBYTE_ALIGNMENT, from which the blocks are allocated.
+ *
+ * @param pxPoolBuffer Used to hold the pool's data structure.
+ *
+ * Example usage:
+ * @verbatim
+ * #define NUM_DESCRIPTORS    32
+ *
+ * static uint8_t ucDescriptorStorage[ poolSTORAGE_SIZE( sizeof( Descriptor_t ), NUM_DESCRIPTORS ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+ * static StaticPool_t xDescriptorPoolBuffer;
+ *
+ * void vSetupDescriptors( void )
+ * {
+ *     xDescriptorPool = xPoolCreateStatic( sizeof( Descriptor_t ), NUM_DESCRIPTORS, ucDescriptorStorage, &xDescriptorPoolBuffer );
+ * }
+ * @endverbatim
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    PoolHandle_t xPoolCreateStatic( size_t xBlockSize,
+                                    UBaseType_t uxBlockCount,
+                                    uint8_t * pucPoolStorage,
+                                    StaticPool_t * pxPoolBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vPoolDelete( PoolHandle_t xPool );
+ *
+ * Deletes a pool, freeing the memory used to hold it if it was created with
+ * xPoolCreate().  No task may be blocked on the pool, and no block allocated
+ * from the pool may be used after the pool is deleted.
+ */
+void vPoolDelete( PoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * void * pvPoolAlloc( PoolHandle_t xPool,
+ *                     TickType_t xTicksToWait );
+ *
+ * Allocates a block from a pool.
+ *
+ * @param xTicksToWait The maximum time the calling task should remain in the
+ * Blocked state waiting for a block to be returned to the pool if the pool is
+ * empty.  If more than one task is waiting, the highest priority task receives
+ * the next block freed.  Set to 0 to return immediately.
+ *
+ * @return A pointer to the block, or NULL if the pool remained empty for
+ * xTicksToWait ticks.
+ */
+void * pvPoolAlloc( PoolHandle_t xPool,
+                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * void * pvPoolAllocFromISR( PoolHandle_t xPool );
+ *
+ * A version of pvPoolAlloc() that can be called from an interrupt service
+ * routine.  It never blocks.
+ *
+ * @return A pointer to the block, or NULL if the pool is empty.
+ */
+void * pvPoolAllocFromISR( PoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vPoolFree( PoolHandle_t xPool,
+ *                 void * pvBlock );
+ *
+ * Returns a block obtained from pvPoolAlloc() or pvPoolAllocFromISR() to the
+ * pool it was allocated from, unblocking the highest priority task waiting to
+ * allocate from the pool, if any.
+ */
+void vPoolFree( PoolHandle_t xPool,
+                void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vPoolFreeFromISR( PoolHandle_t xPool,
+ *                        void * pvBlock,
+ *                        BaseType_t * pxHigherPriorityTaskWoken );
+ *
+ * A version of vPoolFree() that can be called from an interrupt service
+ * routine.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if returning the block
+ * unblocked a task that has a priority above the interrupted task, in which
+ * case a context switch should be requested before the interrupt is exited.
+ */
+void vPoolFreeFromISR( PoolHandle_t xPool,
+                       void * pvBlock,
+                       BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * UBaseType_t uxPoolGetFreeBlockCount( PoolHandle_t xPool );
+ *
+ * @return The number of blocks currently available in the pool.
+ */
+UBaseType_t uxPoolGetFreeBlockCount( const PoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vPoolGetStats( PoolHandle_t xPool,
+ *                     PoolStats_t * pxPoolStats );
+ *
+ * Fills *pxPoolStats with the pool's geometry and usage counts.  The counts
+ * are read together, so are consistent with each other.
+ */
+void vPoolGetStats( const PoolHandle_t xPool,
+                    PoolStats_t * pxPoolStats ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+#endif /* MEM_POOL_H */
@@ -130,12 +130,17 @@
     #endif
 #endif /* if ( portUSING_MPU_WRAPPERS == 1 ) */
 
+/* Attributes of a heap region, set in HeapRegion_t.ulAttributes.  The other
+ * bits are free for the application to use with pvPortMallocWithHint(). */
+#define heapREGION_FAST    ( ( uint32_t ) 0x00000001UL ) /* The fastest memory, such as tightly coupled RAM. */
+
 /* Used by heap_5.c to define the start address and size of each memory region
  * that together comprise the total FreeRTOS heap space. */
 typedef struct HeapRegion
 {
     uint8_t * pucStartAddress;
     size_t xSizeInBytes;
+    uint32_t ulAttributes; /* heapREGION_ bits describing the memory, or 0.  Only used by heap_5.c. */
 } HeapRegion_t;
 
 /* Used to pass information about the heap out of vPortGetHeapStats(). */
@@ -163,6 +168,26 @@ typedef struct xHeapStats
  */
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEGED_FUNCTION;
 
+/*
+ * Region aware allocation, provided by heap_5.c.  pvPortMallocFrom() allocates
+ * only from the region at index xRegion in the array passed to
+ * vPortDefineHeapRegions().  pvPortMallocWithHint() allocates from a region
+ * that has all the heapREGION_ bits in ulAttributes if one has space, and from
+ * any other region if not.  Blocks from either are freed with vPortFree().
+ */
+void * pvPortMallocFrom( BaseType_t xRegion,
+                         size_t xSize ) PRIVILEGED_FUNCTION;
+void * pvPortMallocWithHint( uint32_t ulAttributes,
+                             size_t xSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * As vPortGetHeapStats(), but for the region at index xRegion in the array
+ * passed to vPortDefineHeapRegions().  Returns pdFAIL if there is no such
+ * region.  Provided by heap_5.c.
+ */
+BaseType_t xPortGetHeapRegionStats( BaseType_t xRegion,
+                                    HeapStats_t * pxHeapStats ) PRIVILEGED_FUNCTION;
+
 /*
  * Returns a HeapStats_t structure filled with information about the current
  * heap state.
@@ -180,9 +205,122 @@ void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+/*
+ * Called by the kernel when a task that still holds heap is deleted, to clear
+ * the owner recorded in the blocks the task allocated and has not freed, so
+ * freeing them later does not credit the deleted task.  xBytesOwned is the
+ * heap the task was charged for, so the search can stop once it is all found.
+ * Provided by heap_4.c and heap_5.c.
+ */
+    void vPortDisownHeapBlocks( void * pvOwner,
+                                size_t xBytesOwned ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_HEAP_TRACE == 1 )
+
+/* Values of HeapTraceRecord_t.ucOperation. */
+    #define heapTRACE_MALLOC    ( ( uint8_t ) 0 )
+    #define heapTRACE_FREE      ( ( uint8_t ) 1 )
+
+/*
+ * One call to pvPortMalloc() or vPortFree() as recorded by heap_trace.c.
+ */
+    typedef struct xHEAP_TRACE_RECORD
+    {
+        void * pvAddress;           /* The address returned by pvPortMalloc(), or passed to vPortFree().  NULL if the allocation failed. */
+        void * pvCaller;            /* The return address into the function that called pvPortMalloc() or vPortFree(). */
+        size_t xBlockSize;          /* The size of the block, including the heap's block header.  For a failed allocation, the size of the block that was wanted. */
+        size_t xFreeBytesRemaining; /* The free heap space after the operation. */
+        uint32_t ulTimeStamp;       /* The run time stats counter, or the tick count if run time stats are not generated. */
+        uint8_t ucOperation;        /* heapTRACE_MALLOC or heapTRACE_FREE. */
+    } HeapTraceRecord_t;
+
+/*
+ * Called by heap_2.c, heap_4.c and heap_5.c, with the scheduler suspended, to
+ * record an allocation or a free.
+ */
+    void vHeapTraceRecord( uint8_t ucOperation,
+                           void * pvAddress,
+                           size_t xBlockSize,
+                           size_t xFreeBytesRemaining,
+                           void * pvCaller ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the oldest record from the heap trace buffer and copies it to
+ * *pxRecord.  Returns pdTRUE if a record was copied, or pdFALSE if the buffer
+ * was empty.  Must not be called from an interrupt.
+ */
+    BaseType_t xHeapTraceRead( HeapTraceRecord_t * pxRecord ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of records that were overwritten before they could be
+ * read.
+ */
+    uint32_t ulHeapTraceGetDroppedCount( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+
+/* The kinds of region timed by critical_profile.c. */
+    #define critprofCRITICAL_SECTION     ( ( uint8_t ) 0 ) /* Between the outermost portENTER_CRITICAL() and portEXIT_CRITICAL(). */
+    #define critprofSCHEDULER_LOCKED     ( ( uint8_t ) 1 ) /* Between the outermost vTaskSuspendAll() and xTaskResumeAll(). */
+    #define critprofKINDS                ( 2 )
+
+/*
+ * The longest region entered from one call site.
+ */
+    typedef struct xCRITICAL_SECTION_RECORD
+    {
+        void * pvCaller;   /* The return address into the function that entered the region. */
+        uint32_t ulCounts; /* The longest time the region was held, in portCRITICAL_SECTION_TIMER_VALUE() counts. */
+    } CriticalSectionRecord_t;
+
+/*
+ * Called by the port when the outermost critical section is entered, after
+ * interrupts have been masked, and by vTaskSuspendAll() when the scheduler is
+ * first suspended.  Only one region of each kind can be open at a time.
+ */
+    void vCriticalSectionProfileEnter( uint8_t ucKind,
+                                       void * pvCaller ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by the port when the outermost critical section is left, before
+ * interrupts are unmasked, and by xTaskResumeAll(), from inside a critical
+ * section, when the scheduler is resumed.  Records the time since the matching
+ * call to vCriticalSectionProfileEnter().
+ */
+    void vCriticalSectionProfileExit( uint8_t ucKind ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies up to uxMaxRecords of the longest regions of kind ucKind into
+ * pxRecords, longest first, one per call site, and returns the number copied.
+ * At most configCRITICAL_SECTION_TOP_COUNT call sites are kept.
+ */
+    UBaseType_t uxCriticalSectionGetLongest( uint8_t ucKind,
+                                             CriticalSectionRecord_t * pxRecords,
+                                             UBaseType_t uxMaxRecords ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies the configCRITICAL_SECTION_BUCKETS entry log2 histogram of the
+ * lengths of the regions of kind ucKind into pulHistogram.
+ */
+    void vCriticalSectionGetHistogram( uint8_t ucKind,
+                                       uint32_t * pulHistogram ) PRIVILEGED_FUNCTION;
+
+/*
+ * Clears the longest regions and the histograms of both kinds.
+ */
+    void vCriticalSectionResetProfile( void ) PRIVILEGED_FUNCTION;
+#endif
+
 #if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
     void * pvPortMallocStack( size_t xSize ) PRIVILEGED_FUNCTION;
     void vPortFreeStack( void * pv ) PRIVILEGED_FUNCTION;
+#elif ( configUSE_FAST_HEAP_REGION_FOR_TASKS == 1 )
+    #define pvPortMallocStack( xSize )    pvPortMallocWithHint( heapREGION_FAST, ( xSize ) )
+    #define vPortFreeStack                vPortFree
 #else
     #define pvPortMallocStack    pvPortMalloc
     #define vPortFreeStack       vPortFree
@@ -41,6 +41,10 @@
  * to which the bytes were set when the task was created have not been
  * overwritten.  Note this second test does not guarantee that an overflowed
  * stack will always be recognised.
+ *
+ * Some ports save the top of stack before the macro is called but only store
+ * the registers there once another task has been selected, so the second test
+ * also checks the saved top of stack is clear of the check bytes.
  */
 
 /*-----------------------------------------------------------*/
@@ -91,7 +95,8 @@
         const uint32_t * const pulStack = ( uint32_t * ) pxCurrentTCB->pxStack;                       \
         const uint32_t ulCheckValue = ( uint32_t ) 0xa5a5a5a5;                                        \
                                                                                                       \
-        if( ( pulStack[ 0 ] != ulCheckValue ) ||                                                      \
+        if( ( ( const volatile uint32_t * ) pxCurrentTCB->pxTopOfStack < &( pulStack[ 4 ] ) ) ||      \
+            ( pulStack[ 0 ] != ulCheckValue ) ||                                                      \
             ( pulStack[ 1 ] != ulCheckValue ) ||                                                      \
             ( pulStack[ 2 ] != ulCheckValue ) ||                                                      \
             ( pulStack[ 3 ] != ulCheckValue ) )                                                       \
@@ -166,8 +166,44 @@ typedef struct xTASK_STATUS
         StackType_t * pxEndOfStack;               /* Points to the end address of the task's stack area. */
     #endif
     configSTACK_DEPTH_TYPE usStackHighWaterMark;  /* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        TickType_t xCpuBudget;                    /* The number of ticks the task may run for in each budget period, or 0 if the task has no budget.  See vTaskSetCpuBudget(). */
+        TickType_t xCpuBudgetPeriod;              /* The length of the budget replenishment period in ticks. */
+        TickType_t xCpuBudgetUsed;                /* The number of ticks consumed from the budget in the current period. */
+        UBaseType_t uxCpuBudgetOverruns;          /* The number of times the task has exhausted its budget and been held until replenishment. */
+    #endif
+    #if ( configRECORD_JOB_TIMES == 1 )
+        configRUN_TIME_COUNTER_TYPE ulMaxJobRunTime;  /* The longest run time, in run time counter units, observed for one job.  A job runs from the task's first dispatch after leaving the Blocked state until it next leaves the Ready state. */
+        configRUN_TIME_COUNTER_TYPE ulMinJobInterval; /* The shortest observed time between the start of two consecutive jobs, or 0 if fewer than two jobs have started. */
+        UBaseType_t uxJobCount;                       /* The number of jobs started. */
+    #endif
+    #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+        UBaseType_t uxVoluntarySwitches;          /* The number of times the task was switched out because it blocked, suspended or deleted itself. */
+        UBaseType_t uxInvoluntarySwitches;        /* The number of times the task was switched out while still Ready - preempted, time sliced, yielding or held by its CPU budget. */
+    #endif
+    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        size_t xHeapBytesInUse;                   /* The heap, including block headers, currently held in blocks allocated by the task. */
+        size_t xHeapBytesPeak;                    /* The most heap the task has held at one time. */
+        size_t xHeapQuota;                        /* The most heap the task may hold, or 0 if it has no quota.  See vTaskSetHeapQuota(). */
+    #endif
 } TaskStatus_t;
 
+/* Used with vTaskIteratorStart() and xTaskIteratorNext() to report the tasks
+ * one at a time.  The members are only for use by the kernel. */
+typedef struct xTASK_ITERATOR
+{
+    TaskHandle_t xNextTask;   /* The task the next call to xTaskIteratorNext() reports, or NULL when all have been reported. */
+    UBaseType_t uxGeneration; /* The count of task creations and deletions when vTaskIteratorStart() was called. */
+} TaskIterator_t;
+
+/* One entry of the schedule table passed to vTaskSetTimeTriggeredSchedule(). */
+typedef struct xTIME_TRIGGERED_ENTRY
+{
+    TickType_t xOffset;        /* The tick within each period at which the task is released.  Must be less than xPeriod. */
+    TickType_t xPeriod;        /* The number of ticks between consecutive releases of the task. */
+    TaskHandle_t * pxTask;     /* Points to the variable that holds the handle of the task to release. */
+} TimeTriggeredEntry_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -245,6 +281,16 @@ typedef enum
  */
 #define taskENABLE_INTERRUPTS()            portENABLE_INTERRUPTS()
 
+/* Bits of the uxFields parameter of xTaskIteratorNext() that select the
+ * TaskStatus_t members that take time to find.  The other members are always
+ * filled in. */
+#define tskSTATUS_STACK_HIGH_WATER_MARK    ( ( UBaseType_t ) 0x01U )
+#define tskSTATUS_ALL                      ( ( UBaseType_t ) 0x01U )
+
+/* Returned by xTaskIteratorNext() when a task was created or deleted since
+ * vTaskIteratorStart() was called. */
+#define taskITERATOR_CHANGED               ( ( BaseType_t ) -1 )
+
 /* Definitions returned by xTaskGetSchedulerState().  taskSCHEDULER_SUSPENDED is
  * 0 to generate more optimal code when configASSERT() is defined as the constant
  * is used in assert() statements. */
@@ -895,8 +941,13 @@ BaseType_t xTaskDelayUntil( TickType_t * const pxPreviousWakeTime,
  *
  * @param xTask The handle of the task to remove from the Blocked state.
  *
- * @return If the task referenced by xTask was not in the Blocked state then
- * pdFAIL is returned.  Otherwise pdPASS is returned.
+ * A task that is in the Blocked state only because it has exhausted the CPU
+ * budget set by vTaskSetCpuBudget() cannot be removed from the Blocked state
+ * early.
+ *
+ * @return If the task referenced by xTask was not in the Blocked state, or was
+ * held in the Blocked state by its CPU budget, then pdFAIL is returned.
+ * Otherwise pdPASS is returned.
  *
  * \defgroup xTaskAbortDelay xTaskAbortDelay
  * \ingroup TaskCtrl
@@ -1088,6 +1139,276 @@ void vTaskGetInfo( TaskHandle_t xTask,
 void vTaskPrioritySet( TaskHandle_t xTask,
                        UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * @code{c}
+ * void vTaskSetCpuBudget( TaskHandle_t xTask, TickType_t xBudgetTicks, TickType_t xPeriodTicks );
+ * @endcode
+ *
+ * configUSE_TASK_BUDGETS must be defined as 1 for this function to be
+ * available.
+ *
+ * Limit the processor time a task can consume.  The task may be in the Running
+ * state for at most xBudgetTicks ticks out of every xPeriodTicks ticks.  Time
+ * is charged to the task that was running when each tick interrupt occurs.
+ * When a task exhausts its budget it is moved to the Blocked state until the
+ * start of the next period, at which point its budget is replenished in full.
+ * xTaskAbortDelay() cannot release a task that is held in this way.
+ * Tasks that hold a mutex are not held until they have released all mutexes,
+ * so priority inheritance continues to bound the blocking time of other tasks.
+ *
+ * The budget period starts when this function is called.
+ *
+ * @param xTask Handle to the task being limited.  Passing a NULL handle
+ * results in the budget of the calling task being set.  The idle task cannot
+ * be given a budget.
+ *
+ * @param xBudgetTicks The number of ticks the task may run for in each period.
+ * Passing 0 removes any budget previously set for the task.
+ *
+ * @param xPeriodTicks The replenishment period in ticks.  Must be greater
+ * than or equal to xBudgetTicks.
+ *
+ * Example usage:
+ * @code{c}
+ * void vAFunction( TaskHandle_t xHandle )
+ * {
+ *   // Allow the task to use at most 20% of the processor time, measured
+ *   // over 100ms windows.
+ *   vTaskSetCpuBudget( xHandle, pdMS_TO_TICKS( 20 ), pdMS_TO_TICKS( 100 ) );
+ * }
+ * @endcode
+ * \defgroup vTaskSetCpuBudget vTaskSetCpuBudget
+ * \ingroup TaskCtrl
+ */
+void vTaskSetCpuBudget( TaskHandle_t xTask,
+                        TickType_t xBudgetTicks,
+                        TickType_t xPeriodTicks ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskSetHeapQuota( TaskHandle_t xTask, size_t xQuotaBytes );
+ * @endcode
+ *
+ * configUSE_TASK_HEAP_ACCOUNTING must be defined as 1, and the application
+ * must use heap_4.c or heap_5.c, for this function to be available.
+ *
+ * Limit the heap a task can hold.  Each block allocated by pvPortMalloc()
+ * after the scheduler has started is charged, including its header, to the
+ * task that allocated it until it is freed, whichever task frees it.  An
+ * allocation that would take the task's total above xQuotaBytes fails, so
+ * pvPortMalloc() returns NULL and, if configUSE_MALLOC_FAILED_HOOK is 1,
+ * vApplicationMallocFailedHook() is called from the context of the task that
+ * exceeded its quota.  The heap held by each task is reported in the
+ * xHeapBytesInUse and xHeapBytesPeak members of TaskStatus_t.
+ *
+ * Setting a quota below the heap the task already holds does not free any
+ * memory, but fails the task's allocations until it is back under the quota.
+ *
+ * @param xTask Handle to the task being limited.  Passing a NULL handle
+ * results in the quota of the calling task being set.
+ *
+ * @param xQuotaBytes The number of bytes the task may hold.  Passing 0 removes
+ * any quota previously set for the task.
+ *
+ * Example usage:
+ * @code{c}
+ * void vAFunction( TaskHandle_t xHandle )
+ * {
+ *   // Stop the logging task from taking more than 1K of the heap.
+ *   vTaskSetHeapQuota( xHandle, 1024 );
+ * }
+ * @endcode
+ * \defgroup vTaskSetHeapQuota vTaskSetHeapQuota
+ * \ingroup TaskCtrl
+ */
+void vTaskSetHeapQuota( TaskHandle_t xTask,
+                        size_t xQuotaBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskSetTimeTriggeredSchedule( const TimeTriggeredEntry_t * const pxSchedule, UBaseType_t uxEntries );
+ * @endcode
+ *
+ * configUSE_TIME_TRIGGERED_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Install a static schedule table that releases strictly periodic tasks
+ * directly from the tick interrupt.  The task referenced by each entry is
+ * released on every tick t for which ( t - t0 - xOffset ) is a multiple of
+ * xPeriod, where t0 is the tick count at which the scheduler was started and
+ * the first frame starts on the tick t0 + 1.
+ *
+ * A task in the schedule calls xTaskWaitForRelease() at the end of each
+ * activation instead of vTaskDelayUntil().  Tasks that are not in the schedule
+ * are scheduled as normal and run in the time left between releases.
+ *
+ * Must be called after the tasks in the table have been created but before
+ * the scheduler is started.  The table is only read by this function, and a
+ * task must appear in the table at most once.  Deleting a task in the schedule
+ * removes it from the schedule.
+ *
+ * The kernel keeps the tasks in the schedule in a list ordered by their next
+ * release time, so a tick that releases no task only compares the tick count
+ * with the next release time, and a tick that does release tasks takes only
+ * those tasks from the head of the list.  Each task released is then put back
+ * in the list at its next release time, which, as for a task that calls
+ * vTaskDelay(), takes time proportional to the number of tasks in the schedule
+ * released before it.
+ *
+ * @param pxSchedule The schedule table.
+ *
+ * @param uxEntries The number of entries in pxSchedule.
+ *
+ * Example usage:
+ * @code{c}
+ * TaskHandle_t xSensorHandle, xFilterHandle;
+ *
+ * // Release the sensor task at the start of every 100ms frame, and the
+ * // filter task 20ms into every other frame.
+ * static const TimeTriggeredEntry_t xSchedule[] =
+ * {
+ *   { 0, pdMS_TO_TICKS( 100 ), &xSensorHandle },
+ *   { pdMS_TO_TICKS( 20 ), pdMS_TO_TICKS( 200 ), &xFilterHandle }
+ * };
+ *
+ * void main( void )
+ * {
+ *   xTaskCreate( vSensorTask, "Sensor", STACK_SIZE, NULL, 3, &xSensorHandle );
+ *   xTaskCreate( vFilterTask, "Filter", STACK_SIZE, NULL, 2, &xFilterHandle );
+ *
+ *   vTaskSetTimeTriggeredSchedule( xSchedule, sizeof( xSchedule ) / sizeof( xSchedule[ 0 ] ) );
+ *   vTaskStartScheduler();
+ * }
+ * @endcode
+ * \defgroup vTaskSetTimeTriggeredSchedule vTaskSetTimeTriggeredSchedule
+ * \ingroup TaskCtrl
+ */
+void vTaskSetTimeTriggeredSchedule( const TimeTriggeredEntry_t * const pxSchedule,
+                                    UBaseType_t uxEntries ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * BaseType_t xTaskWaitForRelease( void );
+ * @endcode
+ *
+ * configUSE_TIME_TRIGGERED_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Place the calling task into the Blocked state until its next release by the
+ * time triggered schedule installed by vTaskSetTimeTriggeredSchedule().  May
+ * only be called by a task that appears in the schedule.
+ *
+ * If the task was released while it was not waiting - because its previous
+ * activation was still running, or it was blocked on something else - an
+ * overrun is recorded and the next call to xTaskWaitForRelease() returns
+ * immediately so the task stays aligned with its frames.
+ *
+ * @return pdPASS if the task waited for its release, or pdFAIL if the release
+ * had already occurred (an overrun).
+ *
+ * Example usage:
+ * @code{c}
+ * void vSensorTask( void * pvParameters )
+ * {
+ *   for( ;; )
+ *   {
+ *       if( xTaskWaitForRelease() != pdPASS )
+ *       {
+ *           // The previous activation did not complete within its frame.
+ *       }
+ *
+ *       // Sample the sensor.
+ *   }
+ * }
+ * @endcode
+ * \defgroup xTaskWaitForRelease xTaskWaitForRelease
+ * \ingroup TaskCtrl
+ */
+BaseType_t xTaskWaitForRelease( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * UBaseType_t uxTaskGetReleaseOverruns( TaskHandle_t xTask );
+ * @endcode
+ *
+ * configUSE_TIME_TRIGGERED_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * @param xTask Handle of the task to query.  Passing a NULL handle queries the
+ * calling task.
+ *
+ * @return The number of times the task was released by the time triggered
+ * schedule while it was not waiting for the release.
+ *
+ * \defgroup uxTaskGetReleaseOverruns uxTaskGetReleaseOverruns
+ * \ingroup TaskUtils
+ */
+UBaseType_t uxTaskGetReleaseOverruns( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskGetWakeupLatencyHistogram( TaskHandle_t xTask, uint16_t * pusHistogram );
+ * @endcode
+ *
+ * configRECORD_WAKEUP_LATENCY must be defined as 1 for this function to be
+ * available.
+ *
+ * The wake up latency of a task is the time between the task being made ready
+ * (for example by an event, a timeout or xTaskResumeFromISR()) and the task
+ * next running.  It is measured in run time stats counter units and recorded
+ * in a log2 histogram: bucket 0 counts zero latencies and bucket n counts
+ * latencies from 2^(n-1) to (2^n)-1, except the last bucket which also counts
+ * all longer latencies.  When a bucket would overflow every bucket is halved.
+ *
+ * @param xTask Handle of the task to query.  Passing a NULL handle queries the
+ * calling task.
+ *
+ * @param pusHistogram An array of configWAKEUP_LATENCY_BUCKETS entries into
+ * which the histogram is copied.
+ *
+ * \defgroup vTaskGetWakeupLatencyHistogram vTaskGetWakeupLatencyHistogram
+ * \ingroup TaskUtils
+ */
+void vTaskGetWakeupLatencyHistogram( TaskHandle_t xTask,
+                                     uint16_t * pusHistogram ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * configRUN_TIME_COUNTER_TYPE ulTaskGetWakeupLatencyPercentile( TaskHandle_t xTask, UBaseType_t uxPercentile );
+ * @endcode
+ *
+ * configRECORD_WAKEUP_LATENCY must be defined as 1 for this function to be
+ * available.
+ *
+ * @param xTask Handle of the task to query.  Passing a NULL handle queries the
+ * calling task.
+ *
+ * @param uxPercentile The percentile to return, from 0 to 100.
+ *
+ * @return An upper bound, in run time stats counter units, on the wake up
+ * latency not exceeded by uxPercentile percent of the task's wake ups, or 0 if
+ * no wake ups have been recorded.  The bound is the top of the histogram
+ * bucket that holds the percentile, limited to the largest latency observed.
+ * See vTaskGetWakeupLatencyHistogram().
+ *
+ * Example usage:
+ * @code{c}
+ * // The 99th percentile wake up latency of the task in counter units.
+ * ulP99 = ulTaskGetWakeupLatencyPercentile( xTask, 99 );
+ * @endcode
+ * \defgroup ulTaskGetWakeupLatencyPercentile ulTaskGetWakeupLatencyPercentile
+ * \ingroup TaskUtils
+ */
+configRUN_TIME_COUNTER_TYPE ulTaskGetWakeupLatencyPercentile( TaskHandle_t xTask,
+                                                              UBaseType_t uxPercentile ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * @code{c}
@@ -1567,6 +1888,31 @@ UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask ) PRIVILEGED_FUNCTIO
  */
 configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * @code{c}
+ * configSTACK_DEPTH_TYPE uxTaskGetStackHeadroom( TaskHandle_t xTask );
+ * @endcode
+ *
+ * configRECORD_STACK_HEADROOM must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Returns the least free stack space (in words) the task has had when it was
+ * switched out.  The kernel keeps the value up to date on each context switch,
+ * so reading it costs no more than reading a variable, where
+ * uxTaskGetStackHighWaterMark2() reads every unused word of the stack.  It
+ * only sees the stack pointer at the points the task was switched out, so can
+ * report more free space than uxTaskGetStackHighWaterMark2(), which finds the
+ * deepest word the task has written.
+ *
+ * @param xTask Handle of the task associated with the stack to be checked.
+ * Set xTask to NULL to check the stack of the calling task.
+ *
+ * @return The smallest amount of free stack space, in words, the task
+ * referenced by xTask has had at a context switch since it was created.
+ */
+configSTACK_DEPTH_TYPE uxTaskGetStackHeadroom( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /* When using trace macros it is sometimes necessary to include task.h before
  * FreeRTOS.h.  When this is done TaskHookFunction_t will not yet have been defined,
  * so the following two prototypes will cause a compilation error.  This can be
@@ -1809,6 +2155,67 @@ UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
                                   const UBaseType_t uxArraySize,
                                   configRUN_TIME_COUNTER_TYPE * const pulTotalRunTime ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * @code{c}
+ * void vTaskIteratorStart( TaskIterator_t * pxIterator );
+ * BaseType_t xTaskIteratorNext( TaskIterator_t * pxIterator, TaskStatus_t * pxTaskStatus, UBaseType_t uxFields );
+ * @endcode
+ *
+ * configUSE_TASK_ITERATOR must be defined as 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * Report the tasks in the system one at a time, in the order they were
+ * created, without the caller needing an array with room for every task.
+ * vTaskIteratorStart() positions the iterator at the first task.  Each call
+ * to xTaskIteratorNext() then fills in a TaskStatus_t structure for the next
+ * task, as vTaskGetInfo() does.  The scheduler is only suspended for the time
+ * it takes to report one task, so it is never held for longer as the number of
+ * tasks grows, as it is by uxTaskGetSystemState().
+ *
+ * Tasks that have deleted themselves are not reported, even though their
+ * memory may not have been freed yet.
+ *
+ * @param pxIterator The iterator, which is only valid between the calls to
+ * vTaskIteratorStart() and xTaskIteratorNext() of the same enumeration.
+ *
+ * @param pxTaskStatus The structure to fill in.
+ *
+ * @param uxFields The TaskStatus_t members to fill in that take time to find:
+ * tskSTATUS_STACK_HIGH_WATER_MARK finds usStackHighWaterMark by checking the
+ * task's stack, which otherwise reads 0.  tskSTATUS_ALL selects all of them.
+ *
+ * @return pdTRUE if *pxTaskStatus was filled in, pdFALSE if every task has
+ * been reported, or taskITERATOR_CHANGED if a task was created or deleted
+ * since vTaskIteratorStart() was called.  The tasks already reported are then
+ * not a consistent picture of the system and the enumeration should be
+ * started again.
+ *
+ * Example usage:
+ * @code{c}
+ *  void vPrintTaskNames( void )
+ *  {
+ *  TaskIterator_t xIterator;
+ *  TaskStatus_t xStatus;
+ *  BaseType_t xResult;
+ *
+ *      do
+ *      {
+ *          vTaskIteratorStart( &xIterator );
+ *
+ *          while( ( xResult = xTaskIteratorNext( &xIterator, &xStatus, 0 ) ) == pdTRUE )
+ *          {
+ *              printf( "%s\r\n", xStatus.pcTaskName );
+ *          }
+ *      } while( xResult == taskITERATOR_CHANGED );
+ *  }
+ *  @endcode
+ */
+void vTaskIteratorStart( TaskIterator_t * pxIterator ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskIteratorNext( TaskIterator_t * pxIterator,
+                              TaskStatus_t * pxTaskStatus,
+                              UBaseType_t uxFields ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * @code{c}
@@ -1957,6 +2364,46 @@ void vTaskGetRunTimeStats( char * pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e
 configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
 configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimePercent( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * @code{c}
+ * void vTaskAddInterruptRunTime( configRUN_TIME_COUNTER_TYPE ulTime );
+ * configRUN_TIME_COUNTER_TYPE ulTaskGetInterruptRunTimeCounter( void );
+ * @endcode
+ *
+ * configGENERATE_RUN_TIME_STATS and configRECORD_INTERRUPT_RUN_TIME must both
+ * be defined as 1 for these functions to be available.
+ *
+ * Without them the time spent in interrupt handlers is counted as run time of
+ * whichever task was interrupted.  The application times its handlers and
+ * calls vTaskAddInterruptRunTime() from each one, as it returns, with the time
+ * it ran for in run time counter units.  The time is taken off the run time of
+ * the task that was running when the next context switch occurs, so the run
+ * time of each task, as reported by uxTaskGetSystemState() and
+ * vTaskGetRunTimeStats(), only includes the time the task itself executed.
+ * Interrupt time that exceeds the time the task ran for, which a coarse run
+ * time counter can report, is taken off the next task instead.
+ *
+ * ulTaskGetInterruptRunTimeCounter() returns the total time reported, so the
+ * run time of the tasks plus the interrupt run time adds up to the total run
+ * time.
+ *
+ * vTaskAddInterruptRunTime() can be called from any interrupt that can use the
+ * interrupt safe API, and from a nested interrupt.  A handler that is
+ * interrupted by another that reports its own time should not include the
+ * time of the other handler.
+ *
+ * @param ulTime The time the interrupt handler ran for, in the units of
+ * portGET_RUN_TIME_COUNTER_VALUE().
+ *
+ * @return The total time reported by vTaskAddInterruptRunTime().
+ *
+ * \defgroup vTaskAddInterruptRunTime vTaskAddInterruptRunTime
+ * \ingroup TaskUtils
+ */
+void vTaskAddInterruptRunTime( configRUN_TIME_COUNTER_TYPE ulTime ) PRIVILEGED_FUNCTION;
+configRUN_TIME_COUNTER_TYPE ulTaskGetInterruptRunTimeCounter( void ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * @code{c}
@@ -3109,6 +3556,30 @@ TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Called by the heap implementation, with the scheduler
+ * suspended, to return pdFALSE if allocating xBlockSize bytes would take the
+ * calling task over its heap quota.
+ */
+BaseType_t xTaskHeapQuotaAvailable( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Called by the heap implementation, with the scheduler
+ * suspended, to charge a newly allocated block of xBlockSize bytes to the
+ * calling task.  Returns the handle of the task charged, which must be passed
+ * to vTaskHeapRelease() when the block is freed, or NULL if the scheduler has
+ * not been started.
+ */
+TaskHandle_t xTaskHeapCharge( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Called by the heap implementation, with the scheduler
+ * suspended, to credit a freed block of xBlockSize bytes back to the task
+ * returned by xTaskHeapCharge() when the block was allocated.
+ */
+void vTaskHeapRelease( TaskHandle_t xOwner,
+                       size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -54,6 +54,7 @@
  * as defined below.  The commands that are sent from interrupts must use the
  * highest numbers as tmrFIRST_FROM_ISR_COMMAND is used to determine if the task
  * or interrupt version of the queue send function should be used. */
+#define tmrCOMMAND_EXECUTE_BATCH               ( ( BaseType_t ) -3 )
 #define tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR    ( ( BaseType_t ) -2 )
 #define tmrCOMMAND_EXECUTE_CALLBACK             ( ( BaseType_t ) -1 )
 #define tmrCOMMAND_START_DONT_TRACE             ( ( BaseType_t ) 0 )
@@ -84,6 +85,18 @@ typedef struct tmrTimerControl * TimerHandle_t;
  */
 typedef void (* TimerCallbackFunction_t)( TimerHandle_t xTimer );
 
+/*
+ * One entry in an array of commands passed to xTimerSendCommandBatch().  The
+ * members take the same values as the equivalent parameters of
+ * xTimerGenericCommand().
+ */
+typedef struct xTIMER_BATCH_COMMAND
+{
+    TimerHandle_t xTimer;      /*<< The timer the command applies to. */
+    BaseType_t xCommandID;     /*<< tmrCOMMAND_START, tmrCOMMAND_RESET, tmrCOMMAND_STOP, tmrCOMMAND_CHANGE_PERIOD or tmrCOMMAND_DELETE. */
+    TickType_t xOptionalValue; /*<< The command time for tmrCOMMAND_START and tmrCOMMAND_RESET (normally xTaskGetTickCount()), or the new period for tmrCOMMAND_CHANGE_PERIOD. */
+} TimerBatchCommand_t;
+
 /*
  * Defines the prototype to which functions used with the
  * xTimerPendFunctionCallFromISR() function must conform.
@@ -1323,11 +1336,192 @@ TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+/**
+ * void vTimerSetHard( TimerHandle_t xTimer );
+ *
+ * Makes xTimer a hard timer.  configUSE_HARD_TIMERS must be set to 1 in
+ * FreeRTOSConfig.h for vTimerSetHard() to be available.
+ *
+ * The callback of a hard timer is called directly from the tick interrupt at
+ * the tick on which the timer expires, so its timing does not depend on the
+ * priority of the timer service task or on the callbacks of other timers.
+ * Commands such as xTimerStart(), xTimerStop(), xTimerChangePeriod() and their
+ * FromISR() versions are carried out immediately by the calling task or
+ * interrupt rather than being sent to the timer service task, so never block.
+ * The period of a started or reset hard timer is measured from the most recent
+ * tick interrupt.
+ *
+ * A hard timer callback executes in interrupt context with interrupts up to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY masked.  It must be short and must only
+ * call API functions that end in "FromISR", passing NULL as the
+ * pxHigherPriorityTaskWoken parameter - a context switch is requested when the
+ * tick interrupt exits if the callback unblocks a higher priority task.  If
+ * configHARD_TIMER_MAX_CALLBACK_TIME is greater than 0, a hard timer whose
+ * callback executes for longer than that is stopped and
+ * traceTIMER_HARD_CALLBACK_OVERRUN() is called.
+ *
+ * If an auto-reload hard timer misses expiries, for example because the tick
+ * was suppressed, its callback is only called once and the timer is reloaded
+ * to its next expiry time in phase with its original period.
+ *
+ * @param xTimer The timer to make a hard timer.  The timer must not have been
+ * started.
+ */
+void vTimerSetHard( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * BaseType_t xTimerSetSlack( TimerHandle_t xTimer, const TickType_t xSlackInTicks );
+ *
+ * Allows the timer service task to process xTimer up to xSlackInTicks ticks
+ * after its expiry time.  configUSE_TIMER_SLACK must be set to 1 in
+ * FreeRTOSConfig.h for xTimerSetSlack() to be available.
+ *
+ * Without slack the timer service task, and with tickless idle the processor,
+ * wakes at the exact expiry time of every timer.  With slack it sleeps until
+ * the last tick at which every timer that has expired is still within its
+ * slack, then processes all of them together, so timers whose windows overlap
+ * share one wake up.  Slack only delays when the callback is called - an
+ * auto-reload timer's next expiry time is still calculated from its exact
+ * expiry time, so its period does not drift.
+ *
+ * The new slack takes effect the next time the timer service task decides how
+ * long to sleep, which is at the latest after the next command it receives.
+ * Hard timers are processed in the tick interrupt and ignore their slack.
+ *
+ * @param xTimer The handle of the timer being updated.
+ *
+ * @param xSlackInTicks How late the timer may be processed.  0, the default,
+ * means the timer is processed at its expiry time.  The slack must be shorter
+ * than the timer's period, so the timer is always processed before its next
+ * expiry.
+ *
+ * @return pdFAIL if xSlackInTicks is not shorter than the timer's period, in
+ * which case the slack is left unchanged, otherwise pdPASS.
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    BaseType_t xTimerSetSlack( TimerHandle_t xTimer,
+                               const TickType_t xSlackInTicks ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * TickType_t xTimerGetSlack( TimerHandle_t xTimer );
+ *
+ * Returns the slack set with xTimerSetSlack().
+ *
+ * @param xTimer The handle of the timer being queried.
+ *
+ * @return The number of ticks after its expiry time the timer may be processed.
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    TickType_t xTimerGetSlack( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerGetWakeupStats( uint32_t * const pulTimerExpiries,
+ *                            uint32_t * const pulExpiryWakeups );
+ *
+ * Reports how well timer expiries are being coalesced.  configUSE_TIMER_SLACK
+ * must be set to 1 in FreeRTOSConfig.h for vTimerGetWakeupStats() to be
+ * available.  Sampling the counts twice and dividing the differences by the
+ * time between the samples gives timer expiries and timer service task wake ups
+ * per second - without slack the two rates are the same.
+ *
+ * Example usage:
+ * @verbatim
+ * uint32_t ulExpiries, ulWakeups, ulLastExpiries = 0, ulLastWakeups = 0;
+ *
+ * for( ;; )
+ * {
+ *     vTaskDelay( pdMS_TO_TICKS( 1000 ) );
+ *     vTimerGetWakeupStats( &ulExpiries, &ulWakeups );
+ *     printf( "%u expiries/s, %u wakeups/s\r\n",
+ *             ulExpiries - ulLastExpiries,
+ *             ulWakeups - ulLastWakeups );
+ *     ulLastExpiries = ulExpiries;
+ *     ulLastWakeups = ulWakeups;
+ * }
+ * @endverbatim
+ *
+ * @param pulTimerExpiries Set to the number of timer expiries the timer service
+ * task has processed.
+ *
+ * @param pulExpiryWakeups Set to the number of times the timer service task has
+ * woken from the Blocked state and processed at least one expiry.
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    void vTimerGetWakeupStats( uint32_t * const pulTimerExpiries,
+                               uint32_t * const pulExpiryWakeups ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * BaseType_t xTimerSendCommandBatch( const TimerBatchCommand_t * const pxCommands,
+ *                                    const UBaseType_t uxNumberOfCommands,
+ *                                    const TickType_t xTicksToWait );
+ *
+ * Sends an array of timer commands to the timer service task as a single
+ * message on the timer command queue.  configUSE_TIMER_BATCH_COMMANDS must be
+ * set to 1 in FreeRTOSConfig.h for xTimerSendCommandBatch() to be available.
+ *
+ * Starting, stopping or changing the period of many timers with the individual
+ * API functions sends one message per timer, and can wake the timer service
+ * task once per timer.  A batch costs one queue send and one wake however many
+ * commands it holds, and the timer service task carries out all the commands
+ * before it processes any other command or any timer expiry, so the batch is
+ * applied atomically with respect to other timer activity.
+ *
+ * The commands are read from pxCommands by the timer service task, so the
+ * calling task blocks until the whole batch has been carried out, at which
+ * point the timer service task sets bit 31 of the calling task's notification
+ * value at index configTIMER_BATCH_NOTIFICATION_INDEX.  Any notification
+ * pending at that index is discarded when the batch is sent, and other
+ * notifications do not end the wait, so that notification index should not be
+ * used for anything else by a task that sends batches.  If the function is
+ * called before the scheduler has started, or from a timer callback function,
+ * the commands are carried out directly.  The function must not be called
+ * while the scheduler is suspended.
+ *
+ * Example usage:
+ * @verbatim
+ * TimerBatchCommand_t xCommands[ 2 ];
+ *
+ * xCommands[ 0 ].xTimer = xSensorTimer;
+ * xCommands[ 0 ].xCommandID = tmrCOMMAND_CHANGE_PERIOD;
+ * xCommands[ 0 ].xOptionalValue = pdMS_TO_TICKS( 50 );
+ * xCommands[ 1 ].xTimer = xWatchdogTimer;
+ * xCommands[ 1 ].xCommandID = tmrCOMMAND_RESET;
+ * xCommands[ 1 ].xOptionalValue = xTaskGetTickCount();
+ *
+ * xTimerSendCommandBatch( xCommands, 2, portMAX_DELAY );
+ * @endverbatim
+ *
+ * @param pxCommands The commands to carry out, in order.  Only the task level
+ * command IDs can be used.
+ *
+ * @param uxNumberOfCommands The number of entries in pxCommands.
+ *
+ * @param xTicksToWait The time to wait for space on the timer command queue.
+ * Once the batch has been queued the function always waits for it to be
+ * carried out.
+ *
+ * @return pdPASS if the commands were carried out, or pdFAIL if the batch could
+ * not be sent to the timer service task before xTicksToWait expired.
+ */
+#if ( configUSE_TIMER_BATCH_COMMANDS == 1 )
+    BaseType_t xTimerSendCommandBatch( const TimerBatchCommand_t * const pxCommands,
+                                       const UBaseType_t uxNumberOfCommands,
+                                       const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
  */
 BaseType_t xTimerCreateTimerTask( void ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_HARD_TIMERS == 1 )
+    void vTimerProcessHardTimers( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+    BaseType_t xTimerGetNextHardExpiryTime( TickType_t * const pxNextExpiryTime ) PRIVILEGED_FUNCTION;
+#endif
 BaseType_t xTimerGenericCommand( TimerHandle_t xTimer,
                                  const BaseType_t xCommandID,
                                  const TickType_t xOptionalValue,
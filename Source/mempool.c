@@ -0,0 +1,609 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "atomic.h"
+#include "mempool.h"
+
+/* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e9021 !e961 !e750. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include memory pool functionality. */
+#if ( configUSE_MEMORY_POOLS == 1 )
+
+/* Bit definitions used in the ucFlags member of a pool structure. */
+    #define poolFLAGS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x01 )
+
+/* A free block holds a pointer to the next free block in its first bytes, so
+ * the free list needs no memory beyond the blocks themselves. */
+    typedef struct PoolFreeBlock_t
+    {
+        struct PoolFreeBlock_t * pxNextFreeBlock;
+    } PoolFreeBlock_t;
+
+/* The definition of the pools themselves. */
+    typedef struct PoolDef_t
+    {
+        PoolFreeBlock_t * volatile pxFreeList;     /*<< The first free block, or NULL if the pool is empty. */
+        uint8_t * pucStorage;                      /*<< The start of the array the blocks are carved from. */
+        size_t xBlockSize;                         /*<< The size of each block, a multiple of portBYTE_ALIGNMENT. */
+        UBaseType_t uxBlockCount;                  /*<< The number of blocks in the pool. */
+        volatile UBaseType_t uxFreeBlocks;         /*<< The number of blocks on the free list. */
+        UBaseType_t uxMinimumEverFreeBlocks;       /*<< The low water mark of uxFreeBlocks. */
+        List_t xTasksWaitingToAllocate;            /*<< Tasks blocked on the pool, in priority order. */
+        uint32_t ulAllocations;                    /*<< The statistics returned by vPoolGetStats(). */
+        uint32_t ulFrees;
+        uint32_t ulFailedAllocations;
+        uint32_t ulBlockedAllocations;
+        uint8_t ucFlags;                           /*<< Holds bits to say if the pool was statically allocated or not. */
+    } Pool_t;
+
+/* The pool structure is placed in front of the blocks when a pool is created
+ * by xPoolCreate(), so its size is rounded up to keep the blocks aligned. */
+    #define poolSTRUCT_SIZE    ( ( sizeof( Pool_t ) + ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called after a pool has been created to build its free list and initialise
+ * its other members.
+ */
+    static void prvInitialiseNewPool( size_t xBlockSize,
+                                      UBaseType_t uxBlockCount,
+                                      uint8_t * pucPoolStorage,
+                                      Pool_t * pxNewPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove the first block from the free list, returning NULL if the list is
+ * empty.  The list is only updated with interrupts masked, using the same
+ * ATOMIC_ENTER_CRITICAL() / ATOMIC_EXIT_CRITICAL() pair as the functions in
+ * atomic.h, so no scheduler suspension or critical nesting count is needed
+ * and the function can be called from tasks and interrupts alike.  Popping a
+ * lock free stack with a compare-and-swap loop alone is not safe, as the
+ * block at the head of the list can be allocated and freed again between
+ * reading its next pointer and swapping the head (the ABA problem).
+ */
+    static void * prvPopBlock( Pool_t * const pxPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Place pvBlock at the front of the free list.
+ */
+    static void prvPushBlock( Pool_t * const pxPool,
+                              void * const pvBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Assert that pvBlock is the start of one of pxPool's blocks.
+ */
+    #if ( configASSERT_DEFINED == 1 )
+        static void prvCheckBlock( const Pool_t * const pxPool,
+                                   const void * const pvBlock ) PRIVILEGED_FUNCTION;
+    #else
+        #define prvCheckBlock( pxPool, pvBlock )
+    #endif
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        PoolHandle_t xPoolCreate( size_t xBlockSize,
+                                  UBaseType_t uxBlockCount )
+        {
+            Pool_t * pxNewPool = NULL;
+            size_t xStorageSize;
+
+            configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+
+            xStorageSize = poolSTORAGE_SIZE( xBlockSize, uxBlockCount );
+
+            if( /* Check the block size does not overflow when rounded up. */
+                ( poolBLOCK_SIZE( xBlockSize ) >= xBlockSize ) &&
+                /* Check for multiplication overflow. */
+                ( ( xStorageSize / poolBLOCK_SIZE( xBlockSize ) ) == ( size_t ) uxBlockCount ) &&
+                /* Check for addition overflow. */
+                ( ( SIZE_MAX - poolSTRUCT_SIZE ) >= xStorageSize ) )
+            {
+                /* Allocate the pool structure and its blocks together.  As
+                 * with queues, this assumes pvPortMalloc() returns memory
+                 * aligned to portBYTE_ALIGNMENT. */
+                pxNewPool = ( Pool_t * ) pvPortMalloc( poolSTRUCT_SIZE + xStorageSize ); /*lint !e9087 !e9079 see comment above. */
+
+                if( pxNewPool != NULL )
+                {
+                    pxNewPool->ucFlags = 0x00;
+                    prvInitialiseNewPool( xBlockSize, uxBlockCount, ( ( uint8_t * ) pxNewPool ) + poolSTRUCT_SIZE, pxNewPool );
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewPool;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        PoolHandle_t xPoolCreateStatic( size_t xBlockSize,
+                                        UBaseType_t uxBlockCount,
+                                        uint8_t * pucPoolStorage,
+                                        StaticPool_t * pxPoolBuffer )
+        {
+            Pool_t * pxNewPool;
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticPool_t equals the size of the real
+                 * pool structure. */
+                volatile size_t xSize = sizeof( StaticPool_t );
+                configASSERT( xSize == sizeof( Pool_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            /* A pointer to a StaticPool_t structure and an aligned storage area
+             * MUST be provided. */
+            configASSERT( pxPoolBuffer );
+            configASSERT( pucPoolStorage );
+            configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucPoolStorage ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+            configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+
+            pxNewPool = ( Pool_t * ) pxPoolBuffer; /*lint !e740 !e9087 StaticPool_t is a pointer to a Pool_t, so guaranteed to be aligned and sized correctly (checked by an assert()), so this is safe. */
+
+            if( pxNewPool != NULL )
+            {
+                pxNewPool->ucFlags = poolFLAGS_IS_STATICALLY_ALLOCATED;
+                prvInitialiseNewPool( xBlockSize, uxBlockCount, pucPoolStorage, pxNewPool );
+            }
+
+            return pxNewPool;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewPool( size_t xBlockSize,
+                                      UBaseType_t uxBlockCount,
+                                      uint8_t * pucPoolStorage,
+                                      Pool_t * pxNewPool )
+    {
+        UBaseType_t uxBlock;
+        PoolFreeBlock_t * pxBlock;
+
+        pxNewPool->pucStorage = pucPoolStorage;
+        pxNewPool->xBlockSize = poolBLOCK_SIZE( xBlockSize );
+        pxNewPool->uxBlockCount = uxBlockCount;
+        pxNewPool->uxFreeBlocks = uxBlockCount;
+        pxNewPool->uxMinimumEverFreeBlocks = uxBlockCount;
+        pxNewPool->ulAllocations = 0U;
+        pxNewPool->ulFrees = 0U;
+        pxNewPool->ulFailedAllocations = 0U;
+        pxNewPool->ulBlockedAllocations = 0U;
+        vListInitialise( &( pxNewPool->xTasksWaitingToAllocate ) );
+
+        /* Link the blocks in address order, so the first allocations come from
+         * the start of the storage area. */
+        pxNewPool->pxFreeList = ( PoolFreeBlock_t * ) pucPoolStorage; /*lint !e9087 !e826 The storage area is aligned to portBYTE_ALIGNMENT. */
+
+        for( uxBlock = ( UBaseType_t ) 0; uxBlock < uxBlockCount; uxBlock++ )
+        {
+            pxBlock = ( PoolFreeBlock_t * ) ( pucPoolStorage + ( ( size_t ) uxBlock * pxNewPool->xBlockSize ) ); /*lint !e9087 !e826 Blocks are a multiple of portBYTE_ALIGNMENT bytes. */
+
+            if( uxBlock < ( uxBlockCount - ( UBaseType_t ) 1 ) )
+            {
+                pxBlock->pxNextFreeBlock = ( PoolFreeBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxNewPool->xBlockSize ); /*lint !e9087 !e826 As above. */
+            }
+            else
+            {
+                pxBlock->pxNextFreeBlock = NULL;
+            }
+        }
+
+        traceMEMORY_POOL_CREATE( pxNewPool );
+    }
+/*-----------------------------------------------------------*/
+
+    void vPoolDelete( PoolHandle_t xPool )
+    {
+        Pool_t * pxPool = xPool;
+
+        configASSERT( pxPool );
+        configASSERT( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE );
+
+        traceMEMORY_POOL_DELETE( pxPool );
+
+        /* Only free the pool's memory if it was allocated dynamically. */
+        if( ( pxPool->ucFlags & poolFLAGS_IS_STATICALLY_ALLOCATED ) == 0 )
+        {
+            vPortFree( pxPool );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void * prvPopBlock( Pool_t * const pxPool )
+    {
+        PoolFreeBlock_t * pxBlock;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            pxBlock = pxPool->pxFreeList;
+
+            if( pxBlock != NULL )
+            {
+                pxPool->pxFreeList = pxBlock->pxNextFreeBlock;
+                pxPool->uxFreeBlocks--;
+                pxPool->ulAllocations++;
+
+                if( pxPool->uxFreeBlocks < pxPool->uxMinimumEverFreeBlocks )
+                {
+                    pxPool->uxMinimumEverFreeBlocks = pxPool->uxFreeBlocks;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return pxBlock;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvPushBlock( Pool_t * const pxPool,
+                              void * const pvBlock )
+    {
+        PoolFreeBlock_t * pxBlock = ( PoolFreeBlock_t * ) pvBlock; /*lint !e9087 !e9079 Blocks are aligned so can hold a pointer. */
+
+        prvCheckBlock( pxPool, pvBlock );
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            pxBlock->pxNextFreeBlock = pxPool->pxFreeList;
+            pxPool->pxFreeList = pxBlock;
+            pxPool->uxFreeBlocks++;
+            pxPool->ulFrees++;
+        }
+        ATOMIC_EXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configASSERT_DEFINED == 1 )
+
+        static void prvCheckBlock( const Pool_t * const pxPool,
+                                   const void * const pvBlock )
+        {
+            const uint8_t * const pucBlock = ( const uint8_t * ) pvBlock;
+            size_t xOffset;
+
+            /* The block must lie within the pool's storage area, on a block
+             * boundary.  Catches a block being freed to the wrong pool. */
+            configASSERT( pucBlock >= pxPool->pucStorage );
+            xOffset = ( size_t ) ( pucBlock - pxPool->pucStorage );
+            configASSERT( xOffset < ( pxPool->xBlockSize * ( size_t ) pxPool->uxBlockCount ) );
+            configASSERT( ( xOffset % pxPool->xBlockSize ) == 0U );
+
+            /* Remove compiler warnings about unused variables when
+             * configASSERT() expands to nothing. */
+            ( void ) xOffset;
+        }
+
+    #endif /* configASSERT_DEFINED */
+/*-----------------------------------------------------------*/
+
+    void * pvPoolAlloc( PoolHandle_t xPool,
+                        TickType_t xTicksToWait )
+    {
+        Pool_t * const pxPool = xPool;
+        void * pvReturn;
+        TimeOut_t xTimeOut;
+        BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
+
+        configASSERT( pxPool );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            /* The fast path - a block is available. */
+            pvReturn = prvPopBlock( pxPool );
+
+            if( ( pvReturn != NULL ) || ( xTicksToWait == ( TickType_t ) 0 ) )
+            {
+                break;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+            {
+                /* Timed out.  Loop once more in case a block was freed after
+                 * the timeout but before this task ran. */
+                xTicksToWait = ( TickType_t ) 0;
+                continue;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xYieldRequired = pdFALSE;
+
+            taskENTER_CRITICAL();
+            {
+                /* vPoolFree() pushes the block before it looks for a waiting
+                 * task, so checking the list is still empty from within the
+                 * critical section guarantees a block freed from now on will
+                 * find this task on the waiting list. */
+                if( pxPool->pxFreeList == NULL )
+                {
+                    pxPool->ulBlockedAllocations++;
+                    traceBLOCKING_ON_MEMORY_POOL( pxPool );
+                    vTaskPlaceOnEventList( &( pxPool->xTasksWaitingToAllocate ), xTicksToWait );
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xYieldRequired != pdFALSE )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        if( pvReturn == NULL )
+        {
+            taskENTER_CRITICAL();
+            {
+                pxPool->ulFailedAllocations++;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMEMORY_POOL_ALLOC( pxPool, pvReturn );
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvPoolAllocFromISR( PoolHandle_t xPool )
+    {
+        Pool_t * const pxPool = xPool;
+        void * pvReturn;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( pxPool );
+
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        pvReturn = prvPopBlock( pxPool );
+
+        if( pvReturn == NULL )
+        {
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                pxPool->ulFailedAllocations++;
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMEMORY_POOL_ALLOC_FROM_ISR( pxPool, pvReturn );
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPoolFree( PoolHandle_t xPool,
+                    void * pvBlock )
+    {
+        Pool_t * const pxPool = xPool;
+
+        configASSERT( pxPool );
+        configASSERT( pvBlock );
+
+        traceMEMORY_POOL_FREE( pxPool, pvBlock );
+
+        prvPushBlock( pxPool, pvBlock );
+
+        /* Only enter a critical section if a task might be waiting. */
+        if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+                    {
+                        /* The unblocked task has a priority above this task,
+                         * so yield.  The block is not reserved for the
+                         * unblocked task, which tries to allocate again when
+                         * it runs. */
+                        #if ( configUSE_PREEMPTION == 1 )
+                        {
+                            portYIELD_WITHIN_API();
+                        }
+                        #endif
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vPoolFreeFromISR( PoolHandle_t xPool,
+                           void * pvBlock,
+                           BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        Pool_t * const pxPool = xPool;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( pxPool );
+        configASSERT( pvBlock );
+
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        traceMEMORY_POOL_FREE_FROM_ISR( pxPool, pvBlock );
+
+        prvPushBlock( pxPool, pvBlock );
+
+        if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+        {
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxPoolGetFreeBlockCount( const PoolHandle_t xPool )
+    {
+        const Pool_t * const pxPool = xPool;
+
+        configASSERT( pxPool );
+
+        return pxPool->uxFreeBlocks;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPoolGetStats( const PoolHandle_t xPool,
+                        PoolStats_t * pxPoolStats )
+    {
+        const Pool_t * const pxPool = xPool;
+
+        configASSERT( pxPool );
+        configASSERT( pxPoolStats );
+
+        pxPoolStats->xBlockSize = pxPool->xBlockSize;
+        pxPoolStats->uxBlockCount = pxPool->uxBlockCount;
+
+        taskENTER_CRITICAL();
+        {
+            pxPoolStats->uxFreeBlocks = pxPool->uxFreeBlocks;
+            pxPoolStats->uxMinimumEverFreeBlocks = pxPool->uxMinimumEverFreeBlocks;
+            pxPoolStats->ulAllocations = pxPool->ulAllocations;
+            pxPoolStats->ulFrees = pxPool->ulFrees;
+            pxPoolStats->ulFailedAllocations = pxPool->ulFailedAllocations;
+            pxPoolStats->ulBlockedAllocations = pxPool->ulBlockedAllocations;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include memory pool functionality.  This #if is closed at the very bottom
+ * of this file.  If you want to include memory pools then ensure
+ * configUSE_MEMORY_POOLS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_MEMORY_POOLS == 1 */
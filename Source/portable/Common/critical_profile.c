@@ -0,0 +1,244 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/*
+ * Times critical sections and scheduler suspensions, so the worst case time
+ * for which interrupts are masked, and so the worst case interrupt latency the
+ * kernel adds, can be bounded from a running system.  Build this file with
+ * the kernel and set configRECORD_CRITICAL_SECTION_TIMES to 1 in
+ * FreeRTOSConfig.h.
+ *
+ * The port calls vCriticalSectionProfileEnter() and
+ * vCriticalSectionProfileExit() around the outermost critical section entered
+ * through portENTER_CRITICAL(), which is where taskENTER_CRITICAL() in the
+ * kernel and the application ends up, and tasks.c calls them around the
+ * outermost vTaskSuspendAll() and xTaskResumeAll().  Regions are timed with
+ * portCRITICAL_SECTION_TIMER_VALUE(), which the port defines as its cycle
+ * counter where it has one.  Only ports that call the functions record
+ * critical sections; interrupts masked with portSET_INTERRUPT_MASK_FROM_ISR()
+ * or portDISABLE_INTERRUPTS() are not timed.
+ *
+ * For each kind of region a log2 histogram of the times is kept, along with
+ * the configCRITICAL_SECTION_TOP_COUNT call sites that held the longest, so
+ * the application can find which code to shorten.  The call site is the
+ * return address into the function that entered the region.
+ */
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+
+    #if ( configCRITICAL_SECTION_TOP_COUNT < 1 )
+        #error configCRITICAL_SECTION_TOP_COUNT must be at least 1
+    #endif
+
+/* When and from where the open region of each kind was entered. */
+    PRIVILEGED_DATA static uint32_t ulEnterTime[ critprofKINDS ];
+    PRIVILEGED_DATA static void * pvEnterCaller[ critprofKINDS ];
+
+/* The longest region of each kind from each of the call sites kept, sorted
+ * longest first.  Unused entries have a time of 0 so sort last. */
+    PRIVILEGED_DATA static CriticalSectionRecord_t xLongest[ critprofKINDS ][ configCRITICAL_SECTION_TOP_COUNT ];
+
+    PRIVILEGED_DATA static uint32_t ulHistogram[ critprofKINDS ][ configCRITICAL_SECTION_BUCKETS ];
+
+/*-----------------------------------------------------------*/
+
+    void vCriticalSectionProfileEnter( uint8_t ucKind,
+                                       void * pvCaller )
+    {
+        configASSERT( ucKind < ( uint8_t ) critprofKINDS );
+
+        pvEnterCaller[ ucKind ] = pvCaller;
+        ulEnterTime[ ucKind ] = portCRITICAL_SECTION_TIMER_VALUE();
+    }
+/*-----------------------------------------------------------*/
+
+    void vCriticalSectionProfileExit( uint8_t ucKind )
+    {
+        uint32_t ulNow, ulCounts, ulRemaining;
+        CriticalSectionRecord_t * pxLongest;
+        CriticalSectionRecord_t xRecord;
+        UBaseType_t uxBucket = 0, x;
+
+        /* Read the timer first so the time spent here is not charged to the
+         * region. */
+        ulNow = portCRITICAL_SECTION_TIMER_VALUE();
+
+        configASSERT( ucKind < ( uint8_t ) critprofKINDS );
+
+        ulCounts = ulNow - ulEnterTime[ ucKind ];
+        pxLongest = xLongest[ ucKind ];
+
+        /* The bucket index is the number of significant bits in the time,
+         * limited to the last bucket. */
+        for( ulRemaining = ulCounts; ( ulRemaining != 0U ) && ( uxBucket < ( UBaseType_t ) ( configCRITICAL_SECTION_BUCKETS - 1 ) ); ulRemaining >>= 1 )
+        {
+            uxBucket++;
+        }
+
+        /* Halve every bucket rather than let one saturate so the shape of the
+         * histogram stays valid. */
+        if( ulHistogram[ ucKind ][ uxBucket ] == 0xffffffffUL )
+        {
+            for( x = 0; x < ( UBaseType_t ) configCRITICAL_SECTION_BUCKETS; x++ )
+            {
+                ulHistogram[ ucKind ][ x ] >>= 1;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        ulHistogram[ ucKind ][ uxBucket ]++;
+
+        /* Nothing changes unless the region was longer than the shortest one
+         * kept, which is also no longer than any kept for the same call
+         * site, so most exits stop here. */
+        if( ulCounts > pxLongest[ configCRITICAL_SECTION_TOP_COUNT - 1 ].ulCounts )
+        {
+            /* Update the call site's entry if it has one, otherwise replace
+             * the shortest entry. */
+            for( x = 0; x < ( UBaseType_t ) ( configCRITICAL_SECTION_TOP_COUNT - 1 ); x++ )
+            {
+                if( pxLongest[ x ].pvCaller == pvEnterCaller[ ucKind ] )
+                {
+                    break;
+                }
+            }
+
+            if( ulCounts > pxLongest[ x ].ulCounts )
+            {
+                pxLongest[ x ].pvCaller = pvEnterCaller[ ucKind ];
+                pxLongest[ x ].ulCounts = ulCounts;
+
+                /* Move the entry up to keep the table sorted. */
+                while( ( x > 0U ) && ( pxLongest[ x - 1U ].ulCounts < ulCounts ) )
+                {
+                    xRecord = pxLongest[ x - 1U ];
+                    pxLongest[ x - 1U ] = pxLongest[ x ];
+                    pxLongest[ x ] = xRecord;
+                    x--;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxCriticalSectionGetLongest( uint8_t ucKind,
+                                             CriticalSectionRecord_t * pxRecords,
+                                             UBaseType_t uxMaxRecords )
+    {
+        UBaseType_t x = 0;
+
+        configASSERT( ucKind < ( uint8_t ) critprofKINDS );
+        configASSERT( pxRecords != NULL );
+
+        /* The tables are updated as each critical section is left, so are
+         * read in a critical section.  The region this adds is recorded after
+         * the copy is taken. */
+        taskENTER_CRITICAL();
+        {
+            while( ( x < uxMaxRecords ) &&
+                   ( x < ( UBaseType_t ) configCRITICAL_SECTION_TOP_COUNT ) &&
+                   ( xLongest[ ucKind ][ x ].ulCounts != 0U ) )
+            {
+                pxRecords[ x ] = xLongest[ ucKind ][ x ];
+                x++;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return x;
+    }
+/*-----------------------------------------------------------*/
+
+    void vCriticalSectionGetHistogram( uint8_t ucKind,
+                                       uint32_t * pulHistogram )
+    {
+        UBaseType_t x;
+
+        configASSERT( ucKind < ( uint8_t ) critprofKINDS );
+        configASSERT( pulHistogram != NULL );
+
+        taskENTER_CRITICAL();
+        {
+            for( x = 0; x < ( UBaseType_t ) configCRITICAL_SECTION_BUCKETS; x++ )
+            {
+                pulHistogram[ x ] = ulHistogram[ ucKind ][ x ];
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vCriticalSectionResetProfile( void )
+    {
+        UBaseType_t uxKind, x;
+
+        /* The times of the regions that are open are kept so they are still
+         * recorded when they end. */
+        taskENTER_CRITICAL();
+        {
+            for( uxKind = 0; uxKind < ( UBaseType_t ) critprofKINDS; uxKind++ )
+            {
+                for( x = 0; x < ( UBaseType_t ) configCRITICAL_SECTION_TOP_COUNT; x++ )
+                {
+                    xLongest[ uxKind ][ x ].pvCaller = NULL;
+                    xLongest[ uxKind ][ x ].ulCounts = 0U;
+                }
+
+                for( x = 0; x < ( UBaseType_t ) configCRITICAL_SECTION_BUCKETS; x++ )
+                {
+                    ulHistogram[ uxKind ][ x ] = 0U;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configRECORD_CRITICAL_SECTION_TIMES */
@@ -334,7 +334,18 @@ void xPortPendSVHandler( void )
         "	ldr	r2, [r3]						\n"
         "										\n"
         "	subs r0, r0, #32					\n"/* Make space for the remaining low registers. */
-        "	str r0, [r2]						\n"/* Save the new top of stack. */
+        "	str r0, [r2]						\n"/* Save the new top of stack, which the stack checks test as the registers are stored after them. */
+        "										\n"
+        "	push {r0, r2, r3, r14}				\n"
+        "	cpsid i								\n"
+        "	bl vTaskSwitchContext				\n"
+        "	cpsie i								\n"
+        "	pop {r0, r1, r2, r3}				\n"/* r1 holds the old TCB, r2 the TCB pointer and lr goes in r3. */
+        "										\n"
+        "	ldr r2, [r2]						\n"
+        "	cmp r2, r1							\n"/* If the same task was selected its registers were never */
+        "	beq 1f								\n"/* touched, so there is nothing to save or restore. */
+        "										\n"
         "	stmia r0!, {r4-r7}					\n"/* Store the low registers that are not saved automatically. */
         " 	mov r4, r8							\n"/* Store the high registers. */
         " 	mov r5, r9							\n"
@@ -342,14 +353,7 @@ void xPortPendSVHandler( void )
         " 	mov r7, r11							\n"
         " 	stmia r0!, {r4-r7}					\n"
         "										\n"
-        "	push {r3, r14}						\n"
-        "	cpsid i								\n"
-        "	bl vTaskSwitchContext				\n"
-        "	cpsie i								\n"
-        "	pop {r2, r3}						\n"/* lr goes in r3. r2 now holds tcb pointer. */
-        "										\n"
-        "	ldr r1, [r2]						\n"
-        "	ldr r0, [r1]						\n"/* The first item in pxCurrentTCB is the task top of stack. */
+        "	ldr r0, [r2]						\n"/* The first item in pxCurrentTCB is the task top of stack. */
         "	adds r0, r0, #16					\n"/* Move to the high registers. */
         "	ldmia r0!, {r4-r7}					\n"/* Pop the high registers. */
         " 	mov r8, r4							\n"
@@ -361,7 +365,7 @@ void xPortPendSVHandler( void )
         "										\n"
         "	subs r0, r0, #32					\n"/* Go back for the low registers that are not automatically restored. */
         " 	ldmia r0!, {r4-r7}					\n"/* Pop low registers.  */
-        "										\n"
+        "1:										\n"
         "	bx r3								\n"
         "										\n"
         "	.align 4							\n"
@@ -55,6 +55,14 @@
 #define portNVIC_PEND_SYSTICK_SET_BIT         ( 1UL << 26UL )
 #define portNVIC_PEND_SYSTICK_CLEAR_BIT       ( 1UL << 25UL )
 
+/* The debug registers that start the DWT cycle counter used to time critical
+ * sections. */
+#define portDEMCR_REG                         ( *( ( volatile uint32_t * ) 0xe000edfc ) )
+#define portDWT_CTRL_REG                      ( *( ( volatile uint32_t * ) 0xe0001000 ) )
+#define portDEMCR_TRCENA_BIT                  ( 1UL << 24UL )
+#define portDWT_CTRL_NOCYCCNT_BIT             ( 1UL << 25UL )
+#define portDWT_CTRL_CYCCNTENA_BIT            ( 1UL << 0UL )
+
 #define portNVIC_PENDSV_PRI                   ( ( ( uint32_t ) configKERNEL_INTERRUPT_PRIORITY ) << 16UL )
 #define portNVIC_SYSTICK_PRI                  ( ( ( uint32_t ) configKERNEL_INTERRUPT_PRIORITY ) << 24UL )
 
@@ -340,6 +348,17 @@ BaseType_t xPortStartScheduler( void )
      * here already. */
     vPortSetupTimerInterrupt();
 
+    #if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+    {
+        /* Start the cycle counter that times critical sections.  Critical
+         * sections are only timed once the scheduler is running, when the
+         * nesting count is first 0. */
+        portDEMCR_REG |= portDEMCR_TRCENA_BIT;
+        configASSERT( ( portDWT_CTRL_REG & portDWT_CTRL_NOCYCCNT_BIT ) == 0 );
+        portDWT_CTRL_REG |= portDWT_CTRL_CYCCNTENA_BIT;
+    }
+    #endif
+
     /* Initialise the critical nesting count ready for the first task. */
     uxCriticalNesting = 0;
 
@@ -381,6 +400,12 @@ void vPortEnterCritical( void )
     if( uxCriticalNesting == 1 )
     {
         configASSERT( ( portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK ) == 0 );
+
+        #if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+        {
+            vCriticalSectionProfileEnter( critprofCRITICAL_SECTION, portCRITICAL_SECTION_CALLER() );
+        }
+        #endif
     }
 }
 /*-----------------------------------------------------------*/
@@ -392,6 +417,12 @@ void vPortExitCritical( void )
 
     if( uxCriticalNesting == 0 )
     {
+        #if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+        {
+            vCriticalSectionProfileExit( critprofCRITICAL_SECTION );
+        }
+        #endif
+
         portENABLE_INTERRUPTS();
     }
 }
@@ -409,22 +440,28 @@ void xPortPendSVHandler( void )
         "	ldr	r3, pxCurrentTCBConst			\n"/* Get the location of the current TCB. */
         "	ldr	r2, [r3]						\n"
         "										\n"
-        "	stmdb r0!, {r4-r11}					\n"/* Save the remaining registers. */
-        "	str r0, [r2]						\n"/* Save the new top of stack into the first member of the TCB. */
+        "	sub r0, r0, #32						\n"/* Where the remaining registers are saved if the task is switched out. */
+        "	str r0, [r2]						\n"/* Save the new top of stack into the first member of the TCB.  The registers are stored after the stack checks, so the checks test this value. */
         "										\n"
-        "	stmdb sp!, {r3, r14}				\n"
+        "	stmdb sp!, {r0, r2, r3, r14}		\n"
         "	mov r0, %0							\n"
         "	msr basepri, r0						\n"
         "	bl vTaskSwitchContext				\n"
         "	mov r0, #0							\n"
         "	msr basepri, r0						\n"
-        "	ldmia sp!, {r3, r14}				\n"
-        "										\n"/* Restore the context, including the critical nesting count. */
+        "	ldmia sp!, {r0, r2, r3, r14}		\n"
+        "										\n"
         "	ldr r1, [r3]						\n"
-        "	ldr r0, [r1]						\n"/* The first item in pxCurrentTCB is the task top of stack. */
+        "	cmp r1, r2							\n"/* If the same task was selected its registers were never */
+        "	beq 1f								\n"/* touched, so there is nothing to save or restore. */
+        "										\n"
+        "	stmia r0, {r4-r11}					\n"/* Save the remaining registers. */
+        "										\n"/* Restore the context, including the critical nesting count. */
+        "	ldr r0, [r1]						\n"
         "	ldmia r0!, {r4-r11}					\n"/* Pop the registers. */
         "	msr psp, r0							\n"
         "	isb									\n"
+        "1:										\n"
         "	bx r14								\n"
         "										\n"
         "	.align 4							\n"
@@ -75,6 +75,13 @@
     #define portTICK_PERIOD_MS    ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
     #define portBYTE_ALIGNMENT    8
     #define portDONT_DISCARD      __attribute__( ( used ) )
+
+/* The stack a task needs for its saved context on top of what its own code
+ * uses: the eight words the processor stacks on exception entry, the word it
+ * can add to keep the frame eight byte aligned, and the eight words (r4 to
+ * r11) saved by xPortPendSVHandler().  Interrupts run on the main stack, so
+ * nesting them does not add to it. */
+    #define portTASK_CONTEXT_STACK_WORDS    ( 17 )
 /*-----------------------------------------------------------*/
 
 /* Scheduler utilities. */
@@ -105,6 +112,12 @@
     #define portENTER_CRITICAL()                      vPortEnterCritical()
     #define portEXIT_CRITICAL()                       vPortExitCritical()
 
+/* The DWT cycle counter, which times critical sections when
+ * configRECORD_CRITICAL_SECTION_TIMES is 1.  xPortStartScheduler() starts it. */
+    #ifndef portCRITICAL_SECTION_TIMER_VALUE
+        #define portCRITICAL_SECTION_TIMER_VALUE()    ( *( ( volatile uint32_t * ) 0xe0001004 ) )
+    #endif
+
 /*-----------------------------------------------------------*/
 
 /* Task function macros as described on the FreeRTOS.org WEB site.  These are
@@ -451,14 +451,14 @@ void xPortPendSVHandler( void )
         "	ldr	r3, pxCurrentTCBConst			\n"/* Get the location of the current TCB. */
         "	ldr	r2, [r3]						\n"
         "										\n"
-        "	tst r14, #0x10						\n"/* Is the task using the FPU context?  If so, push high vfp registers. */
+        "	tst r14, #0x10						\n"/* Is the task using the FPU context?  If so, make space for the high vfp registers. */
         "	it eq								\n"
-        "	vstmdbeq r0!, {s16-s31}				\n"
+        "	subeq r0, r0, #64					\n"
         "										\n"
-        "	stmdb r0!, {r4-r11, r14}			\n"/* Save the core registers. */
-        "	str r0, [r2]						\n"/* Save the new top of stack into the first member of the TCB. */
+        "	sub r0, r0, #36						\n"/* Make space for the core registers. */
+        "	str r0, [r2]						\n"/* Save the new top of stack into the first member of the TCB.  The registers are stored after the stack checks, so the checks test this value. */
         "										\n"
-        "	stmdb sp!, {r0, r3}					\n"
+        "	stmdb sp!, {r0, r2, r3, r14}		\n"
         "	mov r0, %0 							\n"
         "	msr basepri, r0						\n"
         "	dsb									\n"
@@ -466,10 +466,19 @@ void xPortPendSVHandler( void )
         "	bl vTaskSwitchContext				\n"
         "	mov r0, #0							\n"
         "	msr basepri, r0						\n"
-        "	ldmia sp!, {r0, r3}					\n"
+        "	ldmia sp!, {r0, r2, r3, r14}		\n"
+        "										\n"
+        "	ldr r1, [r3]						\n"
+        "	cmp r1, r2							\n"/* If the same task was selected its registers were never */
+        "	beq 1f								\n"/* touched, so there is nothing to save or restore. */
+        "										\n"
+        "	stmia r0!, {r4-r11, r14}			\n"/* Save the core registers. */
+        "										\n"
+        "	tst r14, #0x10						\n"/* Is the task using the FPU context?  If so, push high vfp registers. */
+        "	it eq								\n"
+        "	vstmiaeq r0!, {s16-s31}				\n"
         "										\n"
-        "	ldr r1, [r3]						\n"/* The first item in pxCurrentTCB is the task top of stack. */
-        "	ldr r0, [r1]						\n"
+        "	ldr r0, [r1]						\n"/* The first item in pxCurrentTCB is the task top of stack. */
         "										\n"
         "	ldmia r0!, {r4-r11, r14}			\n"/* Pop the core registers. */
         "										\n"
@@ -479,6 +488,7 @@ void xPortPendSVHandler( void )
         "										\n"
         "	msr psp, r0							\n"
         "	isb									\n"
+        "1:										\n"
         "										\n"
         #ifdef WORKAROUND_PMU_CM001 /* XMC4000 specific errata workaround. */
             #if WORKAROUND_PMU_CM001 == 1
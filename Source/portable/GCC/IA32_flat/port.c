@@ -89,6 +89,9 @@ context. */
 /* If configASSERT() is defined then the system stack is filled with this value
 to allow for a crude stack overflow check. */
 #define portSTACK_WORD					( 0xecececec )
+
+/* The APIC timer runs from the processor clock divided by 16. */
+#define portAPIC_TIMER_COUNTS_FOR_ONE_TICK	( ( configCPU_CLOCK_HZ >> 4UL ) / configTICK_RATE_HZ )
 /*-----------------------------------------------------------*/
 
 /*
@@ -132,6 +135,16 @@ extern void vPortTimerHandler( void );
  */
 static BaseType_t prvCheckValidityOfVectorNumber( uint32_t ulVectorNumber );
 
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/*
+	 * Called by the tick interrupt handler to put the APIC timer back into
+	 * periodic mode after vPortSuppressTicksAndSleep() left it in one shot mode.
+	 */
+	void vPortRestorePeriodicTick( void );
+
+#endif /* configUSE_TICKLESS_IDLE */
+
 /*-----------------------------------------------------------*/
 
 /* A variable is used to keep track of the critical section nesting.  This
@@ -199,6 +212,15 @@ volatile uint32_t ulPortYieldPending __attribute__((used)) = pdFALSE;
 interrupt/system stack and when to save/restore a complete context. */
 volatile uint32_t ulInterruptNesting __attribute__((used)) = 0;
 
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/* Set while the APIC timer is counting down in one shot mode because the
+	tick was suppressed.  The tick interrupt handler checks it to know when to
+	put the timer back into periodic mode. */
+	volatile uint32_t ulPortTimerOneShot __attribute__((used)) = pdFALSE;
+
+#endif /* configUSE_TICKLESS_IDLE */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -366,10 +388,136 @@ extern void vPortAPICSpuriousHandler( void );
 
 	/* Set the interrupt frequency. */
 	portAPIC_TMRDIV = portAPIC_DIV_16;
-	portAPIC_TIMER_INITIAL_COUNT = ( ( configCPU_CLOCK_HZ >> 4UL ) / configTICK_RATE_HZ ) - 1UL;
+	portAPIC_TIMER_INITIAL_COUNT = portAPIC_TIMER_COUNTS_FOR_ONE_TICK - 1UL;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	void vPortRestorePeriodicTick( void )
+	{
+		portAPIC_LVT_TIMER = portAPIC_TIMER_PERIODIC | portAPIC_TIMER_INT_VECTOR;
+		portAPIC_TIMER_INITIAL_COUNT = portAPIC_TIMER_COUNTS_FOR_ONE_TICK - 1UL;
+		ulPortTimerOneShot = pdFALSE;
+	}
+	/*-----------------------------------------------------------*/
+
+	__attribute__(( weak )) void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	uint32_t ulCountsToNextTick, ulSleepCounts, ulCountsLeft, ulCountsSlept;
+	TickType_t xModifiableIdleTime, xTicksPassed;
+	const TickType_t xMaximumPossibleSuppressedTicks = ( TickType_t ) ( 0xffffffffUL / portAPIC_TIMER_COUNTS_FOR_ONE_TICK );
+
+		/* Make sure the one shot count does not overflow the counter. */
+		if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+		{
+			xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+		}
+
+		/* Disable interrupts completely, not just by raising the task priority
+		register, as the interrupt that ends the sleep must not run until the
+		timer has been reprogrammed. */
+		__asm volatile( "cli" ::: "memory" );
+
+		/* If a context switch is pending or a task is waiting for the scheduler
+		to be unsuspended then abandon the low power entry. */
+		if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+		{
+			__asm volatile( "sti" ::: "memory" );
+		}
+		else
+		{
+			/* Replace the periodic tick with a single count down that ends at
+			the tick at which the expected idle time ends.  Writing the initial
+			count restarts the timer. */
+			ulCountsToNextTick = portAPIC_TIMER_CURRENT_COUNT;
+			ulSleepCounts = ulCountsToNextTick + ( portAPIC_TIMER_COUNTS_FOR_ONE_TICK * ( uint32_t ) ( xExpectedIdleTime - 1 ) );
+			portAPIC_LVT_TIMER = portAPIC_TIMER_INT_VECTOR;
+			portAPIC_TIMER_INITIAL_COUNT = ulSleepCounts;
+			ulPortTimerOneShot = pdTRUE;
+
+			if( ( portAPIC_TIMER_IRR & portAPIC_TIMER_IRR_BIT ) != 0 )
+			{
+				/* The periodic timer reached zero between being read and being
+				reprogrammed, so a tick is due now.  Go back to periodic mode,
+				which starts a new tick period, and let the pending tick
+				interrupt run. */
+				vPortRestorePeriodicTick();
+				__asm volatile( "sti" ::: "memory" );
+			}
+			else
+			{
+				/* Sleep until something happens.  configPRE_SLEEP_PROCESSING()
+				can set its parameter to 0 to indicate that its implementation
+				contains its own halt instruction, and so hlt should not be
+				executed again.  hlt only wakes on an interrupt that is taken, so
+				the interrupt that ends the sleep runs before hlt completes.  sti
+				does not take effect until after the instruction that follows it,
+				so the interrupt cannot be taken before the processor halts. */
+				xModifiableIdleTime = xExpectedIdleTime;
+				configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+
+				if( xModifiableIdleTime > 0 )
+				{
+					__asm volatile( "sti		\n\t"
+									"hlt		\n\t"
+									"cli" ::: "memory" );
+				}
+
+				configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+				ulCountsLeft = portAPIC_TIMER_CURRENT_COUNT;
+
+				if( ( ulPortTimerOneShot == pdFALSE ) || ( ulCountsLeft == 0 ) )
+				{
+					/* The count down finished.  The tick interrupt has either
+					already run, or will run as soon as interrupts are enabled,
+					and counts the tick at which the idle time ends, so step the
+					tick count over the ones before it.  The interrupt also puts
+					the timer back into periodic mode. */
+					xTicksPassed = xExpectedIdleTime - 1;
+				}
+				else
+				{
+					/* Something other than the tick woke the processor.  Step the
+					tick count over the tick periods that have completed, and
+					count down to the end of the period the processor is in, at
+					which point the tick interrupt puts the timer back into
+					periodic mode. */
+					ulCountsSlept = ulSleepCounts - ulCountsLeft;
+
+					if( ulCountsSlept >= ulCountsToNextTick )
+					{
+						xTicksPassed = ( TickType_t ) ( ( ulCountsSlept - ulCountsToNextTick ) / portAPIC_TIMER_COUNTS_FOR_ONE_TICK ) + 1;
+					}
+					else
+					{
+						xTicksPassed = 0;
+					}
+
+					ulCountsToNextTick = ulCountsLeft % portAPIC_TIMER_COUNTS_FOR_ONE_TICK;
+
+					if( ulCountsToNextTick == 0 )
+					{
+						ulCountsToNextTick = portAPIC_TIMER_COUNTS_FOR_ONE_TICK;
+					}
+
+					portAPIC_TIMER_INITIAL_COUNT = ulCountsToNextTick;
+				}
+
+				if( xTicksPassed > 0 )
+				{
+					vTaskStepTick( xTicksPassed );
+				}
+
+				__asm volatile( "sti" ::: "memory" );
+			}
+		}
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
 BaseType_t xPortStartScheduler( void )
 {
 BaseType_t xWord;
@@ -106,6 +106,12 @@ in the portYIELD_INTERRUPT definition immediately below. */
 #define portAPIC_LVT_LINT0 				( *( ( volatile uint32_t * ) ( configAPIC_BASE + 0x350UL ) ) )
 #define portAPIC_LVT_LINT1 				( *( ( volatile uint32_t * ) ( configAPIC_BASE + 0x360UL ) ) )
 
+/* The interrupt request register, and the bit in it, that show a timer
+interrupt is pending.  The IRR is eight 32-bit registers spaced 16 bytes
+apart. */
+#define portAPIC_TIMER_IRR				( *( ( volatile uint32_t * ) ( configAPIC_BASE + 0x200UL + ( ( portAPIC_TIMER_INT_VECTOR >> 5UL ) << 4UL ) ) ) )
+#define portAPIC_TIMER_IRR_BIT			( 1UL << ( portAPIC_TIMER_INT_VECTOR & 0x1fUL ) )
+
 /* Don't yield if inside a critical section - instead hold the yield pending
 so it is performed when the critical section is exited. */
 #define portYIELD() 								\
@@ -179,6 +185,14 @@ macros is used. */
 
 #define portNOP() __asm volatile( "NOP" )
 
+/* Tickless idle/low power functionality. */
+#if configUSE_TICKLESS_IDLE == 1
+	#ifndef portSUPPRESS_TICKS_AND_SLEEP
+		extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+		#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+	#endif
+#endif
+
 /*-----------------------------------------------------------
  * Misc
  *----------------------------------------------------------*/
@@ -84,6 +84,15 @@
  */
 void vPortSetupTimerInterrupt( void ) __attribute__(( weak ));
 
+#if( configUSE_TICKLESS_IDLE == 1 ) && ( configMTIME_BASE_ADDRESS != 0 ) && ( configMTIMECMP_BASE_ADDRESS != 0 )
+
+    /*
+     * Read the 64-bit machine timer.
+     */
+    static uint64_t prvReadMachineTime( void );
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Used to program the machine timer compare register. */
@@ -154,6 +163,130 @@ size_t xTaskReturnAddress = ( size_t ) portTASK_RETURN_ADDRESS;
 #endif /* ( configMTIME_BASE_ADDRESS != 0 ) && ( configMTIME_BASE_ADDRESS != 0 ) */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TICKLESS_IDLE == 1 ) && ( configMTIME_BASE_ADDRESS != 0 ) && ( configMTIMECMP_BASE_ADDRESS != 0 )
+
+    static uint64_t prvReadMachineTime( void )
+    {
+    uint32_t ulCurrentTimeHigh, ulCurrentTimeLow;
+    volatile uint32_t * const pulTimeHigh = ( volatile uint32_t * const ) ( ( configMTIME_BASE_ADDRESS ) + 4UL ); /* 8-byte type so high 32-bit word is 4 bytes up. */
+    volatile uint32_t * const pulTimeLow = ( volatile uint32_t * const ) ( configMTIME_BASE_ADDRESS );
+
+        do
+        {
+            ulCurrentTimeHigh = *pulTimeHigh;
+            ulCurrentTimeLow = *pulTimeLow;
+        } while( ulCurrentTimeHigh != *pulTimeHigh );
+
+        return ( ( uint64_t ) ulCurrentTimeHigh << 32ULL ) | ( uint64_t ) ulCurrentTimeLow;
+    }
+    /*-----------------------------------------------------------*/
+
+    __attribute__(( weak )) void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+    uint64_t ullTickTime, ullCurrentTime;
+    TickType_t xModifiableIdleTime, xTicksPassed;
+
+        /* The machine timer keeps counting while the core sleeps, so the tick
+         * interrupts are suppressed by moving the compare value on instead of
+         * stopping the timer.  The tick interrupts stay on the same boundaries,
+         * so the tick count does not drift however often the core sleeps. */
+
+        #if( __riscv_xlen == 64 )
+        {
+            /* Keep the compare value calculation within 64 bits. */
+            if( xExpectedIdleTime > ( TickType_t ) 0xffffffffUL )
+            {
+                xExpectedIdleTime = ( TickType_t ) 0xffffffffUL;
+            }
+        }
+        #endif
+
+        /* Disable interrupts.  wfi still completes when an interrupt enabled
+         * in mie becomes pending, but the interrupt is not taken until
+         * interrupts are enabled again below. */
+        portDISABLE_INTERRUPTS();
+
+        /* If a context switch is pending or a task is waiting for the scheduler
+         * to be unsuspended then abandon the low power entry. */
+        if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+        {
+            portENABLE_INTERRUPTS();
+        }
+        else
+        {
+            /* ullNextTime is always one tick period beyond the compare value,
+             * which holds the time of the next tick interrupt. */
+            ullTickTime = ullNextTime - ( uint64_t ) uxTimerIncrementsForOneTick;
+
+            /* Move the compare value on to the tick at which the expected idle
+             * time ends.  Interrupts are disabled, so it does not matter in
+             * which order the two halves are written on a 32-bit core. */
+            *pullMachineTimerCompareRegister = ullTickTime + ( ( uint64_t ) uxTimerIncrementsForOneTick * ( uint64_t ) ( xExpectedIdleTime - 1 ) );
+
+            /* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
+             * set its parameter to 0 to indicate that its implementation
+             * contains its own wait for interrupt instruction, and so wfi
+             * should not be executed again. */
+            xModifiableIdleTime = xExpectedIdleTime;
+            configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+
+            if( xModifiableIdleTime > 0 )
+            {
+                __asm volatile( "wfi" );
+            }
+
+            configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+            /* Count the tick interrupts that were suppressed, up to the one at
+             * which the expected idle time ends. */
+            ullCurrentTime = prvReadMachineTime();
+
+            if( ullCurrentTime < ullTickTime )
+            {
+                xTicksPassed = 0;
+            }
+            else
+            {
+                xTicksPassed = ( TickType_t ) ( ( ullCurrentTime - ullTickTime ) / ( uint64_t ) uxTimerIncrementsForOneTick ) + 1;
+
+                if( xTicksPassed > xExpectedIdleTime )
+                {
+                    xTicksPassed = xExpectedIdleTime;
+                }
+            }
+
+            if( xTicksPassed == 0 )
+            {
+                /* Woken before the next tick was due, so just put the compare
+                 * value back. */
+                *pullMachineTimerCompareRegister = ullTickTime;
+            }
+            else
+            {
+                /* Leave the last tick that passed to the tick interrupt, which
+                 * is taken as soon as interrupts are enabled because its compare
+                 * value is already in the past, and step the tick count over
+                 * the ones before it.  The interrupt then programs the compare
+                 * value for the tick after from ullNextTime as usual. */
+                ullTickTime += ( uint64_t ) uxTimerIncrementsForOneTick * ( uint64_t ) ( xTicksPassed - 1 );
+                *pullMachineTimerCompareRegister = ullTickTime;
+                ullNextTime = ullTickTime + ( uint64_t ) uxTimerIncrementsForOneTick;
+
+                if( xTicksPassed > 1 )
+                {
+                    vTaskStepTick( xTicksPassed - 1 );
+                }
+            }
+
+            /* ullNextTime must be written before the tick interrupt can run. */
+            portMEMORY_BARRIER();
+            portENABLE_INTERRUPTS();
+        }
+    }
+
+#endif /* ( configUSE_TICKLESS_IDLE == 1 ) && ( configMTIME_BASE_ADDRESS != 0 ) && ( configMTIMECMP_BASE_ADDRESS != 0 ) */
+/*-----------------------------------------------------------*/
+
 BaseType_t xPortStartScheduler( void )
 {
 extern void xPortStartFirstTask( void );
@@ -164,6 +164,16 @@ extern size_t xCriticalNesting;
 #define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
 /*-----------------------------------------------------------*/
 
+/* Tickless idle/low power functionality.  The implementation in port.c needs
+ * the machine timer, so chips without one must provide their own. */
+#if( configUSE_TICKLESS_IDLE == 1 )
+    #ifndef portSUPPRESS_TICKS_AND_SLEEP
+        extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+        #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+    #endif
+#endif
+/*-----------------------------------------------------------*/
+
 /* configCLINT_BASE_ADDRESS is a legacy definition that was replaced by the
  * configMTIME_BASE_ADDRESS and configMTIMECMP_BASE_ADDRESS definitions.  For
  * backward compatibility derive the newer definitions from the old if the old
@@ -244,6 +244,14 @@ void * pvPortMalloc( size_t xWantedSize )
         }
 
         traceMALLOC( pvReturn, xWantedSize );
+
+        #if ( configUSE_HEAP_TRACE == 1 )
+        {
+            /* Record the size of the block used, which is what the free of the
+             * block records, or the size wanted if the allocation failed. */
+            vHeapTraceRecord( heapTRACE_MALLOC, pvReturn, ( pvReturn != NULL ) ? ( pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) : xWantedSize, xFreeBytesRemaining, portHEAP_TRACE_CALLER() );
+        }
+        #endif
     }
     ( void ) xTaskResumeAll();
 
@@ -297,6 +305,11 @@ void vPortFree( void * pv )
                     prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
                     xFreeBytesRemaining += pxLink->xBlockSize;
                     traceFREE( pv, pxLink->xBlockSize );
+                    #if ( configUSE_HEAP_TRACE == 1 )
+                    {
+                        vHeapTraceRecord( heapTRACE_FREE, pv, pxLink->xBlockSize, xFreeBytesRemaining, portHEAP_TRACE_CALLER() );
+                    }
+                    #endif
                 }
                 ( void ) xTaskResumeAll();
             }
@@ -98,6 +98,9 @@ typedef struct A_BLOCK_LINK
 {
     struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next free block in the list. */
     size_t xBlockSize;                     /*<< The size of the free block. */
+    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        void * pvOwner;                    /*<< The task charged for an allocated block. */
+    #endif
 } BlockLink_t;
 
 /*-----------------------------------------------------------*/
@@ -126,6 +129,13 @@ static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( p
 PRIVILEGED_DATA static BlockLink_t xStart;
 PRIVILEGED_DATA static BlockLink_t * pxEnd = NULL;
 
+#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+/* The first block in the heap, where vPortDisownHeapBlocks() starts its walk,
+ * or NULL if the heap has not been initialised. */
+    PRIVILEGED_DATA static BlockLink_t * pxHeapStart = NULL;
+#endif
+
 /* Keeps track of the number of calls to allocate and free memory as well as the
  * number of free bytes remaining, but says nothing about fragmentation. */
 PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
@@ -196,6 +206,25 @@ void * pvPortMalloc( size_t xWantedSize )
                     pxBlock = pxBlock->pxNextFreeBlock;
                 }
 
+                #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+                {
+                    /* Fail the allocation if the block would take the calling
+                     * task over its heap quota.  The task is charged for the
+                     * whole block, which is only cut down to the wanted size if
+                     * the remainder is large enough to be split off. */
+                    if( ( pxBlock != pxEnd ) &&
+                        ( xTaskHeapQuotaAvailable( ( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE ) ? xWantedSize : pxBlock->xBlockSize ) == pdFALSE ) )
+                    {
+                        traceHEAP_QUOTA_EXCEEDED( xWantedSize );
+                        pxBlock = pxEnd;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_TASK_HEAP_ACCOUNTING */
+
                 /* If the end marker was reached then a block of adequate size
                  * was not found. */
                 if( pxBlock != pxEnd )
@@ -243,6 +272,13 @@ void * pvPortMalloc( size_t xWantedSize )
                         mtCOVERAGE_TEST_MARKER();
                     }
 
+                    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+                    {
+                        /* Charge the block to the calling task. */
+                        pxBlock->pvOwner = xTaskHeapCharge( pxBlock->xBlockSize );
+                    }
+                    #endif
+
                     /* The block is being returned - it is allocated and owned
                      * by the application and has no "next" block. */
                     heapALLOCATE_BLOCK( pxBlock );
@@ -265,6 +301,14 @@ void * pvPortMalloc( size_t xWantedSize )
         }
 
         traceMALLOC( pvReturn, xWantedSize );
+
+        #if ( configUSE_HEAP_TRACE == 1 )
+        {
+            /* Record the size of the block used, which is what the free of the
+             * block records, or the size wanted if the allocation failed. */
+            vHeapTraceRecord( heapTRACE_MALLOC, pvReturn, ( pvReturn != NULL ) ? ( pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) : xWantedSize, xFreeBytesRemaining, portHEAP_TRACE_CALLER() );
+        }
+        #endif
     }
     ( void ) xTaskResumeAll();
 
@@ -320,7 +364,17 @@ void vPortFree( void * pv )
                 {
                     /* Add this block to the list of free blocks. */
                     xFreeBytesRemaining += pxLink->xBlockSize;
+                    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+                    {
+                        vTaskHeapRelease( pxLink->pvOwner, pxLink->xBlockSize );
+                    }
+                    #endif
                     traceFREE( pv, pxLink->xBlockSize );
+                    #if ( configUSE_HEAP_TRACE == 1 )
+                    {
+                        vHeapTraceRecord( heapTRACE_FREE, pv, pxLink->xBlockSize, xFreeBytesRemaining, portHEAP_TRACE_CALLER() );
+                    }
+                    #endif
                     prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
                     xNumberOfSuccessfulFrees++;
                 }
@@ -408,6 +462,11 @@ static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
     pxEnd = ( BlockLink_t * ) uxAddress;
     pxEnd->xBlockSize = 0;
     pxEnd->pxNextFreeBlock = NULL;
+    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+    {
+        pxHeapStart = ( BlockLink_t * ) pucAlignedHeap;
+    }
+    #endif
 
     /* To start with there is a single free block that is sized to take up the
      * entire heap space, minus the space taken by pxEnd. */
@@ -484,6 +543,50 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVI
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+/*
+ * Every byte of the heap belongs to exactly one block, so the blocks are walked
+ * in address order by adding each block's size to its address, from
+ * pxHeapStart until pxEnd is reached or blocks totalling xBytesOwned have been
+ * found. */
+    void vPortDisownHeapBlocks( void * pvOwner,
+                                size_t xBytesOwned )
+    {
+        BlockLink_t * pxBlock;
+        size_t xBlockSize;
+
+        vTaskSuspendAll();
+        {
+            /* pxBlock will be NULL if the heap has not been initialised. */
+            pxBlock = pxHeapStart;
+
+            while( ( pxBlock != NULL ) && ( pxBlock != pxEnd ) && ( xBytesOwned > ( size_t ) 0 ) )
+            {
+                xBlockSize = pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
+
+                if( ( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 ) && ( pxBlock->pvOwner == pvOwner ) )
+                {
+                    pxBlock->pvOwner = NULL;
+
+                    /* The owner may have freed blocks since xBytesOwned was
+                     * read, so it can only ever be too large. */
+                    xBytesOwned -= ( xBlockSize < xBytesOwned ) ? xBlockSize : xBytesOwned;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxBlock = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xBlockSize );
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+#endif /* configUSE_TASK_HEAP_ACCOUNTING */
+/*-----------------------------------------------------------*/
+
 void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 {
     BlockLink_t * pxBlock;
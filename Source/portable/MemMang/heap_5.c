@@ -49,6 +49,7 @@
  * {
  *  uint8_t *pucStartAddress; << Start address of a block of memory that will be part of the heap.
  *  size_t xSizeInBytes;      << Size of the block of memory.
+ *  uint32_t ulAttributes;    << heapREGION_ bits describing the memory, or 0.
  * } HeapRegion_t;
  *
  * The array is terminated using a NULL zero sized region definition, and the
@@ -58,15 +59,38 @@
  *
  * HeapRegion_t xHeapRegions[] =
  * {
- *  { ( uint8_t * ) 0x80000000UL, 0x10000 }, << Defines a block of 0x10000 bytes starting at address 0x80000000
- *  { ( uint8_t * ) 0x90000000UL, 0xa0000 }, << Defines a block of 0xa0000 bytes starting at address of 0x90000000
- *  { NULL, 0 }                << Terminates the array.
+ *  { ( uint8_t * ) 0x80000000UL, 0x10000, 0 }, << Defines a block of 0x10000 bytes starting at address 0x80000000
+ *  { ( uint8_t * ) 0x90000000UL, 0xa0000, 0 }, << Defines a block of 0xa0000 bytes starting at address of 0x90000000
+ *  { NULL, 0, 0 }                << Terminates the array.
  * };
  *
  * vPortDefineHeapRegions( xHeapRegions ); << Pass the array into vPortDefineHeapRegions().
  *
  * Note 0x80000000 is the lower address so appears in the array first.
  *
+ * Each region keeps its own free list, so the region a block comes from can be
+ * chosen.  The ulAttributes member of HeapRegion_t describes the memory, for
+ * example heapREGION_FAST for tightly coupled RAM:
+ *
+ * HeapRegion_t xHeapRegions[] =
+ * {
+ *  { ( uint8_t * ) 0x20000000UL, 0x4000, heapREGION_FAST }, << Tightly coupled RAM.
+ *  { ( uint8_t * ) 0x60000000UL, 0x80000, 0 },              << External RAM.
+ *  { NULL, 0, 0 }
+ * };
+ *
+ * pvPortMallocFrom() allocates from one region, given by its index in the
+ * array, and pvPortMallocWithHint() prefers the regions that have all the given
+ * attributes but falls back to any other region.  pvPortMalloc() uses regions
+ * that are not marked heapREGION_FAST before those that are, so fast memory is
+ * left for the allocations that ask for it - set
+ * configUSE_FAST_HEAP_REGION_FOR_TASKS to 1 to have the kernel ask for it for
+ * task stacks and TCBs.  xPortGetHeapRegionStats() reports the state of a
+ * single region.
+ *
+ * A small structure describing each region is placed at the start of the
+ * region, so each region provides slightly less heap than its size.
+ *
  */
 #include <stdlib.h>
 #include <string.h>
@@ -114,6 +138,14 @@
 #define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
 #define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
 
+/* The return address recorded by the heap trace.  pvPortMalloc() and its
+ * variants share prvHeapAllocate(), so the caller is taken in each of them. */
+#if ( configUSE_HEAP_TRACE == 1 )
+    #define heapCALLER()    portHEAP_TRACE_CALLER()
+#else
+    #define heapCALLER()    NULL
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Define the linked list structure.  This is used to link free blocks in order
@@ -122,17 +154,79 @@ typedef struct A_BLOCK_LINK
 {
     struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next free block in the list. */
     size_t xBlockSize;                     /*<< The size of the free block. */
+    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        void * pvOwner;                    /*<< The task charged for an allocated block. */
+    #endif
 } BlockLink_t;
 
+/* Describes one of the regions passed to vPortDefineHeapRegions().  The
+ * structure is placed at the start of the region it describes, so any number of
+ * regions can be defined.  Each region has its own free list, which starts at
+ * xStart and is terminated by the end marker pxEnd placed at the top of the
+ * region, so the region a block comes from can be chosen. */
+typedef struct A_HEAP_REGION_LINK
+{
+    BlockLink_t xStart;                            /*<< Marks the start of the region's list of free blocks. */
+    BlockLink_t * pxEnd;                           /*<< Marks the end of the region's list of free blocks. */
+    struct A_HEAP_REGION_LINK * pxNextRegion;      /*<< The next region, in the order they were defined. */
+    uint32_t ulAttributes;                         /*<< The heapREGION_ bits from HeapRegion_t. */
+    size_t xFreeBytesRemaining;                    /*<< As the heap wide variables of the same name, but for this region only. */
+    size_t xMinimumEverFreeBytesRemaining;
+    size_t xNumberOfSuccessfulAllocations;
+    size_t xNumberOfSuccessfulFrees;
+} HeapRegionLink_t;
+
 /*-----------------------------------------------------------*/
 
 /*
  * Inserts a block of memory that is being freed into the correct position in
- * the list of free memory blocks.  The block being freed will be merged with
- * the block in front it and/or the block behind it if the memory blocks are
- * adjacent to each other.
+ * the list of free memory blocks of the region it belongs to.  The block being
+ * freed will be merged with the block in front it and/or the block behind it
+ * if the memory blocks are adjacent to each other.
+ */
+static void prvInsertBlockIntoFreeList( HeapRegionLink_t * pxRegion,
+                                        BlockLink_t * pxBlockToInsert );
+
+/*
+ * Allocates a block of xWantedSize bytes, which already includes the block
+ * header, from pxRegion's free list, or returns NULL if the region does not
+ * have a large enough free block.  *pxQuotaExceeded is set to pdTRUE if a
+ * block was found but would take the calling task over its heap quota.
+ */
+static void * prvAllocateFromRegion( HeapRegionLink_t * pxRegion,
+                                     size_t xWantedSize,
+                                     BaseType_t * const pxQuotaExceeded );
+
+/*
+ * The implementation of pvPortMalloc() and its variants.  If pxOnlyRegion is
+ * not NULL the block can only come from that region.  Otherwise the regions
+ * whose attributes, masked by ulAttributeMask, equal ulAttributes are tried
+ * first, then all other regions, each in the order they were defined.
+ */
+static void * prvHeapAllocate( size_t xWantedSize,
+                               HeapRegionLink_t * pxOnlyRegion,
+                               uint32_t ulAttributeMask,
+                               uint32_t ulAttributes,
+                               void * pvCaller );
+
+/*
+ * Returns the region that contains pv, or NULL if pv is not in the heap.
+ */
+static HeapRegionLink_t * prvGetRegionOf( const void * pv );
+
+/*
+ * Returns the region at index xRegion in the array passed to
+ * vPortDefineHeapRegions(), or NULL if there is no such region.
+ */
+static HeapRegionLink_t * prvGetRegion( BaseType_t xRegion );
+
+/*
+ * Counts the free blocks in pxRegion and updates *pxMaxSize and *pxMinSize
+ * with the largest and smallest of them.
  */
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert );
+static size_t prvScanFreeList( const HeapRegionLink_t * pxRegion,
+                               size_t * pxMaxSize,
+                               size_t * pxMinSize );
 
 /*-----------------------------------------------------------*/
 
@@ -140,12 +234,16 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert );
  * block must by correctly byte aligned. */
 static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
 
-/* Create a couple of list links to mark the start and end of the list. */
-static BlockLink_t xStart;
-static BlockLink_t * pxEnd = NULL;
+/* Likewise the structure placed at the start of each region. */
+static const size_t xRegionStructSize = ( sizeof( HeapRegionLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The first region defined, or NULL before vPortDefineHeapRegions() is
+ * called. */
+static HeapRegionLink_t * pxFirstRegion = NULL;
 
 /* Keeps track of the number of calls to allocate and free memory as well as the
- * number of free bytes remaining, but says nothing about fragmentation. */
+ * number of free bytes remaining, but says nothing about fragmentation.  These
+ * are totals across all the regions. */
 static size_t xFreeBytesRemaining = 0U;
 static size_t xMinimumEverFreeBytesRemaining = 0U;
 static size_t xNumberOfSuccessfulAllocations = 0;
@@ -155,15 +253,62 @@ static size_t xNumberOfSuccessfulFrees = 0;
 
 void * pvPortMalloc( size_t xWantedSize )
 {
-    BlockLink_t * pxBlock;
-    BlockLink_t * pxPreviousBlock;
-    BlockLink_t * pxNewBlockLink;
+    /* Keep fast regions for the allocations that ask for them, unless there is
+     * no space elsewhere. */
+    return prvHeapAllocate( xWantedSize, NULL, heapREGION_FAST, 0U, heapCALLER() );
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocWithHint( uint32_t ulAttributes,
+                             size_t xWantedSize )
+{
+    return prvHeapAllocate( xWantedSize, NULL, ulAttributes, ulAttributes, heapCALLER() );
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocFrom( BaseType_t xRegion,
+                         size_t xWantedSize )
+{
+    HeapRegionLink_t * pxRegion;
+    void * pvReturn = NULL;
+
+    /* The heap must be initialised before the first call to
+     * prvPortMalloc(). */
+    configASSERT( pxFirstRegion );
+
+    pxRegion = prvGetRegion( xRegion );
+    configASSERT( pxRegion );
+
+    if( pxRegion != NULL )
+    {
+        pvReturn = prvHeapAllocate( xWantedSize, pxRegion, 0U, 0U, heapCALLER() );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvHeapAllocate( size_t xWantedSize,
+                               HeapRegionLink_t * pxOnlyRegion,
+                               uint32_t ulAttributeMask,
+                               uint32_t ulAttributes,
+                               void * pvCaller )
+{
+    HeapRegionLink_t * pxRegion;
     void * pvReturn = NULL;
     size_t xAdditionalRequiredSize;
+    BaseType_t xQuotaExceeded = pdFALSE;
 
     /* The heap must be initialised before the first call to
      * prvPortMalloc(). */
-    configASSERT( pxEnd );
+    configASSERT( pxFirstRegion );
+
+    /* Only used by the heap trace. */
+    ( void ) pvCaller;
 
     vTaskSuspendAll();
     {
@@ -196,72 +341,38 @@ void * pvPortMalloc( size_t xWantedSize )
         {
             if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
             {
-                /* Traverse the list from the start (lowest address) block until
-                 * one of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = xStart.pxNextFreeBlock;
-
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+                if( pxOnlyRegion != NULL )
                 {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = pxBlock->pxNextFreeBlock;
+                    pvReturn = prvAllocateFromRegion( pxOnlyRegion, xWantedSize, &xQuotaExceeded );
                 }
-
-                /* If the end marker was reached then a block of adequate size
-                 * was not found. */
-                if( pxBlock != pxEnd )
+                else
                 {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
-
-                    /* This block is being returned for use so must be taken out
-                     * of the list of free blocks. */
-                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
-
-                    /* If the block is larger than required it can be split into
-                     * two. */
-                    if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                    /* First the regions that have the wanted attributes... */
+                    for( pxRegion = pxFirstRegion; ( pxRegion != NULL ) && ( pvReturn == NULL ); pxRegion = pxRegion->pxNextRegion )
                     {
-                        /* This block is to be split into two.  Create a new
-                         * block following the number of bytes requested. The void
-                         * cast is used to prevent byte alignment warnings from the
-                         * compiler. */
-                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-
-                        /* Calculate the sizes of two blocks split from the
-                         * single block. */
-                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-                        pxBlock->xBlockSize = xWantedSize;
-
-                        /* Insert the new block into the list of free blocks. */
-                        prvInsertBlockIntoFreeList( ( pxNewBlockLink ) );
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
+                        if( ( pxRegion->ulAttributes & ulAttributeMask ) == ulAttributes )
+                        {
+                            pvReturn = prvAllocateFromRegion( pxRegion, xWantedSize, &xQuotaExceeded );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
                     }
 
-                    xFreeBytesRemaining -= pxBlock->xBlockSize;
-
-                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
-                    {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
-                    }
-                    else
+                    /* ...then any other region, as the attributes are only a
+                     * hint. */
+                    for( pxRegion = pxFirstRegion; ( pxRegion != NULL ) && ( pvReturn == NULL ); pxRegion = pxRegion->pxNextRegion )
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        if( ( pxRegion->ulAttributes & ulAttributeMask ) != ulAttributes )
+                        {
+                            pvReturn = prvAllocateFromRegion( pxRegion, xWantedSize, &xQuotaExceeded );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
                     }
-
-                    /* The block is being returned - it is allocated and owned
-                     * by the application and has no "next" block. */
-                    heapALLOCATE_BLOCK( pxBlock );
-                    pxBlock->pxNextFreeBlock = NULL;
-                    xNumberOfSuccessfulAllocations++;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
                 }
             }
             else
@@ -274,7 +385,29 @@ void * pvPortMalloc( size_t xWantedSize )
             mtCOVERAGE_TEST_MARKER();
         }
 
+        #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        {
+            /* Only report the quota once no region had a block within it. */
+            if( ( pvReturn == NULL ) && ( xQuotaExceeded != pdFALSE ) )
+            {
+                traceHEAP_QUOTA_EXCEEDED( xWantedSize );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_TASK_HEAP_ACCOUNTING */
+
         traceMALLOC( pvReturn, xWantedSize );
+
+        #if ( configUSE_HEAP_TRACE == 1 )
+        {
+            /* Record the size of the block used, which is what the free of the
+             * block records, or the size wanted if the allocation failed. */
+            vHeapTraceRecord( heapTRACE_MALLOC, pvReturn, ( pvReturn != NULL ) ? ( ( ( const BlockLink_t * ) ( ( ( uint8_t * ) pvReturn ) - xHeapStructSize ) )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) : xWantedSize, xFreeBytesRemaining, pvCaller );
+        }
+        #endif
     }
     ( void ) xTaskResumeAll();
 
@@ -295,10 +428,140 @@ void * pvPortMalloc( size_t xWantedSize )
 }
 /*-----------------------------------------------------------*/
 
+static void * prvAllocateFromRegion( HeapRegionLink_t * pxRegion,
+                                     size_t xWantedSize,
+                                     BaseType_t * const pxQuotaExceeded )
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxPreviousBlock;
+    BlockLink_t * pxNewBlockLink;
+    void * pvReturn = NULL;
+
+    if( xWantedSize <= pxRegion->xFreeBytesRemaining )
+    {
+        /* Traverse the list from the start (lowest address) block until
+         * one of adequate size is found. */
+        pxPreviousBlock = &( pxRegion->xStart );
+        pxBlock = pxRegion->xStart.pxNextFreeBlock;
+
+        while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+        {
+            pxPreviousBlock = pxBlock;
+            pxBlock = pxBlock->pxNextFreeBlock;
+        }
+
+        #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        {
+            /* Do not use the block if it would take the calling task over its
+             * heap quota.  The task is charged for the whole block, which is
+             * only cut down to the wanted size if the remainder is large
+             * enough to be split off. */
+            if( ( pxBlock != pxRegion->pxEnd ) &&
+                ( xTaskHeapQuotaAvailable( ( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE ) ? xWantedSize : pxBlock->xBlockSize ) == pdFALSE ) )
+            {
+                *pxQuotaExceeded = pdTRUE;
+                pxBlock = pxRegion->pxEnd;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else /* if ( configUSE_TASK_HEAP_ACCOUNTING == 1 ) */
+        {
+            ( void ) pxQuotaExceeded;
+        }
+        #endif /* configUSE_TASK_HEAP_ACCOUNTING */
+
+        /* If the end marker was reached then a block of adequate size
+         * was not found. */
+        if( pxBlock != pxRegion->pxEnd )
+        {
+            /* Return the memory space pointed to - jumping over the
+             * BlockLink_t structure at its start. */
+            pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
+
+            /* This block is being returned for use so must be taken out
+             * of the list of free blocks. */
+            pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+            /* If the block is larger than required it can be split into
+             * two. */
+            if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+            {
+                /* This block is to be split into two.  Create a new
+                 * block following the number of bytes requested. The void
+                 * cast is used to prevent byte alignment warnings from the
+                 * compiler. */
+                pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+
+                /* Calculate the sizes of two blocks split from the
+                 * single block. */
+                pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                pxBlock->xBlockSize = xWantedSize;
+
+                /* Insert the new block into the list of free blocks. */
+                prvInsertBlockIntoFreeList( pxRegion, pxNewBlockLink );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxRegion->xFreeBytesRemaining -= pxBlock->xBlockSize;
+            xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+            if( pxRegion->xFreeBytesRemaining < pxRegion->xMinimumEverFreeBytesRemaining )
+            {
+                pxRegion->xMinimumEverFreeBytesRemaining = pxRegion->xFreeBytesRemaining;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+            {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+            {
+                /* Charge the block to the calling task. */
+                pxBlock->pvOwner = xTaskHeapCharge( pxBlock->xBlockSize );
+            }
+            #endif
+
+            /* The block is being returned - it is allocated and owned
+             * by the application and has no "next" block. */
+            heapALLOCATE_BLOCK( pxBlock );
+            pxBlock->pxNextFreeBlock = NULL;
+            pxRegion->xNumberOfSuccessfulAllocations++;
+            xNumberOfSuccessfulAllocations++;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
 void vPortFree( void * pv )
 {
     uint8_t * puc = ( uint8_t * ) pv;
     BlockLink_t * pxLink;
+    HeapRegionLink_t * pxRegion;
 
     if( pv != NULL )
     {
@@ -327,10 +590,25 @@ void vPortFree( void * pv )
 
                 vTaskSuspendAll();
                 {
+                    pxRegion = prvGetRegionOf( pxLink );
+                    configASSERT( pxRegion );
+
                     /* Add this block to the list of free blocks. */
+                    pxRegion->xFreeBytesRemaining += pxLink->xBlockSize;
                     xFreeBytesRemaining += pxLink->xBlockSize;
+                    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+                    {
+                        vTaskHeapRelease( pxLink->pvOwner, pxLink->xBlockSize );
+                    }
+                    #endif
                     traceFREE( pv, pxLink->xBlockSize );
-                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                    #if ( configUSE_HEAP_TRACE == 1 )
+                    {
+                        vHeapTraceRecord( heapTRACE_FREE, pv, pxLink->xBlockSize, xFreeBytesRemaining, portHEAP_TRACE_CALLER() );
+                    }
+                    #endif
+                    prvInsertBlockIntoFreeList( pxRegion, pxLink );
+                    pxRegion->xNumberOfSuccessfulFrees++;
                     xNumberOfSuccessfulFrees++;
                 }
                 ( void ) xTaskResumeAll();
@@ -379,14 +657,15 @@ void * pvPortCalloc( size_t xNum,
 }
 /*-----------------------------------------------------------*/
 
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
+static void prvInsertBlockIntoFreeList( HeapRegionLink_t * pxRegion,
+                                        BlockLink_t * pxBlockToInsert )
 {
     BlockLink_t * pxIterator;
     uint8_t * puc;
 
     /* Iterate through the list until a block is found that has a higher address
      * than the block being inserted. */
-    for( pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+    for( pxIterator = &( pxRegion->xStart ); pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
     {
         /* Nothing to do here, just iterate to the right position. */
     }
@@ -411,7 +690,7 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
 
     if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
     {
-        if( pxIterator->pxNextFreeBlock != pxEnd )
+        if( pxIterator->pxNextFreeBlock != pxRegion->pxEnd )
         {
             /* Form one big block from the two blocks. */
             pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
@@ -419,7 +698,7 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
         }
         else
         {
-            pxBlockToInsert->pxNextFreeBlock = pxEnd;
+            pxBlockToInsert->pxNextFreeBlock = pxRegion->pxEnd;
         }
     }
     else
@@ -442,10 +721,52 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert )
 }
 /*-----------------------------------------------------------*/
 
+static HeapRegionLink_t * prvGetRegionOf( const void * pv )
+{
+    HeapRegionLink_t * pxRegion;
+
+    /* Each region extends from its HeapRegionLink_t to its end marker. */
+    for( pxRegion = pxFirstRegion; pxRegion != NULL; pxRegion = pxRegion->pxNextRegion )
+    {
+        if( ( ( const uint8_t * ) pv > ( const uint8_t * ) pxRegion ) && ( ( const uint8_t * ) pv < ( const uint8_t * ) pxRegion->pxEnd ) )
+        {
+            break;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return pxRegion;
+}
+/*-----------------------------------------------------------*/
+
+static HeapRegionLink_t * prvGetRegion( BaseType_t xRegion )
+{
+    HeapRegionLink_t * pxRegion = NULL;
+
+    if( xRegion >= 0 )
+    {
+        for( pxRegion = pxFirstRegion; ( pxRegion != NULL ) && ( xRegion > 0 ); pxRegion = pxRegion->pxNextRegion )
+        {
+            xRegion--;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxRegion;
+}
+/*-----------------------------------------------------------*/
+
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
 {
-    BlockLink_t * pxFirstFreeBlockInRegion = NULL;
-    BlockLink_t * pxPreviousFreeBlock;
+    HeapRegionLink_t * pxRegion;
+    HeapRegionLink_t * pxPreviousRegion = NULL;
+    BlockLink_t * pxFirstFreeBlockInRegion;
     portPOINTER_SIZE_TYPE xAlignedHeap;
     size_t xTotalRegionSize, xTotalHeapSize = 0;
     BaseType_t xDefinedRegions = 0;
@@ -453,7 +774,7 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
     const HeapRegion_t * pxHeapRegion;
 
     /* Can only call once! */
-    configASSERT( pxEnd == NULL );
+    configASSERT( pxFirstRegion == NULL );
 
     pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
 
@@ -475,51 +796,56 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
 
         xAlignedHeap = xAddress;
 
-        /* Set xStart if it has not already been set. */
-        if( xDefinedRegions == 0 )
-        {
-            /* xStart is used to hold a pointer to the first item in the list of
-             *  free blocks.  The void cast is used to prevent compiler warnings. */
-            xStart.pxNextFreeBlock = ( BlockLink_t * ) xAlignedHeap;
-            xStart.xBlockSize = ( size_t ) 0;
-        }
-        else
-        {
-            /* Should only get here if one region has already been added to the
-             * heap. */
-            configASSERT( pxEnd != NULL );
+        /* The region must hold its HeapRegionLink_t, its end marker and at
+         * least one block. */
+        configASSERT( xTotalRegionSize > ( xRegionStructSize + ( xHeapStructSize * 3 ) ) );
 
-            /* Check blocks are passed in with increasing start addresses. */
-            configASSERT( xAddress > ( size_t ) pxEnd );
-        }
+        /* Check blocks are passed in with increasing start addresses. */
+        configASSERT( ( pxPreviousRegion == NULL ) || ( xAddress > ( portPOINTER_SIZE_TYPE ) pxPreviousRegion->pxEnd ) );
 
-        /* Remember the location of the end marker in the previous region, if
-         * any. */
-        pxPreviousFreeBlock = pxEnd;
+        /* The region is described by a HeapRegionLink_t at its start.  The
+         * void cast is used to prevent compiler warnings. */
+        pxRegion = ( HeapRegionLink_t * ) ( void * ) xAlignedHeap;
+        pxRegion->pxNextRegion = NULL;
+        pxRegion->ulAttributes = pxHeapRegion->ulAttributes;
+        pxRegion->xNumberOfSuccessfulAllocations = 0;
+        pxRegion->xNumberOfSuccessfulFrees = 0;
 
         /* pxEnd is used to mark the end of the list of free blocks and is
          * inserted at the end of the region space. */
         xAddress = xAlignedHeap + xTotalRegionSize;
         xAddress -= xHeapStructSize;
         xAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
-        pxEnd = ( BlockLink_t * ) xAddress;
-        pxEnd->xBlockSize = 0;
-        pxEnd->pxNextFreeBlock = NULL;
+        pxRegion->pxEnd = ( BlockLink_t * ) xAddress;
+        pxRegion->pxEnd->xBlockSize = 0;
+        pxRegion->pxEnd->pxNextFreeBlock = NULL;
 
         /* To start with there is a single free block in this region that is
          * sized to take up the entire heap region minus the space taken by the
-         * free block structure. */
-        pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAlignedHeap;
+         * region and free block structures. */
+        pxFirstFreeBlockInRegion = ( BlockLink_t * ) ( xAlignedHeap + xRegionStructSize );
         pxFirstFreeBlockInRegion->xBlockSize = ( size_t ) ( xAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlockInRegion );
-        pxFirstFreeBlockInRegion->pxNextFreeBlock = pxEnd;
+        pxFirstFreeBlockInRegion->pxNextFreeBlock = pxRegion->pxEnd;
+
+        /* xStart is used to hold a pointer to the first item in the region's
+         * list of free blocks. */
+        pxRegion->xStart.pxNextFreeBlock = pxFirstFreeBlockInRegion;
+        pxRegion->xStart.xBlockSize = ( size_t ) 0;
 
-        /* If this is not the first region that makes up the entire heap space
-         * then link the previous region to this region. */
-        if( pxPreviousFreeBlock != NULL )
+        pxRegion->xFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+        pxRegion->xMinimumEverFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+
+        /* Add the region to the end of the list of regions. */
+        if( pxPreviousRegion == NULL )
+        {
+            pxFirstRegion = pxRegion;
+        }
+        else
         {
-            pxPreviousFreeBlock->pxNextFreeBlock = pxFirstFreeBlockInRegion;
+            pxPreviousRegion->pxNextRegion = pxRegion;
         }
 
+        pxPreviousRegion = pxRegion;
         xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
 
         /* Move onto the next HeapRegion_t structure. */
@@ -535,46 +861,97 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
 }
 /*-----------------------------------------------------------*/
 
-void vPortGetHeapStats( HeapStats_t * pxHeapStats )
-{
-    BlockLink_t * pxBlock;
-    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
 
-    vTaskSuspendAll();
+/*
+ * Every byte of a region after its HeapRegionLink_t belongs to exactly one
+ * block, so the blocks are walked in address order by adding each block's size
+ * to its address until the region's end marker is reached, or until blocks
+ * totalling xBytesOwned have been found. */
+    void vPortDisownHeapBlocks( void * pvOwner,
+                                size_t xBytesOwned )
     {
-        pxBlock = xStart.pxNextFreeBlock;
+        HeapRegionLink_t * pxRegion;
+        BlockLink_t * pxBlock;
+        size_t xBlockSize;
 
-        /* pxBlock will be NULL if the heap has not been initialised.  The heap
-         * is initialised automatically when the first allocation is made. */
-        if( pxBlock != NULL )
+        vTaskSuspendAll();
         {
-            while( pxBlock != pxEnd )
+            for( pxRegion = pxFirstRegion; ( pxRegion != NULL ) && ( xBytesOwned > ( size_t ) 0 ); pxRegion = pxRegion->pxNextRegion )
             {
-                /* Increment the number of blocks and record the largest block seen
-                 * so far. */
-                xBlocks++;
+                pxBlock = ( BlockLink_t * ) ( ( ( uint8_t * ) pxRegion ) + xRegionStructSize );
 
-                if( pxBlock->xBlockSize > xMaxSize )
+                while( ( pxBlock != pxRegion->pxEnd ) && ( xBytesOwned > ( size_t ) 0 ) )
                 {
-                    xMaxSize = pxBlock->xBlockSize;
-                }
+                    xBlockSize = pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
 
-                /* Heap five will have a zero sized block at the end of each
-                 * each region - the block is only used to link to the next
-                 * heap region so it not a real block. */
-                if( pxBlock->xBlockSize != 0 )
-                {
-                    if( pxBlock->xBlockSize < xMinSize )
+                    if( ( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 ) && ( pxBlock->pvOwner == pvOwner ) )
                     {
-                        xMinSize = pxBlock->xBlockSize;
+                        pxBlock->pvOwner = NULL;
+
+                        /* The owner may have freed blocks since xBytesOwned was
+                         * read, so it can only ever be too large. */
+                        xBytesOwned -= ( xBlockSize < xBytesOwned ) ? xBlockSize : xBytesOwned;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
                     }
-                }
 
-                /* Move to the next block in the chain until the last block is
-                 * reached. */
-                pxBlock = pxBlock->pxNextFreeBlock;
+                    pxBlock = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xBlockSize );
+                }
             }
         }
+        ( void ) xTaskResumeAll();
+    }
+
+#endif /* configUSE_TASK_HEAP_ACCOUNTING */
+/*-----------------------------------------------------------*/
+
+static size_t prvScanFreeList( const HeapRegionLink_t * pxRegion,
+                               size_t * pxMaxSize,
+                               size_t * pxMinSize )
+{
+    const BlockLink_t * pxBlock = pxRegion->xStart.pxNextFreeBlock;
+    size_t xBlocks = 0;
+
+    while( pxBlock != pxRegion->pxEnd )
+    {
+        /* Increment the number of blocks and record the largest and smallest
+         * blocks seen so far. */
+        xBlocks++;
+
+        if( pxBlock->xBlockSize > *pxMaxSize )
+        {
+            *pxMaxSize = pxBlock->xBlockSize;
+        }
+
+        if( pxBlock->xBlockSize < *pxMinSize )
+        {
+            *pxMinSize = pxBlock->xBlockSize;
+        }
+
+        /* Move to the next block in the chain until the last block is
+         * reached. */
+        pxBlock = pxBlock->pxNextFreeBlock;
+    }
+
+    return xBlocks;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    HeapRegionLink_t * pxRegion;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        /* pxFirstRegion will be NULL if the heap has not been initialised. */
+        for( pxRegion = pxFirstRegion; pxRegion != NULL; pxRegion = pxRegion->pxNextRegion )
+        {
+            xBlocks += prvScanFreeList( pxRegion, &xMaxSize, &xMinSize );
+        }
     }
     ( void ) xTaskResumeAll();
 
@@ -592,3 +969,36 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
     taskEXIT_CRITICAL();
 }
 /*-----------------------------------------------------------*/
+
+BaseType_t xPortGetHeapRegionStats( BaseType_t xRegion,
+                                    HeapStats_t * pxHeapStats )
+{
+    HeapRegionLink_t * pxRegion;
+    size_t xMaxSize = 0, xMinSize = portMAX_DELAY;
+    BaseType_t xReturn = pdFAIL;
+
+    vTaskSuspendAll();
+    {
+        pxRegion = prvGetRegion( xRegion );
+
+        if( pxRegion != NULL )
+        {
+            pxHeapStats->xNumberOfFreeBlocks = prvScanFreeList( pxRegion, &xMaxSize, &xMinSize );
+            pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+            pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+            pxHeapStats->xAvailableHeapSpaceInBytes = pxRegion->xFreeBytesRemaining;
+            pxHeapStats->xNumberOfSuccessfulAllocations = pxRegion->xNumberOfSuccessfulAllocations;
+            pxHeapStats->xNumberOfSuccessfulFrees = pxRegion->xNumberOfSuccessfulFrees;
+            pxHeapStats->xMinimumEverFreeBytesRemaining = pxRegion->xMinimumEverFreeBytesRemaining;
+            xReturn = pdPASS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
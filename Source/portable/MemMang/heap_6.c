@@ -0,0 +1,793 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that allocates and
+ * frees in constant time, regardless of how many free blocks there are, using
+ * a two level segregated fit (TLSF) scheme.  Like heap_5.c the heap can be
+ * defined across multiple non-contiguous regions, and adjacent free blocks are
+ * combined (coalesced) as soon as they are freed.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of https://www.FreeRTOS.org
+ * for more information.
+ *
+ * heap_4.c and heap_5.c search a single address ordered free list, so the time
+ * taken by pvPortMalloc() and vPortFree() grows with the number of free blocks
+ * and so with fragmentation.  heap_6.c instead keeps one free list per size
+ * class.  Block sizes are split into power of two ranges (the first level),
+ * each of which is split into 2^configHEAP_TLSF_SL_INDEX_COUNT_LOG2 linear
+ * ranges (the second level).  A bitmap records which lists are not empty, so a
+ * free block at least as large as a request is found with two find-first-set
+ * operations, and the block immediately before and after any block in memory
+ * is found from the block's header, so freeing never searches either.  A
+ * request is rounded up to the next size class before the search, so the
+ * first block found is always large enough - this is a good fit rather than a
+ * best fit.
+ *
+ * Usage notes:
+ *
+ * As with heap_5.c, vPortDefineHeapRegions() ***must*** be called before
+ * pvPortMalloc(), and so before any task objects (tasks, queues, event groups,
+ * etc.) are created.  It takes an array of HeapRegion_t structures terminated
+ * by a NULL zero sized region, for example:
+ *
+ * HeapRegion_t xHeapRegions[] =
+ * {
+ *  { ( uint8_t * ) 0x80000000UL, 0x10000, 0 }, << Defines a block of 0x10000 bytes starting at address 0x80000000
+ *  { ( uint8_t * ) 0x90000000UL, 0xa0000, 0 }, << Defines a block of 0xa0000 bytes starting at address of 0x90000000
+ *  { NULL, 0, 0 }                << Terminates the array.
+ * };
+ *
+ * vPortDefineHeapRegions( xHeapRegions ); << Pass the array into vPortDefineHeapRegions().
+ *
+ * Unlike heap_5.c the regions do not need to be in address order.  No block can
+ * be larger than 2^( configHEAP_TLSF_FL_INDEX_MAX + 1 ) bytes, so a region
+ * larger than that is truncated.
+ *
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* The log2 of the number of second level size classes each power of two range
+ * of block sizes is divided into.  More classes waste less memory to rounding
+ * but make the free list table larger. */
+#ifndef configHEAP_TLSF_SL_INDEX_COUNT_LOG2
+    #define configHEAP_TLSF_SL_INDEX_COUNT_LOG2    3
+#endif
+
+/* The log2 of the largest power of two range of block sizes, so the largest
+ * block is just under 2^( configHEAP_TLSF_FL_INDEX_MAX + 1 ) bytes. */
+#ifndef configHEAP_TLSF_FL_INDEX_MAX
+    #define configHEAP_TLSF_FL_INDEX_MAX    20
+#endif
+
+/* The log2 of portBYTE_ALIGNMENT, as block sizes are always a multiple of it. */
+#if portBYTE_ALIGNMENT == 32
+    #define heapALIGNMENT_LOG2    5U
+#elif portBYTE_ALIGNMENT == 16
+    #define heapALIGNMENT_LOG2    4U
+#elif portBYTE_ALIGNMENT == 8
+    #define heapALIGNMENT_LOG2    3U
+#elif portBYTE_ALIGNMENT == 4
+    #define heapALIGNMENT_LOG2    2U
+#elif portBYTE_ALIGNMENT == 2
+    #define heapALIGNMENT_LOG2    1U
+#elif portBYTE_ALIGNMENT == 1
+    #define heapALIGNMENT_LOG2    0U
+#else
+    #error Invalid portBYTE_ALIGNMENT definition
+#endif
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE all go in the first first level
+ * list, divided linearly into second level lists one alignment unit apart.
+ * Larger blocks go in first level list 1 onwards, up to the list for blocks
+ * whose most significant bit is bit configHEAP_TLSF_FL_INDEX_MAX. */
+#define heapSL_INDEX_COUNT_LOG2    ( ( UBaseType_t ) configHEAP_TLSF_SL_INDEX_COUNT_LOG2 )
+#define heapSL_INDEX_COUNT         ( ( UBaseType_t ) 1U << heapSL_INDEX_COUNT_LOG2 )
+#define heapFL_INDEX_SHIFT         ( heapSL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapFL_INDEX_COUNT         ( configHEAP_TLSF_FL_INDEX_MAX - ( configHEAP_TLSF_SL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 ) + 2 )
+#define heapSMALL_BLOCK_SIZE       ( ( size_t ) 1U << heapFL_INDEX_SHIFT )
+
+/* The largest block that can be placed in a free list. */
+#define heapMAXIMUM_BLOCK_SIZE     ( ( ( size_t ) 1U << ( configHEAP_TLSF_FL_INDEX_MAX + 1 ) ) - ( size_t ) portBYTE_ALIGNMENT )
+
+#if ( configHEAP_TLSF_SL_INDEX_COUNT_LOG2 > 5 )
+    #error configHEAP_TLSF_SL_INDEX_COUNT_LOG2 must be 5 or less as the second level bitmaps are 32 bits.
+#endif
+
+#if ( ( heapFL_INDEX_COUNT < 2 ) || ( heapFL_INDEX_COUNT > 31 ) )
+    #error configHEAP_TLSF_FL_INDEX_MAX must leave between 2 and 31 first level size ranges.
+#endif
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE         ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )    ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )         ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* MSB of the xBlockSize member of a BlockHeader_t structure is used to track
+ * the allocation status of a block.  When MSB of the xBlockSize member of
+ * a BlockHeader_t structure is set then the block belongs to the application.
+ * When the bit is free the block is still part of the free heap space. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_SIZE_IS_VALID( xBlockSize )    ( ( ( xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) == 0 )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock->xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
+#define heapBLOCK_SIZE( pxBlock )                ( ( pxBlock->xBlockSize ) & ~heapBLOCK_ALLOCATED_BITMASK )
+
+/* The block that follows pxBlock in memory. */
+#define heapNEXT_PHYSICAL_BLOCK( pxBlock )       ( ( BlockHeader_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* The header at the start of every block.  Only the first two members are
+ * used while the block is allocated - the free list links overlay the start of
+ * the application's memory.  The last block in each region is a zero sized,
+ * permanently allocated, end marker so every real block has a following
+ * block. */
+typedef struct A_BLOCK_HEADER
+{
+    struct A_BLOCK_HEADER * pxPreviousPhysicalBlock; /*<< The block immediately before this one in memory, or NULL if this is the first block in its region. */
+    size_t xBlockSize;                               /*<< The size of the block, including this header. */
+    struct A_BLOCK_HEADER * pxNextFreeBlock;         /*<< The next block in the same free list.  Only valid while the block is free. */
+    struct A_BLOCK_HEADER * pxPreviousFreeBlock;     /*<< The previous block in the same free list.  Only valid while the block is free. */
+} BlockHeader_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the index of the most significant set bit in ulValue, which must not
+ * be 0.  A fixed sequence of tests is used rather than a loop so the execution
+ * time does not depend on the value.
+ */
+static UBaseType_t prvFindLastSet( uint32_t ulValue );
+
+/*
+ * Returns the first and second level list indexes of the list a free block of
+ * xBlockSize bytes belongs in.
+ */
+static void prvMapBlockSize( size_t xBlockSize,
+                             UBaseType_t * const puxFirstLevel,
+                             UBaseType_t * const puxSecondLevel );
+
+/*
+ * Add and remove a free block to and from the free list for its size.
+ */
+static void prvInsertFreeBlock( BlockHeader_t * const pxBlock );
+static void prvRemoveFreeBlock( BlockHeader_t * const pxBlock );
+
+/*-----------------------------------------------------------*/
+
+/* The part of each block's header that remains while the block is allocated,
+ * which must be correctly byte aligned. */
+static const size_t xHeapStructSize = ( offsetof( BlockHeader_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Block sizes must not get too small - a free block must hold a whole header. */
+static const size_t xMinimumBlockSize = ( sizeof( BlockHeader_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and bitmaps of which lists hold at least one block.  Bit n of
+ * ulFirstLevelBitmap is set if any bit of ulSecondLevelBitmap[ n ] is set, and
+ * bit m of ulSecondLevelBitmap[ n ] is set if pxFreeLists[ n ][ m ] is not
+ * NULL. */
+static BlockHeader_t * pxFreeLists[ heapFL_INDEX_COUNT ][ 1U << configHEAP_TLSF_SL_INDEX_COUNT_LOG2 ];
+static uint32_t ulFirstLevelBitmap = 0U;
+static uint32_t ulSecondLevelBitmap[ heapFL_INDEX_COUNT ];
+
+static BaseType_t xHeapHasBeenInitialised = pdFALSE;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockHeader_t * pxBlock = NULL;
+    BlockHeader_t * pxNewBlock;
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+    size_t xSearchSize;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    uint32_t ulBitmap;
+
+    /* The heap must be initialised before the first call to
+     * prvPortMalloc(). */
+    configASSERT( xHeapHasBeenInitialised );
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain the allocated
+         * part of a block header in addition to the requested amount of bytes,
+         * then rounded up to keep the following block aligned. */
+        xAdditionalRequiredSize = xHeapStructSize;
+
+        if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+        {
+            xAdditionalRequiredSize += portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+        {
+            xWantedSize += xAdditionalRequiredSize;
+
+            if( xWantedSize < xMinimumBlockSize )
+            {
+                xWantedSize = xMinimumBlockSize;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    vTaskSuspendAll();
+    {
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= heapMAXIMUM_BLOCK_SIZE ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            /* Round the size up to the start of the next size class, so any
+             * block in the lists searched is large enough. */
+            xSearchSize = xWantedSize;
+
+            if( xSearchSize >= heapSMALL_BLOCK_SIZE )
+            {
+                xSearchSize += ( ( size_t ) 1U << ( prvFindLastSet( ( uint32_t ) xSearchSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - ( size_t ) 1U;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvMapBlockSize( xSearchSize, &uxFirstLevel, &uxSecondLevel );
+
+            if( uxFirstLevel < ( UBaseType_t ) heapFL_INDEX_COUNT )
+            {
+                /* Look for a list in the same first level range at or above
+                 * the size class, then for the first non-empty larger range. */
+                ulBitmap = ulSecondLevelBitmap[ uxFirstLevel ] & ( ( ~( uint32_t ) 0U ) << uxSecondLevel );
+
+                if( ulBitmap == 0U )
+                {
+                    ulBitmap = ulFirstLevelBitmap & ( ( ~( uint32_t ) 0U ) << ( uxFirstLevel + 1U ) );
+
+                    if( ulBitmap != 0U )
+                    {
+                        uxFirstLevel = prvFindLastSet( ulBitmap & ( ( uint32_t ) 0U - ulBitmap ) );
+                        ulBitmap = ulSecondLevelBitmap[ uxFirstLevel ];
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ulBitmap != 0U )
+                {
+                    uxSecondLevel = prvFindLastSet( ulBitmap & ( ( uint32_t ) 0U - ulBitmap ) );
+                    pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( pxBlock != NULL )
+            {
+                prvRemoveFreeBlock( pxBlock );
+
+                /* If the block is larger than required it can be split into
+                 * two, and the remainder returned to the free lists. */
+                if( ( pxBlock->xBlockSize - xWantedSize ) >= xMinimumBlockSize )
+                {
+                    /* The void cast is used to prevent byte alignment warnings
+                     * from the compiler. */
+                    pxNewBlock = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    pxNewBlock->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                    pxNewBlock->pxPreviousPhysicalBlock = pxBlock;
+                    heapNEXT_PHYSICAL_BLOCK( pxNewBlock )->pxPreviousPhysicalBlock = pxNewBlock;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    prvInsertFreeBlock( pxNewBlock );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The block is being returned - it is allocated and owned by
+                 * the application. */
+                heapALLOCATE_BLOCK( pxBlock );
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                xNumberOfSuccessfulAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockHeader_t * pxBlock;
+    BlockHeader_t * pxNeighbour;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have the allocated part of a
+         * BlockHeader_t structure immediately before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxBlock = ( void * ) puc;
+
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 );
+
+        if( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 )
+        {
+            /* The block is being returned to the heap - it is no longer
+             * allocated. */
+            heapFREE_BLOCK( pxBlock );
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( puc + xHeapStructSize, 0, pxBlock->xBlockSize - xHeapStructSize );
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                xFreeBytesRemaining += pxBlock->xBlockSize;
+                traceFREE( pv, pxBlock->xBlockSize );
+
+                /* Merge with the following block if it is free.  The end
+                 * marker of each region is always allocated. */
+                pxNeighbour = heapNEXT_PHYSICAL_BLOCK( pxBlock );
+
+                if( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxBlock->xBlockSize += pxNeighbour->xBlockSize;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Merge with the preceding block if it is free. */
+                pxNeighbour = pxBlock->pxPreviousPhysicalBlock;
+
+                if( ( pxNeighbour != NULL ) && ( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 ) )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxNeighbour->xBlockSize += pxBlock->xBlockSize;
+                    pxBlock = pxNeighbour;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                heapNEXT_PHYSICAL_BLOCK( pxBlock )->pxPreviousPhysicalBlock = pxBlock;
+                prvInsertFreeBlock( pxBlock );
+                xNumberOfSuccessfulFrees++;
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( uint32_t ulValue )
+{
+    UBaseType_t uxBit = 0U;
+
+    if( ( ulValue & 0xffff0000UL ) != 0U )
+    {
+        ulValue >>= 16U;
+        uxBit += 16U;
+    }
+
+    if( ( ulValue & 0x0000ff00UL ) != 0U )
+    {
+        ulValue >>= 8U;
+        uxBit += 8U;
+    }
+
+    if( ( ulValue & 0x000000f0UL ) != 0U )
+    {
+        ulValue >>= 4U;
+        uxBit += 4U;
+    }
+
+    if( ( ulValue & 0x0000000cUL ) != 0U )
+    {
+        ulValue >>= 2U;
+        uxBit += 2U;
+    }
+
+    if( ( ulValue & 0x00000002UL ) != 0U )
+    {
+        uxBit += 1U;
+    }
+
+    return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapBlockSize( size_t xBlockSize,
+                             UBaseType_t * const puxFirstLevel,
+                             UBaseType_t * const puxSecondLevel )
+{
+    UBaseType_t uxMostSignificantBit;
+
+    if( xBlockSize < heapSMALL_BLOCK_SIZE )
+    {
+        /* Small blocks are spread linearly across the first list. */
+        *puxFirstLevel = 0U;
+        *puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> heapALIGNMENT_LOG2 );
+    }
+    else
+    {
+        /* The first level is the power of two range the size falls in, and
+         * the second level is given by the bits below the most significant
+         * bit. */
+        uxMostSignificantBit = prvFindLastSet( ( uint32_t ) xBlockSize );
+        *puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> ( uxMostSignificantBit - heapSL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT;
+        *puxFirstLevel = uxMostSignificantBit - ( heapFL_INDEX_SHIFT - 1U );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( BlockHeader_t * const pxBlock )
+{
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    BlockHeader_t * pxHead;
+
+    prvMapBlockSize( pxBlock->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+    pxHead = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+    pxBlock->pxNextFreeBlock = pxHead;
+    pxBlock->pxPreviousFreeBlock = NULL;
+
+    if( pxHead != NULL )
+    {
+        pxHead->pxPreviousFreeBlock = pxBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlock;
+    ulFirstLevelBitmap |= ( uint32_t ) 1U << uxFirstLevel;
+    ulSecondLevelBitmap[ uxFirstLevel ] |= ( uint32_t ) 1U << uxSecondLevel;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( BlockHeader_t * const pxBlock )
+{
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+
+    prvMapBlockSize( pxBlock->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPreviousFreeBlock = pxBlock->pxPreviousFreeBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxBlock->pxPreviousFreeBlock != NULL )
+    {
+        pxBlock->pxPreviousFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        /* The block was at the head of its list. */
+        pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlock->pxNextFreeBlock;
+
+        if( pxBlock->pxNextFreeBlock == NULL )
+        {
+            /* The list is now empty. */
+            ulSecondLevelBitmap[ uxFirstLevel ] &= ~( ( uint32_t ) 1U << uxSecondLevel );
+
+            if( ulSecondLevelBitmap[ uxFirstLevel ] == 0U )
+            {
+                ulFirstLevelBitmap &= ~( ( uint32_t ) 1U << uxFirstLevel );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+    BlockHeader_t * pxFirstBlockInRegion;
+    BlockHeader_t * pxEndMarker;
+    portPOINTER_SIZE_TYPE xAlignedHeap;
+    size_t xTotalRegionSize, xTotalHeapSize = 0;
+    BaseType_t xDefinedRegions = 0;
+    portPOINTER_SIZE_TYPE xAddress;
+    const HeapRegion_t * pxHeapRegion;
+
+    /* Can only call once! */
+    configASSERT( xHeapHasBeenInitialised == pdFALSE );
+
+    /* Block sizes are mapped to a list using 32-bit bitmaps. */
+    configASSERT( configHEAP_TLSF_FL_INDEX_MAX < 32 );
+
+    pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+
+    while( pxHeapRegion->xSizeInBytes > 0 )
+    {
+        xTotalRegionSize = pxHeapRegion->xSizeInBytes;
+
+        /* Ensure the heap region starts on a correctly aligned boundary. */
+        xAddress = ( portPOINTER_SIZE_TYPE ) pxHeapRegion->pucStartAddress;
+
+        if( ( xAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+        {
+            xAddress += ( portBYTE_ALIGNMENT - 1 );
+            xAddress &= ~portBYTE_ALIGNMENT_MASK;
+
+            /* Adjust the size for the bytes lost to alignment. */
+            xTotalRegionSize -= ( size_t ) ( xAddress - ( portPOINTER_SIZE_TYPE ) pxHeapRegion->pucStartAddress );
+        }
+
+        xAlignedHeap = xAddress;
+
+        /* The region must hold at least one minimum sized block and the end
+         * marker. */
+        configASSERT( xTotalRegionSize >= ( xMinimumBlockSize + xHeapStructSize ) );
+
+        /* The end marker only uses the allocated part of a header, and is
+         * placed at the end of the region space. */
+        xAddress = xAlignedHeap + xTotalRegionSize;
+        xAddress -= xHeapStructSize;
+        xAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+
+        /* To start with there is a single free block in this region that is
+         * sized to take up the entire region minus the end marker, unless
+         * that is too large to be placed in a free list. */
+        pxFirstBlockInRegion = ( BlockHeader_t * ) xAlignedHeap;
+        pxFirstBlockInRegion->xBlockSize = ( size_t ) ( xAddress - xAlignedHeap );
+
+        if( pxFirstBlockInRegion->xBlockSize > heapMAXIMUM_BLOCK_SIZE )
+        {
+            pxFirstBlockInRegion->xBlockSize = heapMAXIMUM_BLOCK_SIZE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxFirstBlockInRegion->pxPreviousPhysicalBlock = NULL;
+
+        pxEndMarker = heapNEXT_PHYSICAL_BLOCK( pxFirstBlockInRegion );
+        pxEndMarker->xBlockSize = 0;
+        pxEndMarker->pxPreviousPhysicalBlock = pxFirstBlockInRegion;
+        heapALLOCATE_BLOCK( pxEndMarker );
+
+        prvInsertFreeBlock( pxFirstBlockInRegion );
+        xTotalHeapSize += pxFirstBlockInRegion->xBlockSize;
+
+        /* Move onto the next HeapRegion_t structure. */
+        xDefinedRegions++;
+        pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+    }
+
+    xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+    xFreeBytesRemaining = xTotalHeapSize;
+    xHeapHasBeenInitialised = pdTRUE;
+
+    /* Check something was actually defined before it is accessed. */
+    configASSERT( xTotalHeapSize );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockHeader_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+
+    vTaskSuspendAll();
+    {
+        /* Walk every non-empty free list.  Unlike allocating and freeing this
+         * takes time proportional to the number of free blocks. */
+        for( uxFirstLevel = 0U; uxFirstLevel < ( UBaseType_t ) heapFL_INDEX_COUNT; uxFirstLevel++ )
+        {
+            for( uxSecondLevel = 0U; uxSecondLevel < heapSL_INDEX_COUNT; uxSecondLevel++ )
+            {
+                for( pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+                {
+                    xBlocks++;
+
+                    if( pxBlock->xBlockSize > xMaxSize )
+                    {
+                        xMaxSize = pxBlock->xBlockSize;
+                    }
+
+                    if( pxBlock->xBlockSize < xMinSize )
+                    {
+                        xMinSize = pxBlock->xBlockSize;
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
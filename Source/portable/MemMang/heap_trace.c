@@ -0,0 +1,164 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/*
+ * Records each call to pvPortMalloc() and vPortFree() made through heap_2.c,
+ * heap_4.c or heap_5.c in a ring buffer, so the application can find which
+ * call sites churn the heap.  Build this file alongside the heap
+ * implementation and set configUSE_HEAP_TRACE to 1 in FreeRTOSConfig.h.
+ *
+ * Each record holds the address returned or freed, the size of the block, the
+ * heap space left after the operation, a time stamp and the return address
+ * into the function that called pvPortMalloc() or vPortFree().  Records are
+ * removed with xHeapTraceRead(), normally by a low priority task that sends
+ * them to a host.  When the buffer is full the oldest record is overwritten
+ * and counted by ulHeapTraceGetDroppedCount().
+ *
+ * Demo/CORTEX_LM3S811_GCC/tools/heapprof.py symbolizes the records printed by
+ * the demo and reports allocations per call site, fragmentation over time and
+ * the distribution of block lifetimes.
+ */
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configUSE_HEAP_TRACE == 1 )
+
+/* The time stamp is taken from the run time stats counter when there is one,
+ * otherwise from the tick count. */
+    #ifndef portHEAP_TRACE_TIMESTAMP
+        #if ( configGENERATE_RUN_TIME_STATS == 1 ) && defined( portGET_RUN_TIME_COUNTER_VALUE )
+            #define portHEAP_TRACE_TIMESTAMP()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+        #else
+            #define portHEAP_TRACE_TIMESTAMP()    ( ( uint32_t ) xTaskGetTickCount() )
+        #endif
+    #endif
+
+    #if ( configHEAP_TRACE_BUFFER_LENGTH < 1 )
+        #error configHEAP_TRACE_BUFFER_LENGTH must be at least 1
+    #endif
+
+/* The ring buffer.  uxNextRecord is where the next record is written and
+ * uxRecordCount how many unread records precede it. */
+    PRIVILEGED_DATA static HeapTraceRecord_t xRecords[ configHEAP_TRACE_BUFFER_LENGTH ];
+    PRIVILEGED_DATA static UBaseType_t uxNextRecord = 0U;
+    PRIVILEGED_DATA static UBaseType_t uxRecordCount = 0U;
+    PRIVILEGED_DATA static uint32_t ulDroppedRecords = 0U;
+
+/*-----------------------------------------------------------*/
+
+    void vHeapTraceRecord( uint8_t ucOperation,
+                           void * pvAddress,
+                           size_t xBlockSize,
+                           size_t xFreeBytesRemaining,
+                           void * pvCaller )
+    {
+        HeapTraceRecord_t * pxRecord = &( xRecords[ uxNextRecord ] );
+
+        /* The heap calls this with the scheduler suspended, which also
+         * serialises it against xHeapTraceRead(). */
+        pxRecord->pvAddress = pvAddress;
+        pxRecord->pvCaller = pvCaller;
+        pxRecord->xBlockSize = xBlockSize;
+        pxRecord->xFreeBytesRemaining = xFreeBytesRemaining;
+        pxRecord->ulTimeStamp = portHEAP_TRACE_TIMESTAMP();
+        pxRecord->ucOperation = ucOperation;
+
+        uxNextRecord++;
+
+        if( uxNextRecord >= ( UBaseType_t ) configHEAP_TRACE_BUFFER_LENGTH )
+        {
+            uxNextRecord = 0U;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( uxRecordCount < ( UBaseType_t ) configHEAP_TRACE_BUFFER_LENGTH )
+        {
+            uxRecordCount++;
+        }
+        else
+        {
+            /* The oldest record was just overwritten. */
+            ulDroppedRecords++;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xHeapTraceRead( HeapTraceRecord_t * pxRecord )
+    {
+        BaseType_t xReturn = pdFALSE;
+        UBaseType_t uxOldest;
+
+        configASSERT( pxRecord != NULL );
+
+        vTaskSuspendAll();
+        {
+            if( uxRecordCount > 0U )
+            {
+                if( uxNextRecord >= uxRecordCount )
+                {
+                    uxOldest = uxNextRecord - uxRecordCount;
+                }
+                else
+                {
+                    uxOldest = ( ( UBaseType_t ) configHEAP_TRACE_BUFFER_LENGTH + uxNextRecord ) - uxRecordCount;
+                }
+
+                *pxRecord = xRecords[ uxOldest ];
+                uxRecordCount--;
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulHeapTraceGetDroppedCount( void )
+    {
+        return ulDroppedRecords;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_TRACE */
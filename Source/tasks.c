@@ -78,6 +78,10 @@
  */
 #define tskSTACK_FILL_BYTE                        ( 0xa5U )
 
+/* tskSTACK_FILL_BYTE repeated across a whole StackType_t, so the stack can be
+ * checked a word rather than a byte at a time. */
+#define tskSTACK_FILL_WORD                        ( ( StackType_t ) ( ( ( StackType_t ) ~( StackType_t ) 0 ) / ( StackType_t ) 0xffU ) * ( StackType_t ) tskSTACK_FILL_BYTE )
+
 /* Bits used to record how a task's stack and TCB were allocated. */
 #define tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB    ( ( uint8_t ) 0 )
 #define tskSTATICALLY_ALLOCATED_STACK_ONLY        ( ( uint8_t ) 1 )
@@ -218,8 +222,37 @@
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
  */
+#if ( configRECORD_WAKEUP_LATENCY == 1 )
+
+/*
+ * Note the time at which a task was made ready so the latency until it next
+ * runs can be recorded by vTaskSwitchContext().  A task that is already waiting
+ * to run keeps its original time stamp so re-insertions caused by priority
+ * changes do not hide the time already spent waiting.  The running task is not
+ * stamped as it is not waiting for the processor.
+ */
+    #define taskRECORD_READY_TIME( pxTCB )                                                                 \
+    if( ( xSchedulerRunning != pdFALSE ) && ( ( pxTCB ) != pxCurrentTCB ) &&                               \
+        ( ( pxTCB )->ucReadyTimeValid == ( uint8_t ) pdFALSE ) )                                           \
+    {                                                                                                      \
+        ( pxTCB )->ulReadyTime = prvGetRunTimeCounterValue();                                              \
+        ( pxTCB )->ucReadyTimeValid = ( uint8_t ) pdTRUE;                                                  \
+    }
+
+/*
+ * Discard the time stamp of a task that leaves the Ready state without having
+ * run, so the time it spends suspended or held is not counted as latency when
+ * it is next made ready.
+ */
+    #define taskCLEAR_READY_TIME( pxTCB )    ( ( pxTCB )->ucReadyTimeValid = ( uint8_t ) pdFALSE )
+#else
+    #define taskRECORD_READY_TIME( pxTCB )
+    #define taskCLEAR_READY_TIME( pxTCB )
+#endif /* configRECORD_WAKEUP_LATENCY */
+
 #define prvAddTaskToReadyList( pxTCB )                                                                 \
     traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
+    taskRECORD_READY_TIME( pxTCB );                                                                    \
     taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
     listINSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
     tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
@@ -233,6 +266,48 @@
  */
 #define prvGetTCBFromHandle( pxHandle )    ( ( ( pxHandle ) == NULL ) ? pxCurrentTCB : ( pxHandle ) )
 
+/*
+ * Evaluates to pdTRUE if xTime is the tick at which the time triggered
+ * schedule next releases a task.
+ */
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+    #define taskIS_TIME_TRIGGERED_RELEASE( xTime )    ( ( listLIST_IS_EMPTY( pxTimeTriggeredReleaseList ) == pdFALSE ) && ( ( xTime ) == xNextTimeTriggeredRelease ) )
+#else
+    #define taskIS_TIME_TRIGGERED_RELEASE( xTime )    ( pdFALSE )
+#endif
+
+/*
+ * Evaluates to pdTRUE if the stack word pxA is further from the start of the
+ * stack (the end it is pushed onto from) than pxB.
+ */
+#if ( portSTACK_GROWTH < 0 )
+    #define taskSTACK_IS_DEEPER( pxA, pxB )    ( ( pxA ) < ( pxB ) )
+#else
+    #define taskSTACK_IS_DEEPER( pxA, pxB )    ( ( pxA ) > ( pxB ) )
+#endif
+
+/*
+ * Allocates memory for a TCB, from the fastest heap region if the kernel is
+ * configured to place tasks there.  See configUSE_FAST_HEAP_REGION_FOR_TASKS.
+ */
+#if ( configUSE_FAST_HEAP_REGION_FOR_TASKS == 1 )
+    #define taskMALLOC_TCB_MEMORY( xSize )    pvPortMallocWithHint( heapREGION_FAST, ( xSize ) )
+#else
+    #define taskMALLOC_TCB_MEMORY( xSize )    pvPortMalloc( xSize )
+#endif
+
+/*
+ * Allocates and frees a TCB.  With configUSE_TCB_HOT_COLD_SPLIT set to 1 the
+ * TCB is aligned to a cache line, which the heap does not guarantee.
+ */
+#if ( configUSE_TCB_HOT_COLD_SPLIT == 1 )
+    #define taskMALLOC_TCB()           prvAllocateAlignedTCB()
+    #define taskFREE_TCB( pxTCB )      vPortFree( ( ( void ** ) ( pxTCB ) )[ -1 ] )
+#else
+    #define taskMALLOC_TCB()           ( ( TCB_t * ) taskMALLOC_TCB_MEMORY( sizeof( TCB_t ) ) )
+    #define taskFREE_TCB( pxTCB )      vPortFree( pxTCB )
+#endif
+
 /* The item value of the event list item is normally used to hold the priority
  * of the task to which it belongs (coded to allow it to be held in reverse
  * priority order).  However, it is occasionally borrowed for other purposes.  It
@@ -264,8 +339,12 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     ListItem_t xEventListItem;                  /*< Used to reference a task from an event list. */
     UBaseType_t uxPriority;                     /*< The priority of the task.  0 is the lowest priority. */
     StackType_t * pxStack;                      /*< Points to the start of the stack. */
-    char pcTaskName[ configMAX_TASK_NAME_LEN ]; /*< Descriptive name given to the task when created.  Facilitates debugging only. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    #if ( configUSE_TCB_HOT_COLD_SPLIT == 0 )
+        char pcTaskName[ configMAX_TASK_NAME_LEN ]; /*< Descriptive name given to the task when created.  Facilitates debugging only. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    #endif
 
+    /* The members used on each context switch and tick come before those that
+     * are not, see configUSE_TCB_HOT_COLD_SPLIT. */
     #if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
         StackType_t * pxEndOfStack; /*< Points to the highest valid address for the stack. */
     #endif
@@ -274,11 +353,69 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         UBaseType_t uxCriticalNesting; /*< Holds the critical section nesting depth for ports that do not maintain their own count in the port layer. */
     #endif
 
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
+    #endif
+
+    #if ( configUSE_POSIX_ERRNO == 1 )
+        int iTaskErrno;
+    #endif
+
+    #if ( configRECORD_JOB_TIMES == 1 )
+        configRUN_TIME_COUNTER_TYPE ulJobRunTime;     /*< Run time accumulated by the current job. */
+        configRUN_TIME_COUNTER_TYPE ulMaxJobRunTime;  /*< The longest run time observed for a single job. */
+        configRUN_TIME_COUNTER_TYPE ulJobStartTime;   /*< The run time counter value when the current job was first dispatched. */
+        configRUN_TIME_COUNTER_TYPE ulMinJobInterval; /*< The shortest time observed between the start of consecutive jobs. */
+        UBaseType_t uxJobCount;                       /*< The number of jobs started. */
+        uint8_t ucJobActive;                          /*< pdTRUE between the first dispatch of a job and the task leaving the Ready state. */
+    #endif
+
+    #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+        UBaseType_t uxVoluntarySwitches;   /*< Switches away from the task after it left the Ready state. */
+        UBaseType_t uxInvoluntarySwitches; /*< Switches away from the task while it was still Ready. */
+    #endif
+
+    #if ( configRECORD_STACK_HEADROOM == 1 )
+        StackType_t * pxLowestTopOfStack; /*< The deepest pxTopOfStack saved when the task was switched out. */
+    #endif
+
+    #if ( configRECORD_WAKEUP_LATENCY == 1 )
+        configRUN_TIME_COUNTER_TYPE ulReadyTime;                            /*< The run time counter value when the task was last made ready. */
+        configRUN_TIME_COUNTER_TYPE ulMaxWakeupLatency;                     /*< The longest time observed between the task being made ready and running. */
+        uint8_t ucReadyTimeValid;                                           /*< pdTRUE if ulReadyTime holds a wake up that has not yet been recorded.  Read on every context switch. */
+        uint16_t usWakeupLatencyHistogram[ configWAKEUP_LATENCY_BUCKETS ]; /*< Log2 histogram of ready to running latencies.  See configWAKEUP_LATENCY_BUCKETS. */
+    #endif
+
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        TickType_t xCpuBudget;            /*< The number of ticks the task may execute for in each budget period.  0 if the task has no budget. */
+        TickType_t xCpuBudgetPeriod;      /*< The length of the budget replenishment period in ticks. */
+        TickType_t xCpuBudgetUsed;        /*< Ticks charged to the task since xCpuBudgetPeriodStart. */
+        TickType_t xCpuBudgetPeriodStart; /*< The tick count at which the current budget period started. */
+        UBaseType_t uxCpuBudgetOverruns;  /*< The number of times the task exhausted its budget. */
+        uint8_t ucCpuBudgetHeld;          /*< Set to pdTRUE while the task is in the Blocked state because its budget is exhausted, so xTaskAbortDelay() cannot release it. */
+    #endif
+
+    #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+        TickType_t xReleasePeriod;       /*< The period of the task in the time triggered schedule, or 0 if the task is not in the schedule. */
+        ListItem_t xReleaseListItem;     /*< Holds the task in the time triggered release list, with the tick count at which the task will next be released as its value. */
+        UBaseType_t uxReleaseOverruns;   /*< The number of releases that occurred while the task was not waiting to be released. */
+        uint8_t ucReleasePending;        /*< Set to pdTRUE if a release was missed and has not yet been consumed by xTaskWaitForRelease(). */
+    #endif
+
+    #if ( configUSE_TCB_HOT_COLD_SPLIT == 1 )
+        char pcTaskName[ configMAX_TASK_NAME_LEN ] portCACHE_LINE_ALIGNED; /*< Descriptive name given to the task when created.  Starts the cold members on a new cache line. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    #endif
+
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxTCBNumber;  /*< Stores a number that increments each time a TCB is created.  It allows debuggers to determine when a task has been deleted and then recreated. */
         UBaseType_t uxTaskNumber; /*< Stores a number specifically for use by third party trace code. */
     #endif
 
+    #if ( configUSE_TASK_ITERATOR == 1 )
+        struct tskTaskControlBlock * pxNextCreatedTCB;     /*< The next task in creation order, see xTaskIteratorNext(). */
+        struct tskTaskControlBlock * pxPreviousCreatedTCB; /*< The previous task in creation order. */
+    #endif
+
     #if ( configUSE_MUTEXES == 1 )
         UBaseType_t uxBasePriority; /*< The priority last assigned to the task - used by the priority inheritance mechanism. */
         UBaseType_t uxMutexesHeld;
@@ -292,10 +429,6 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         void * pvThreadLocalStoragePointers[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
     #endif
 
-    #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
-    #endif
-
     #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
         configTLS_BLOCK_TYPE xTLSBlock; /*< Memory block used as Thread Local Storage (TLS) Block for the task. */
     #endif
@@ -315,8 +448,10 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         uint8_t ucDelayAborted;
     #endif
 
-    #if ( configUSE_POSIX_ERRNO == 1 )
-        int iTaskErrno;
+    #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        size_t xHeapBytesInUse; /*< The heap, including block headers, held in blocks the task allocated. */
+        size_t xHeapBytesPeak;  /*< The most heap the task has held at one time. */
+        size_t xHeapQuota;      /*< The most heap the task may hold, or 0 for no limit.  See vTaskSetHeapQuota(). */
     #endif
 } tskTCB;
 
@@ -352,6 +487,17 @@ PRIVILEGED_DATA static List_t xPendingReadyList;                         /*< Tas
 
 #endif
 
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    PRIVILEGED_DATA static List_t xTimeTriggeredWaitList;                                    /*< Tasks waiting for their next time triggered release. */
+    PRIVILEGED_DATA static List_t xTimeTriggeredReleaseList1;                                /*< The tasks in the schedule, in release time order. */
+    PRIVILEGED_DATA static List_t xTimeTriggeredReleaseList2;                                /*< The tasks in the schedule, in release time order. */
+    PRIVILEGED_DATA static List_t * pxTimeTriggeredReleaseList;                              /*< Points to the release list holding the releases before the tick count next overflows. */
+    PRIVILEGED_DATA static List_t * pxOverflowTimeTriggeredReleaseList;                      /*< Points to the release list holding the releases after the tick count next overflows. */
+    PRIVILEGED_DATA static volatile TickType_t xNextTimeTriggeredRelease = ( TickType_t ) 0U; /*< The tick count at which the next task in the schedule is released. */
+
+#endif
+
 /* Global POSIX errno. Its value is changed upon context switching to match
  * the errno of the currently running task. */
 #if ( configUSE_POSIX_ERRNO == 1 )
@@ -385,6 +531,27 @@ const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
  * accessed from a critical section. */
 PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t ) pdFALSE;
 
+#if ( configUSE_TASK_ITERATOR == 1 )
+
+/* Every task that has been created and not deleted, in the order they were
+ * created, and the number of times a task has been added to or removed from
+ * them.  Only accessed from a critical section. */
+    PRIVILEGED_DATA static TCB_t * pxFirstCreatedTCB = NULL;
+    PRIVILEGED_DATA static TCB_t * pxLastCreatedTCB = NULL;
+    PRIVILEGED_DATA static UBaseType_t uxTaskSetGeneration = ( UBaseType_t ) 0U;
+
+#endif
+
+#if ( ( configRECORD_CONTEXT_SWITCHES == 1 ) && ( configUSE_TASK_BUDGETS == 1 ) )
+
+/* Set when the tick holds the running task because its CPU budget is used up,
+ * which removes it from the Ready state without the task giving up the
+ * processor, so the next context switch away from it is counted as
+ * involuntary. */
+    PRIVILEGED_DATA static BaseType_t xCurrentTaskBudgetHeld = pdFALSE;
+
+#endif
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 /* Do not move these variables to function scope as doing so prevents the
@@ -392,6 +559,11 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t
     PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime = 0UL;    /*< Holds the value of a timer/counter the last time a task was switched in. */
     PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0UL; /*< Holds the total amount of execution time as defined by the run time counter clock. */
 
+    #if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulPendingInterruptRunTime = 0UL; /*< Interrupt time not yet taken off the task that was interrupted. */
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulInterruptRunTime = 0UL;        /*< The total interrupt time reported by vTaskAddInterruptRunTime(). */
+    #endif
+
 #endif
 
 /*lint -restore */
@@ -443,6 +615,17 @@ static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters ) PRIVILEGED_FUNCTION;
 
 #endif
 
+/*
+ * Allocate a TCB that starts on a configTCB_CACHE_LINE_SIZE boundary.  The
+ * pointer returned by the heap, which taskFREE_TCB() frees, is kept in the word
+ * before the TCB.
+ */
+#if ( ( configUSE_TCB_HOT_COLD_SPLIT == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+    static TCB_t * prvAllocateAlignedTCB( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Used only by the idle task.  This checks to see if anything has been placed
  * in the list of tasks waiting to be deleted.  If so the task is cleaned up
@@ -491,7 +674,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 #if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
 
-    static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte ) PRIVILEGED_FUNCTION;
+    static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
 
 #endif
 
@@ -516,6 +699,80 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Called from the tick interrupt to charge the tick that has just elapsed to
+ * the budget of the running task.  If the task has exhausted its budget it is
+ * moved to the delayed list until its next replenishment time and pdTRUE is
+ * returned to indicate a context switch is required.
+ */
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    static BaseType_t prvChargeCpuBudget( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Called from the tick interrupt at the tick count held in
+ * xNextTimeTriggeredRelease.  Takes each task due for release at that tick
+ * from the head of the release list, moves it from the time triggered wait
+ * list to its ready list or records an overrun if it was not waiting, and puts
+ * it back in the release list at its next release time.  Returns pdTRUE if a
+ * context switch is required.
+ */
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    static BaseType_t prvReleaseTimeTriggeredTasks( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Insert pxTCB into the release list, or the overflow release list if its next
+ * release, held in the value of its release list item, is after the tick
+ * count next overflows, that is earlier than xTimeNow.
+ */
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    static void prvInsertTimeTriggeredRelease( TCB_t * const pxTCB,
+                                               const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Set xNextTimeTriggeredRelease to the release time of the task at the head of
+ * the release list.  The release lists are switched once every release before
+ * the tick count next overflows has been taken from the release list, rather
+ * than when the tick count overflows, so the head is always the next release.
+ */
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    static void prvResetNextTimeTriggeredRelease( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Moves at most uxMaxTasks tasks from xPendingReadyList to their ready lists,
+ * setting xYieldPending if a moved task has a priority at or above that of the
+ * running task.  Returns the number of tasks moved.  Must be called from within
+ * a critical section.
+ */
+static UBaseType_t prvMovePendingReadyTasks( UBaseType_t uxMaxTasks ) PRIVILEGED_FUNCTION;
+
+#if ( configRECORD_WAKEUP_LATENCY == 1 )
+
+/*
+ * Returns the current value of the run time stats counter.
+ */
+    static configRUN_TIME_COUNTER_TYPE prvGetRunTimeCounterValue( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by vTaskSwitchContext() when pxTCB is switched in to add the time
+ * between the task being made ready and ulNow to the task's latency histogram.
+ */
+    static void prvRecordWakeupLatency( TCB_t * const pxTCB,
+                                        const configRUN_TIME_COUNTER_TYPE ulNow ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -679,7 +936,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* Allocate space for the TCB.  Where the memory comes from depends
              * on the implementation of the port malloc function and whether or
              * not static allocation is being used. */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = taskMALLOC_TCB();
 
             if( pxNewTCB != NULL )
             {
@@ -736,7 +993,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* Allocate space for the TCB.  Where the memory comes from depends on
              * the implementation of the port malloc function and whether or not static
              * allocation is being used. */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = taskMALLOC_TCB();
 
             if( pxNewTCB != NULL )
             {
@@ -750,7 +1007,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 if( pxNewTCB->pxStack == NULL )
                 {
                     /* Could not allocate the stack.  Delete the allocated TCB. */
-                    vPortFree( pxNewTCB );
+                    taskFREE_TCB( pxNewTCB );
                     pxNewTCB = NULL;
                 }
             }
@@ -765,7 +1022,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             if( pxStack != NULL )
             {
                 /* Allocate space for the TCB. */
-                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+                pxNewTCB = taskMALLOC_TCB(); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
 
                 if( pxNewTCB != NULL )
                 {
@@ -940,6 +1197,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     listSET_LIST_ITEM_VALUE( &( pxNewTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
     listSET_LIST_ITEM_OWNER( &( pxNewTCB->xEventListItem ), pxNewTCB );
 
+    #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+    {
+        vListInitialiseItem( &( pxNewTCB->xReleaseListItem ) );
+        listSET_LIST_ITEM_OWNER( &( pxNewTCB->xReleaseListItem ), pxNewTCB );
+    }
+    #endif
+
     #if ( portUSING_MPU_WRAPPERS == 1 )
     {
         vPortStoreTaskMPUSettings( &( pxNewTCB->xMPUSettings ), xRegions, pxNewTCB->pxStack, ulStackDepth );
@@ -1010,6 +1274,14 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     }
     #endif /* portUSING_MPU_WRAPPERS */
 
+    #if ( configRECORD_STACK_HEADROOM == 1 )
+    {
+        /* The initial context has been written, so the stack has been used
+         * down to the top of stack. */
+        pxNewTCB->pxLowestTopOfStack = ( StackType_t * ) pxNewTCB->pxTopOfStack;
+    }
+    #endif
+
     if( pxCreatedTask != NULL )
     {
         /* Pass the handle out in an anonymous way.  The handle can be used to
@@ -1079,6 +1351,26 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             pxNewTCB->uxTCBNumber = uxTaskNumber;
         }
         #endif /* configUSE_TRACE_FACILITY */
+
+        #if ( configUSE_TASK_ITERATOR == 1 )
+        {
+            /* Append the task to those reported by xTaskIteratorNext(). */
+            pxNewTCB->pxNextCreatedTCB = NULL;
+            pxNewTCB->pxPreviousCreatedTCB = pxLastCreatedTCB;
+
+            if( pxLastCreatedTCB == NULL )
+            {
+                pxFirstCreatedTCB = pxNewTCB;
+            }
+            else
+            {
+                pxLastCreatedTCB->pxNextCreatedTCB = pxNewTCB;
+            }
+
+            pxLastCreatedTCB = pxNewTCB;
+            uxTaskSetGeneration++;
+        }
+        #endif /* configUSE_TASK_ITERATOR */
         traceTASK_CREATE( pxNewTCB );
 
         prvAddTaskToReadyList( pxNewTCB );
@@ -1139,12 +1431,55 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+            {
+                /* Remove the task from the time triggered schedule so the tick
+                 * interrupt no longer releases it. */
+                if( pxTCB->xReleasePeriod != ( TickType_t ) 0 )
+                {
+                    ( void ) uxListRemove( &( pxTCB->xReleaseListItem ) );
+                    prvResetNextTimeTriggeredRelease();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TIME_TRIGGERED_TASKS */
+
             /* Increment the uxTaskNumber also so kernel aware debuggers can
              * detect that the task lists need re-generating.  This is done before
              * portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
              * not return. */
             uxTaskNumber++;
 
+            #if ( configUSE_TASK_ITERATOR == 1 )
+            {
+                /* Stop reporting the task from xTaskIteratorNext().  An
+                 * iterator that still refers to it sees the generation change
+                 * before it is used. */
+                if( pxTCB->pxPreviousCreatedTCB == NULL )
+                {
+                    pxFirstCreatedTCB = pxTCB->pxNextCreatedTCB;
+                }
+                else
+                {
+                    pxTCB->pxPreviousCreatedTCB->pxNextCreatedTCB = pxTCB->pxNextCreatedTCB;
+                }
+
+                if( pxTCB->pxNextCreatedTCB == NULL )
+                {
+                    pxLastCreatedTCB = pxTCB->pxPreviousCreatedTCB;
+                }
+                else
+                {
+                    pxTCB->pxNextCreatedTCB->pxPreviousCreatedTCB = pxTCB->pxPreviousCreatedTCB;
+                }
+
+                uxTaskSetGeneration++;
+            }
+            #endif /* configUSE_TASK_ITERATOR */
+
             if( pxTCB == pxCurrentTCB )
             {
                 /* A task is deleting itself.  This cannot complete within the
@@ -1375,6 +1710,15 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 eReturn = eBlocked;
             }
 
+            #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+                else if( pxStateList == &xTimeTriggeredWaitList )
+                {
+                    /* The task being queried is waiting for its next time
+                     * triggered release. */
+                    eReturn = eBlocked;
+                }
+            #endif
+
             #if ( INCLUDE_vTaskSuspend == 1 )
                 else if( pxStateList == &xSuspendedTaskList )
                 {
@@ -1668,82 +2012,653 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskSuspend == 1 )
+#if ( configUSE_TASK_BUDGETS == 1 )
 
-    void vTaskSuspend( TaskHandle_t xTaskToSuspend )
+    void vTaskSetCpuBudget( TaskHandle_t xTask,
+                            TickType_t xBudgetTicks,
+                            TickType_t xPeriodTicks )
     {
         TCB_t * pxTCB;
 
+        configASSERT( ( xBudgetTicks == ( TickType_t ) 0 ) || ( xBudgetTicks <= xPeriodTicks ) );
+
         taskENTER_CRITICAL();
         {
-            /* If null is passed in here then it is the running task that is
-             * being suspended. */
-            pxTCB = prvGetTCBFromHandle( xTaskToSuspend );
+            /* If null is passed in here then it is the budget of the calling
+             * task that is being set. */
+            pxTCB = prvGetTCBFromHandle( xTask );
 
-            traceTASK_SUSPEND( pxTCB );
+            /* Holding the idle task off the processor would leave the
+             * scheduler with nothing to run. */
+            configASSERT( ( xBudgetTicks == ( TickType_t ) 0 ) || ( pxTCB != xIdleTaskHandle ) );
 
-            /* Remove task from the ready/delayed list and place in the
-             * suspended list. */
-            if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+            pxTCB->xCpuBudget = xBudgetTicks;
+            pxTCB->xCpuBudgetPeriod = xPeriodTicks;
+            pxTCB->xCpuBudgetUsed = ( TickType_t ) 0;
+            pxTCB->xCpuBudgetPeriodStart = xTickCount;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_TASK_BUDGETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+    void vTaskSetHeapQuota( TaskHandle_t xTask,
+                            size_t xQuotaBytes )
+    {
+        TCB_t * pxTCB;
+
+        /* The heap charges tasks with the scheduler suspended, so suspending
+         * it here keeps the quota consistent with the usage it is checked
+         * against. */
+        vTaskSuspendAll();
+        {
+            /* If null is passed in here then it is the quota of the calling
+             * task that is being set. */
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->xHeapQuota = xQuotaBytes;
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTaskHeapQuotaAvailable( size_t xBlockSize )
+    {
+        BaseType_t xReturn = pdTRUE;
+
+        /* Allocations made before the scheduler starts are not charged to any
+         * task. */
+        if( ( xSchedulerRunning != pdFALSE ) && ( pxCurrentTCB->xHeapQuota != ( size_t ) 0 ) )
+        {
+            if( ( pxCurrentTCB->xHeapBytesInUse > pxCurrentTCB->xHeapQuota ) ||
+                ( xBlockSize > ( pxCurrentTCB->xHeapQuota - pxCurrentTCB->xHeapBytesInUse ) ) )
             {
-                taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+                xReturn = pdFALSE;
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-            /* Is the task waiting on an event also? */
-            if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    TaskHandle_t xTaskHeapCharge( size_t xBlockSize )
+    {
+        TCB_t * pxTCB = NULL;
+
+        if( xSchedulerRunning != pdFALSE )
+        {
+            pxTCB = pxCurrentTCB;
+            pxTCB->xHeapBytesInUse += xBlockSize;
+
+            if( pxTCB->xHeapBytesInUse > pxTCB->xHeapBytesPeak )
             {
-                ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+                pxTCB->xHeapBytesPeak = pxTCB->xHeapBytesInUse;
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-            vListInsertEnd( &xSuspendedTaskList, &( pxTCB->xStateListItem ) );
-
-            #if ( configUSE_TASK_NOTIFICATIONS == 1 )
-            {
-                BaseType_t x;
+        return pxTCB;
+    }
+/*-----------------------------------------------------------*/
 
-                for( x = 0; x < configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
-                {
-                    if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
-                    {
-                        /* The task was blocked to wait for a notification, but is
-                         * now suspended, so no notification was received. */
-                        pxTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
-                    }
-                }
-            }
-            #endif /* if ( configUSE_TASK_NOTIFICATIONS == 1 ) */
-        }
-        taskEXIT_CRITICAL();
+    void vTaskHeapRelease( TaskHandle_t xOwner,
+                           size_t xBlockSize )
+    {
+        TCB_t * const pxTCB = xOwner;
 
-        if( xSchedulerRunning != pdFALSE )
+        /* Blocks allocated before the scheduler started, or by a task that has
+         * since been deleted, have no owner. */
+        if( pxTCB != NULL )
         {
-            /* Reset the next expected unblock time in case it referred to the
-             * task that is now in the Suspended state. */
-            taskENTER_CRITICAL();
-            {
-                prvResetNextTaskUnblockTime();
-            }
-            taskEXIT_CRITICAL();
+            configASSERT( pxTCB->xHeapBytesInUse >= xBlockSize );
+            pxTCB->xHeapBytesInUse -= xBlockSize;
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
+    }
 
-        if( pxTCB == pxCurrentTCB )
-        {
-            if( xSchedulerRunning != pdFALSE )
-            {
-                /* The current task has just been suspended. */
-                configASSERT( uxSchedulerSuspended == 0 );
+#endif /* configUSE_TASK_HEAP_ACCOUNTING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    void vTaskSetTimeTriggeredSchedule( const TimeTriggeredEntry_t * const pxSchedule,
+                                        UBaseType_t uxEntries )
+    {
+        UBaseType_t x;
+        TCB_t * pxTCB;
+
+        /* The schedule is fixed before the scheduler is started so the release
+         * times of all the entries share the same frame origin. */
+        configASSERT( xSchedulerRunning == pdFALSE );
+        configASSERT( pxSchedule );
+        configASSERT( uxEntries > ( UBaseType_t ) 0 );
+
+        taskENTER_CRITICAL();
+        {
+            for( x = ( UBaseType_t ) 0; x < uxEntries; x++ )
+            {
+                pxTCB = *( pxSchedule[ x ].pxTask );
+
+                /* The task must have been created, and must appear in the
+                 * table only once. */
+                configASSERT( pxTCB );
+                configASSERT( pxTCB->xReleasePeriod == ( TickType_t ) 0 );
+                configASSERT( pxSchedule[ x ].xPeriod > ( TickType_t ) 0 );
+                configASSERT( pxSchedule[ x ].xOffset < pxSchedule[ x ].xPeriod );
+
+                /* The first frame starts on the first tick after the scheduler
+                 * is started. */
+                pxTCB->xReleasePeriod = pxSchedule[ x ].xPeriod;
+                listSET_LIST_ITEM_VALUE( &( pxTCB->xReleaseListItem ), xTickCount + ( TickType_t ) 1 + pxSchedule[ x ].xOffset );
+                prvInsertTimeTriggeredRelease( pxTCB, xTickCount );
+            }
+
+            prvResetNextTimeTriggeredRelease();
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_TIME_TRIGGERED_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    BaseType_t xTaskWaitForRelease( void )
+    {
+        BaseType_t xReturn = pdPASS;
+
+        /* Only tasks that appear in the schedule are ever released. */
+        configASSERT( pxCurrentTCB->xReleasePeriod != ( TickType_t ) 0 );
+        configASSERT( uxSchedulerSuspended == ( UBaseType_t ) 0 );
+
+        taskENTER_CRITICAL();
+        {
+            if( pxCurrentTCB->ucReleasePending != ( uint8_t ) pdFALSE )
+            {
+                /* The task was still busy with its previous activation when it
+                 * was released.  Return immediately so the task can catch up,
+                 * but report the overrun to the caller. */
+                pxCurrentTCB->ucReleasePending = ( uint8_t ) pdFALSE;
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                /* Wait on the unsorted release list - the tick interrupt finds
+                 * the task from the schedule table, not by searching the list. */
+                if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                {
+                    portRESET_READY_PRIORITY( pxCurrentTCB->uxPriority, uxTopReadyPriority );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                listINSERT_END( &xTimeTriggeredWaitList, &( pxCurrentTCB->xStateListItem ) );
+                portYIELD_WITHIN_API();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+#endif /* configUSE_TIME_TRIGGERED_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    UBaseType_t uxTaskGetReleaseOverruns( TaskHandle_t xTask )
+    {
+        TCB_t const * pxTCB;
+        UBaseType_t uxReturn;
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            uxReturn = pxTCB->uxReleaseOverruns;
+        }
+        taskEXIT_CRITICAL();
+
+        return uxReturn;
+    }
+
+#endif /* configUSE_TIME_TRIGGERED_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    static BaseType_t prvReleaseTimeTriggeredTasks( const TickType_t xConstTickCount )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xSwitchRequired = pdFALSE;
+
+        /* Only the tasks due for release at this tick are taken from the
+         * release list.  Putting each back at its next release time walks the
+         * list in the same way that putting a task in the delayed list does. */
+        while( ( listLIST_IS_EMPTY( pxTimeTriggeredReleaseList ) == pdFALSE ) &&
+               ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTimeTriggeredReleaseList ) == xConstTickCount ) )
+        {
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxTimeTriggeredReleaseList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            listREMOVE_ITEM( &( pxTCB->xReleaseListItem ) );
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xReleaseListItem ), xConstTickCount + pxTCB->xReleasePeriod );
+            prvInsertTimeTriggeredRelease( pxTCB, xConstTickCount );
+
+            if( listIS_CONTAINED_WITHIN( &xTimeTriggeredWaitList, &( pxTCB->xStateListItem ) ) != pdFALSE )
+            {
+                /* The task is waiting for this release.  Moving it to its
+                 * ready list does not depend on the number of waiting tasks. */
+                listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                prvAddTaskToReadyList( pxTCB );
+
+                #if ( configUSE_PREEMPTION == 1 )
+                {
+                    if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                    {
+                        xSwitchRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_PREEMPTION */
+            }
+            else
+            {
+                /* The task is still running, or blocked on something else,
+                 * from its previous activation. */
+                traceTASK_RELEASE_OVERRUN( pxTCB );
+                pxTCB->uxReleaseOverruns++;
+                pxTCB->ucReleasePending = ( uint8_t ) pdTRUE;
+            }
+        }
+
+        prvResetNextTimeTriggeredRelease();
+
+        return xSwitchRequired;
+    }
+
+#endif /* configUSE_TIME_TRIGGERED_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    static void prvInsertTimeTriggeredRelease( TCB_t * const pxTCB,
+                                               const TickType_t xTimeNow )
+    {
+        if( listGET_LIST_ITEM_VALUE( &( pxTCB->xReleaseListItem ) ) < xTimeNow )
+        {
+            /* The release time has overflowed. */
+            vListInsert( pxOverflowTimeTriggeredReleaseList, &( pxTCB->xReleaseListItem ) );
+        }
+        else
+        {
+            vListInsert( pxTimeTriggeredReleaseList, &( pxTCB->xReleaseListItem ) );
+        }
+    }
+
+#endif /* configUSE_TIME_TRIGGERED_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+
+    static void prvResetNextTimeTriggeredRelease( void )
+    {
+        List_t * pxTemp;
+
+        if( listLIST_IS_EMPTY( pxTimeTriggeredReleaseList ) != pdFALSE )
+        {
+            /* Every release before the tick count next overflows has been
+             * made, so the releases after it are next. */
+            pxTemp = pxTimeTriggeredReleaseList;
+            pxTimeTriggeredReleaseList = pxOverflowTimeTriggeredReleaseList;
+            pxOverflowTimeTriggeredReleaseList = pxTemp;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( listLIST_IS_EMPTY( pxTimeTriggeredReleaseList ) == pdFALSE )
+        {
+            xNextTimeTriggeredRelease = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTimeTriggeredReleaseList );
+        }
+        else
+        {
+            /* Every task in the schedule has been deleted. */
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_TIME_TRIGGERED_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    static BaseType_t prvChargeCpuBudget( const TickType_t xConstTickCount )
+    {
+        TCB_t * const pxTCB = pxCurrentTCB;
+        TickType_t xTimeInPeriod;
+        BaseType_t xHoldingMutex = pdFALSE;
+        BaseType_t xSwitchRequired = pdFALSE;
+
+        /* Only charge a task that is still executing.  When the pended ticks are
+         * unwound in xTaskResumeAll() the current task may already have been
+         * moved to the Blocked state. */
+        if( ( pxTCB->xCpuBudget != ( TickType_t ) 0 ) &&
+            ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE ) )
+        {
+            /* Replenish the budget lazily.  The period may have elapsed more
+             * than once while the task was not running. */
+            xTimeInPeriod = xConstTickCount - pxTCB->xCpuBudgetPeriodStart;
+
+            if( xTimeInPeriod >= pxTCB->xCpuBudgetPeriod )
+            {
+                xTimeInPeriod %= pxTCB->xCpuBudgetPeriod;
+                pxTCB->xCpuBudgetPeriodStart = xConstTickCount - xTimeInPeriod;
+                pxTCB->xCpuBudgetUsed = ( TickType_t ) 0;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxTCB->xCpuBudgetUsed++;
+
+            /* A task that holds a mutex is allowed to overrun until it gives
+             * the mutex back, as otherwise the tasks waiting for the mutex would
+             * inherit the delay. */
+            #if ( configUSE_MUTEXES == 1 )
+            {
+                if( pxTCB->uxMutexesHeld != ( UBaseType_t ) 0 )
+                {
+                    xHoldingMutex = pdTRUE;
+                }
+            }
+            #endif
+
+            if( ( pxTCB->xCpuBudgetUsed >= pxTCB->xCpuBudget ) && ( xHoldingMutex == pdFALSE ) )
+            {
+                /* The budget is exhausted.  Hold the task in the Blocked state
+                 * until the start of the next period. */
+                traceTASK_BUDGET_EXHAUSTED( pxTCB );
+                pxTCB->uxCpuBudgetOverruns++;
+                prvAddCurrentTaskToDelayedList( pxTCB->xCpuBudgetPeriod - xTimeInPeriod, pdFALSE );
+                pxTCB->ucCpuBudgetHeld = pdTRUE;
+                taskCLEAR_READY_TIME( pxTCB );
+                xSwitchRequired = pdTRUE;
+
+                #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+                {
+                    xCurrentTaskBudgetHeld = pdTRUE;
+                }
+                #endif
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xSwitchRequired;
+    }
+
+#endif /* configUSE_TASK_BUDGETS */
+/*-----------------------------------------------------------*/
+
+#if ( configRECORD_WAKEUP_LATENCY == 1 )
+
+    static configRUN_TIME_COUNTER_TYPE prvGetRunTimeCounterValue( void )
+    {
+        configRUN_TIME_COUNTER_TYPE ulNow;
+
+        #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+            portALT_GET_RUN_TIME_COUNTER_VALUE( ulNow );
+        #else
+            ulNow = portGET_RUN_TIME_COUNTER_VALUE();
+        #endif
+
+        return ulNow;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRecordWakeupLatency( TCB_t * const pxTCB,
+                                        const configRUN_TIME_COUNTER_TYPE ulNow )
+    {
+        configRUN_TIME_COUNTER_TYPE ulLatency, ulRemaining;
+        UBaseType_t uxBucket = 0, x;
+
+        ulLatency = ulNow - pxTCB->ulReadyTime;
+        pxTCB->ucReadyTimeValid = ( uint8_t ) pdFALSE;
+
+        if( ulLatency > pxTCB->ulMaxWakeupLatency )
+        {
+            pxTCB->ulMaxWakeupLatency = ulLatency;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The bucket index is the number of significant bits in the latency,
+         * limited to the last bucket. */
+        for( ulRemaining = ulLatency; ( ulRemaining != 0 ) && ( uxBucket < ( UBaseType_t ) ( configWAKEUP_LATENCY_BUCKETS - 1 ) ); ulRemaining >>= 1 )
+        {
+            uxBucket++;
+        }
+
+        /* Halve every bucket rather than let one saturate so the shape of the
+         * histogram, and so the percentiles read from it, stay valid. */
+        if( pxTCB->usWakeupLatencyHistogram[ uxBucket ] == ( uint16_t ) 0xffffU )
+        {
+            for( x = 0; x < ( UBaseType_t ) configWAKEUP_LATENCY_BUCKETS; x++ )
+            {
+                pxTCB->usWakeupLatencyHistogram[ x ] >>= 1;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxTCB->usWakeupLatencyHistogram[ uxBucket ]++;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskGetWakeupLatencyHistogram( TaskHandle_t xTask,
+                                         uint16_t * pusHistogram )
+    {
+        TCB_t * pxTCB;
+        UBaseType_t x;
+
+        configASSERT( pusHistogram );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+
+            for( x = 0; x < ( UBaseType_t ) configWAKEUP_LATENCY_BUCKETS; x++ )
+            {
+                pusHistogram[ x ] = pxTCB->usWakeupLatencyHistogram[ x ];
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    configRUN_TIME_COUNTER_TYPE ulTaskGetWakeupLatencyPercentile( TaskHandle_t xTask,
+                                                                  UBaseType_t uxPercentile )
+    {
+        TCB_t * pxTCB;
+        uint16_t usHistogram[ configWAKEUP_LATENCY_BUCKETS ];
+        uint32_t ulTotal = 0, ulTarget, ulCount = 0;
+        configRUN_TIME_COUNTER_TYPE ulMax, ulReturn = 0;
+        UBaseType_t x;
+
+        configASSERT( uxPercentile <= ( UBaseType_t ) 100 );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            ulMax = pxTCB->ulMaxWakeupLatency;
+
+            for( x = 0; x < ( UBaseType_t ) configWAKEUP_LATENCY_BUCKETS; x++ )
+            {
+                usHistogram[ x ] = pxTCB->usWakeupLatencyHistogram[ x ];
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        for( x = 0; x < ( UBaseType_t ) configWAKEUP_LATENCY_BUCKETS; x++ )
+        {
+            ulTotal += usHistogram[ x ];
+        }
+
+        if( ulTotal != 0UL )
+        {
+            /* The number of samples that must be at or below the result,
+             * rounded up. */
+            ulTarget = ( ( ulTotal * ( uint32_t ) uxPercentile ) + 99UL ) / 100UL;
+
+            for( x = 0; x < ( UBaseType_t ) configWAKEUP_LATENCY_BUCKETS; x++ )
+            {
+                ulCount += usHistogram[ x ];
+
+                if( ( ulCount >= ulTarget ) && ( ulCount != 0UL ) )
+                {
+                    break;
+                }
+            }
+
+            /* Return the upper bound of the bucket, which for the last bucket
+             * is only known from the largest latency seen. */
+            if( x < ( UBaseType_t ) ( configWAKEUP_LATENCY_BUCKETS - 1 ) )
+            {
+                ulReturn = ( ( ( configRUN_TIME_COUNTER_TYPE ) 1 ) << x ) - ( configRUN_TIME_COUNTER_TYPE ) 1;
+
+                if( ulReturn > ulMax )
+                {
+                    ulReturn = ulMax;
+                }
+            }
+            else
+            {
+                ulReturn = ulMax;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return ulReturn;
+    }
+
+#endif /* configRECORD_WAKEUP_LATENCY */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskSuspend == 1 )
+
+    void vTaskSuspend( TaskHandle_t xTaskToSuspend )
+    {
+        TCB_t * pxTCB;
+
+        taskENTER_CRITICAL();
+        {
+            /* If null is passed in here then it is the running task that is
+             * being suspended. */
+            pxTCB = prvGetTCBFromHandle( xTaskToSuspend );
+
+            traceTASK_SUSPEND( pxTCB );
+
+            /* Remove task from the ready/delayed list and place in the
+             * suspended list. */
+            if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+            {
+                taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Is the task waiting on an event also? */
+            if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+            {
+                ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            vListInsertEnd( &xSuspendedTaskList, &( pxTCB->xStateListItem ) );
+            taskCLEAR_READY_TIME( pxTCB );
+
+            #if ( configUSE_TASK_NOTIFICATIONS == 1 )
+            {
+                BaseType_t x;
+
+                for( x = 0; x < configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
+                {
+                    if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+                    {
+                        /* The task was blocked to wait for a notification, but is
+                         * now suspended, so no notification was received. */
+                        pxTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+                    }
+                }
+            }
+            #endif /* if ( configUSE_TASK_NOTIFICATIONS == 1 ) */
+        }
+        taskEXIT_CRITICAL();
+
+        if( xSchedulerRunning != pdFALSE )
+        {
+            /* Reset the next expected unblock time in case it referred to the
+             * task that is now in the Suspended state. */
+            taskENTER_CRITICAL();
+            {
+                prvResetNextTaskUnblockTime();
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pxTCB == pxCurrentTCB )
+        {
+            if( xSchedulerRunning != pdFALSE )
+            {
+                /* The current task has just been suspended. */
+                configASSERT( uxSchedulerSuspended == 0 );
                 portYIELD_WITHIN_API();
             }
             else
@@ -1935,6 +2850,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                     /* The delayed or ready lists cannot be accessed so the task
                      * is held in the pending ready list until the scheduler is
                      * unsuspended. */
+                    taskRECORD_READY_TIME( pxTCB );
                     vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
             }
@@ -2105,6 +3021,21 @@ void vTaskSuspendAll( void )
     /* Enforces ordering for ports and optimised compilers that may otherwise place
      * the above increment elsewhere. */
     portMEMORY_BARRIER();
+
+    #if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
+    {
+        /* Time the outermost suspension once the scheduler is running, which is
+         * when the port starts the timer. */
+        if( ( uxSchedulerSuspended == ( UBaseType_t ) 1U ) && ( xSchedulerRunning != pdFALSE ) )
+        {
+            vCriticalSectionProfileEnter( critprofSCHEDULER_LOCKED, portCRITICAL_SECTION_CALLER() );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif
 }
 /*----------------------------------------------------------*/
 
@@ -2163,6 +3094,45 @@ void vTaskSuspendAll( void )
         else
         {
             xReturn = xNextTaskUnblockTime - xTickCount;
+
+            #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+            {
+                /* Do not sleep through the next time triggered release. */
+                if( ( listLIST_IS_EMPTY( pxTimeTriggeredReleaseList ) == pdFALSE ) && ( ( TickType_t ) ( xNextTimeTriggeredRelease - xTickCount ) < xReturn ) )
+                {
+                    xReturn = xNextTimeTriggeredRelease - xTickCount;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TIME_TRIGGERED_TASKS */
+
+            #if ( configUSE_HARD_TIMERS == 1 )
+            {
+                TickType_t xNextHardExpiry;
+
+                /* Hard timers are only processed by real tick interrupts, and
+                 * the tick at which the sleep ends is not one, so wake one tick
+                 * before the next hard timer expires. */
+                if( xTimerGetNextHardExpiryTime( &xNextHardExpiry ) != pdFALSE )
+                {
+                    if( ( TickType_t ) ( xNextHardExpiry - xTickCount - ( TickType_t ) 1 ) < xReturn )
+                    {
+                        xReturn = xNextHardExpiry - xTickCount - ( TickType_t ) 1;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_HARD_TIMERS */
         }
 
         return xReturn;
@@ -2173,13 +3143,45 @@ void vTaskSuspendAll( void )
 
 BaseType_t xTaskResumeAll( void )
 {
-    TCB_t * pxTCB = NULL;
+    UBaseType_t uxTasksMoved = 0, uxBatchMoved;
     BaseType_t xAlreadyYielded = pdFALSE;
 
     /* If uxSchedulerSuspended is zero then this function does not match a
      * previous call to vTaskSuspendAll(). */
     configASSERT( uxSchedulerSuspended );
 
+    #if ( configPENDING_READY_LIST_DRAIN_BATCH > 0 )
+    {
+        /* If the scheduler is about to be resumed, move the pending ready
+         * tasks in bounded batches while the scheduler is still suspended, so
+         * interrupts are only masked for one batch at a time.  Keeping the
+         * scheduler suspended means interrupts that occur between batches
+         * still add to the pending ready list rather than the ready lists, and
+         * no context switch can occur until all the tasks have been moved.
+         * uxSchedulerSuspended is only modified by the calling task so can be
+         * read outside of a critical section. */
+        if( uxSchedulerSuspended == ( UBaseType_t ) 1U )
+        {
+            do
+            {
+                taskENTER_CRITICAL();
+                {
+                    traceTASK_RESUME_ALL_DRAIN_START();
+                    uxBatchMoved = prvMovePendingReadyTasks( ( UBaseType_t ) configPENDING_READY_LIST_DRAIN_BATCH );
+                    traceTASK_RESUME_ALL_DRAIN_END( uxBatchMoved );
+                }
+                taskEXIT_CRITICAL();
+
+                uxTasksMoved += uxBatchMoved;
+            } while( uxBatchMoved == ( UBaseType_t ) configPENDING_READY_LIST_DRAIN_BATCH );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configPENDING_READY_LIST_DRAIN_BATCH */
+
     /* It is possible that an ISR caused a task to be removed from an event
      * list while the scheduler was suspended.  If this was the case then the
      * removed task will have been added to the xPendingReadyList.  Once the
@@ -2191,31 +3193,30 @@ BaseType_t xTaskResumeAll( void )
 
         if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
         {
-            if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
+            #if ( configRECORD_CRITICAL_SECTION_TIMES == 1 )
             {
-                /* Move any readied tasks from the pending list into the
-                 * appropriate ready list. */
-                while( listLIST_IS_EMPTY( &xPendingReadyList ) == pdFALSE )
+                if( xSchedulerRunning != pdFALSE )
                 {
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-                    listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
-                    portMEMORY_BARRIER();
-                    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
-                    prvAddTaskToReadyList( pxTCB );
-
-                    /* If the moved task has a priority higher than or equal to
-                     * the current task then a yield must be performed. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-                    {
-                        xYieldPending = pdTRUE;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+                    vCriticalSectionProfileExit( critprofSCHEDULER_LOCKED );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
                 }
+            }
+            #endif
 
-                if( pxTCB != NULL )
+            if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
+            {
+                /* Move any readied tasks from the pending list into the
+                 * appropriate ready list.  If the list was drained in batches
+                 * above then only tasks readied since the last batch remain. */
+                traceTASK_RESUME_ALL_DRAIN_START();
+                uxBatchMoved = prvMovePendingReadyTasks( ( UBaseType_t ) ~( ( UBaseType_t ) 0U ) );
+                traceTASK_RESUME_ALL_DRAIN_END( uxBatchMoved );
+                uxTasksMoved += uxBatchMoved;
+
+                if( uxTasksMoved != ( UBaseType_t ) 0U )
                 {
                     /* A task was unblocked while the scheduler was suspended,
                      * which may have prevented the next unblock time from being
@@ -2283,6 +3284,37 @@ BaseType_t xTaskResumeAll( void )
 }
 /*-----------------------------------------------------------*/
 
+static UBaseType_t prvMovePendingReadyTasks( UBaseType_t uxMaxTasks )
+{
+    TCB_t * pxTCB;
+    UBaseType_t uxTasksMoved = 0;
+
+    while( ( uxTasksMoved < uxMaxTasks ) && ( listLIST_IS_EMPTY( &xPendingReadyList ) == pdFALSE ) )
+    {
+        pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+        portMEMORY_BARRIER();
+        listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+        prvAddTaskToReadyList( pxTCB );
+
+        /* If the moved task has a priority higher than or equal to
+         * the current task then a yield must be performed. */
+        if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+        {
+            xYieldPending = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxTasksMoved++;
+    }
+
+    return uxTasksMoved;
+}
+/*-----------------------------------------------------------*/
+
 TickType_t xTaskGetTickCount( void )
 {
     TickType_t xTicks;
@@ -2456,6 +3488,16 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
             }
 
+            #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+            {
+                if( pxTCB == NULL )
+                {
+                    /* Search the list of tasks waiting to be released. */
+                    pxTCB = prvSearchForNameWithinSingleList( &xTimeTriggeredWaitList, pcNameToQuery );
+                }
+            }
+            #endif
+
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
                 if( pxTCB == NULL )
@@ -2510,6 +3552,14 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
                 uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
 
+                #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+                {
+                    /* Fill in an TaskStatus_t structure with information on
+                     * each task waiting for its time triggered release. */
+                    uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xTimeTriggeredWaitList, eBlocked );
+                }
+                #endif
+
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
                     /* Fill in an TaskStatus_t structure with information on
@@ -2548,15 +3598,78 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
             }
             else
             {
-                mtCOVERAGE_TEST_MARKER();
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return uxTask;
+    }
+
+#endif /* configUSE_TRACE_FACILITY */
+/*----------------------------------------------------------*/
+
+#if ( configUSE_TASK_ITERATOR == 1 )
+
+    void vTaskIteratorStart( TaskIterator_t * pxIterator )
+    {
+        configASSERT( pxIterator );
+
+        taskENTER_CRITICAL();
+        {
+            pxIterator->xNextTask = pxFirstCreatedTCB;
+            pxIterator->uxGeneration = uxTaskSetGeneration;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_TASK_ITERATOR */
+/*----------------------------------------------------------*/
+
+#if ( configUSE_TASK_ITERATOR == 1 )
+
+    BaseType_t xTaskIteratorNext( TaskIterator_t * pxIterator,
+                                  TaskStatus_t * pxTaskStatus,
+                                  UBaseType_t uxFields )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xReturn;
+
+        configASSERT( pxIterator );
+        configASSERT( pxTaskStatus );
+
+        /* Tasks are only created and deleted by tasks, so cannot be while the
+         * scheduler is suspended, and the task the iterator refers to still
+         * exists if the generation has not changed. */
+        vTaskSuspendAll();
+        {
+            if( pxIterator->uxGeneration != uxTaskSetGeneration )
+            {
+                xReturn = taskITERATOR_CHANGED;
+            }
+            else if( pxIterator->xNextTask == NULL )
+            {
+                xReturn = pdFALSE;
+            }
+            else
+            {
+                pxTCB = pxIterator->xNextTask;
+
+                vTaskGetInfo( pxTCB,
+                              pxTaskStatus,
+                              ( ( uxFields & tskSTATUS_STACK_HIGH_WATER_MARK ) != ( UBaseType_t ) 0U ) ? pdTRUE : pdFALSE,
+                              eInvalid );
+
+                pxIterator->xNextTask = pxTCB->pxNextCreatedTCB;
+                xReturn = pdTRUE;
             }
         }
         ( void ) xTaskResumeAll();
 
-        return uxTask;
+        return xReturn;
     }
 
-#endif /* configUSE_TRACE_FACILITY */
+#endif /* configUSE_TASK_ITERATOR */
 /*----------------------------------------------------------*/
 
 #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
@@ -2585,11 +3698,13 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
          * each stepped tick. */
         configASSERT( ( xTickCount + xTicksToJump ) <= xNextTaskUnblockTime );
 
-        if( ( xTickCount + xTicksToJump ) == xNextTaskUnblockTime )
+        if( ( ( xTickCount + xTicksToJump ) == xNextTaskUnblockTime ) ||
+            ( taskIS_TIME_TRIGGERED_RELEASE( xTickCount + xTicksToJump ) != pdFALSE ) )
         {
             /* Arrange for xTickCount to reach xNextTaskUnblockTime in
              * xTaskIncrementTick() when the scheduler resumes.  This ensures
-             * that any delayed tasks are resumed at the correct time. */
+             * that any delayed tasks, and any time triggered tasks, are
+             * resumed at the correct time. */
             configASSERT( uxSchedulerSuspended );
             configASSERT( xTicksToJump != ( TickType_t ) 0 );
 
@@ -2649,8 +3764,13 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
         vTaskSuspendAll();
         {
             /* A task can only be prematurely removed from the Blocked state if
-             * it is actually in the Blocked state. */
-            if( eTaskGetState( xTask ) == eBlocked )
+             * it is actually in the Blocked state, and not if it is only there
+             * because it has exhausted its CPU budget. */
+            #if ( configUSE_TASK_BUDGETS == 1 )
+                if( ( eTaskGetState( xTask ) == eBlocked ) && ( pxTCB->ucCpuBudgetHeld == pdFALSE ) )
+            #else
+                if( eTaskGetState( xTask ) == eBlocked )
+            #endif
             {
                 xReturn = pdPASS;
 
@@ -2833,6 +3953,43 @@ BaseType_t xTaskIncrementTick( void )
             }
         }
 
+        /* Release any time triggered tasks whose frame starts on this tick.
+         * The schedule is only scanned on ticks at which a release is due. */
+        #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+        {
+            if( taskIS_TIME_TRIGGERED_RELEASE( xConstTickCount ) != pdFALSE )
+            {
+                if( prvReleaseTimeTriggeredTasks( xConstTickCount ) != pdFALSE )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_TIME_TRIGGERED_TASKS */
+
+        /* Charge the tick to the running task, and hold it off the processor
+         * if it has used all of its budget for the current period. */
+        #if ( configUSE_TASK_BUDGETS == 1 )
+        {
+            if( prvChargeCpuBudget( xConstTickCount ) != pdFALSE )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_TASK_BUDGETS */
+
         /* Tasks of equal priority to the currently running task will share
          * processing time (time slice) if preemption is on, and the application
          * writer has not explicitly turned time slicing off. */
@@ -2849,6 +4006,22 @@ BaseType_t xTaskIncrementTick( void )
         }
         #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
+        #if ( configUSE_HARD_TIMERS == 1 )
+        {
+            /* Hard timers are processed by the tick interrupt itself, so, like
+             * the tick hook, not while the pended tick count is being unwound.
+             * Any task a callback unblocks is switched to below. */
+            if( xPendedTicks == ( TickType_t ) 0 )
+            {
+                vTimerProcessHardTimers( xConstTickCount );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_HARD_TIMERS */
+
         #if ( configUSE_TICK_HOOK == 1 )
         {
             /* Guard against the tick hook being called when the pended tick
@@ -2881,6 +4054,15 @@ BaseType_t xTaskIncrementTick( void )
     {
         ++xPendedTicks;
 
+        /* Hard timers expire at the tick they are due even if the scheduler is
+         * locked.  The tick count will not catch up until the scheduler is
+         * unlocked so the pended ticks are added to it. */
+        #if ( configUSE_HARD_TIMERS == 1 )
+        {
+            vTimerProcessHardTimers( xTickCount + xPendedTicks );
+        }
+        #endif
+
         /* The tick hook gets called at regular intervals, even if the
          * scheduler is locked. */
         #if ( configUSE_TICK_HOOK == 1 )
@@ -3008,6 +4190,10 @@ BaseType_t xTaskIncrementTick( void )
 
 void vTaskSwitchContext( void )
 {
+    #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+        TCB_t * pxPreviousTCB;
+    #endif
+
     if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
     {
         /* The scheduler is currently suspended - do not allow a context
@@ -3036,7 +4222,34 @@ void vTaskSwitchContext( void )
              * are provided by the application, not the kernel. */
             if( ulTotalRunTime > ulTaskSwitchedInTime )
             {
-                pxCurrentTCB->ulRunTimeCounter += ( ulTotalRunTime - ulTaskSwitchedInTime );
+                configRUN_TIME_COUNTER_TYPE ulRunTime = ulTotalRunTime - ulTaskSwitchedInTime;
+
+                #if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+                {
+                    /* Take off the time interrupt handlers ran for while the
+                     * task was running.  This function runs with interrupts
+                     * that can use the API masked, so the pending time cannot
+                     * change while it is used. */
+                    if( ulPendingInterruptRunTime < ulRunTime )
+                    {
+                        ulRunTime -= ulPendingInterruptRunTime;
+                        ulPendingInterruptRunTime = 0UL;
+                    }
+                    else
+                    {
+                        ulPendingInterruptRunTime -= ulRunTime;
+                        ulRunTime = 0UL;
+                    }
+                }
+                #endif
+
+                pxCurrentTCB->ulRunTimeCounter += ulRunTime;
+
+                #if ( configRECORD_JOB_TIMES == 1 )
+                {
+                    pxCurrentTCB->ulJobRunTime += ulRunTime;
+                }
+                #endif
             }
             else
             {
@@ -3047,9 +4260,51 @@ void vTaskSwitchContext( void )
         }
         #endif /* configGENERATE_RUN_TIME_STATS */
 
+        #if ( configRECORD_JOB_TIMES == 1 )
+        {
+            /* A job ends when the task leaves the Ready state - normally by
+             * blocking to wait for its next activation.  Being preempted does
+             * not end the job. */
+            if( ( pxCurrentTCB->ucJobActive != ( uint8_t ) pdFALSE ) &&
+                ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) == pdFALSE ) )
+            {
+                if( pxCurrentTCB->ulJobRunTime > pxCurrentTCB->ulMaxJobRunTime )
+                {
+                    pxCurrentTCB->ulMaxJobRunTime = pxCurrentTCB->ulJobRunTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxCurrentTCB->ulJobRunTime = 0;
+                pxCurrentTCB->ucJobActive = ( uint8_t ) pdFALSE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configRECORD_JOB_TIMES */
+
         /* Check for stack overflow, if configured. */
         taskCHECK_FOR_STACK_OVERFLOW();
 
+        #if ( configRECORD_STACK_HEADROOM == 1 )
+        {
+            /* The port has just saved the task's context, so pxTopOfStack is
+             * the task's stack pointer. */
+            if( taskSTACK_IS_DEEPER( pxCurrentTCB->pxTopOfStack, pxCurrentTCB->pxLowestTopOfStack ) )
+            {
+                pxCurrentTCB->pxLowestTopOfStack = ( StackType_t * ) pxCurrentTCB->pxTopOfStack;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configRECORD_STACK_HEADROOM */
+
         /* Before the currently running task is switched out, save its errno. */
         #if ( configUSE_POSIX_ERRNO == 1 )
         {
@@ -3057,11 +4312,101 @@ void vTaskSwitchContext( void )
         }
         #endif
 
+        #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+            pxPreviousTCB = pxCurrentTCB;
+        #endif
+
         /* Select a new task to run using either the generic C or port
          * optimised asm code. */
         taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
         traceTASK_SWITCHED_IN();
 
+        #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+        {
+            /* Re-selecting the same task is not a context switch.  A task that
+             * is still in its ready list when it is switched out did not give
+             * up the processor itself. */
+            if( pxCurrentTCB != pxPreviousTCB )
+            {
+                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxPreviousTCB->uxPriority ] ), &( pxPreviousTCB->xStateListItem ) ) != pdFALSE )
+                {
+                    pxPreviousTCB->uxInvoluntarySwitches++;
+                }
+                else
+                {
+                    #if ( configUSE_TASK_BUDGETS == 1 )
+                        if( xCurrentTaskBudgetHeld != pdFALSE )
+                        {
+                            pxPreviousTCB->uxInvoluntarySwitches++;
+                        }
+                        else
+                    #endif
+                    {
+                        pxPreviousTCB->uxVoluntarySwitches++;
+                    }
+                }
+
+                #if ( configUSE_TASK_BUDGETS == 1 )
+                {
+                    xCurrentTaskBudgetHeld = pdFALSE;
+                }
+                #endif
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configRECORD_CONTEXT_SWITCHES */
+
+        #if ( configRECORD_WAKEUP_LATENCY == 1 )
+        {
+            if( pxCurrentTCB->ucReadyTimeValid != ( uint8_t ) pdFALSE )
+            {
+                prvRecordWakeupLatency( pxCurrentTCB, ulTotalRunTime );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configRECORD_WAKEUP_LATENCY */
+
+        #if ( configRECORD_JOB_TIMES == 1 )
+        {
+            /* The first dispatch after the previous job ended starts a new job.
+             * The interval between job starts gives an upper bound on the
+             * task's minimum inter-arrival time. */
+            if( pxCurrentTCB->ucJobActive == ( uint8_t ) pdFALSE )
+            {
+                if( pxCurrentTCB->uxJobCount != ( UBaseType_t ) 0 )
+                {
+                    if( ( pxCurrentTCB->ulMinJobInterval == 0 ) ||
+                        ( ( ulTotalRunTime - pxCurrentTCB->ulJobStartTime ) < pxCurrentTCB->ulMinJobInterval ) )
+                    {
+                        pxCurrentTCB->ulMinJobInterval = ulTotalRunTime - pxCurrentTCB->ulJobStartTime;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxCurrentTCB->ulJobStartTime = ulTotalRunTime;
+                pxCurrentTCB->uxJobCount++;
+                pxCurrentTCB->ucJobActive = ( uint8_t ) pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configRECORD_JOB_TIMES */
+
         /* After the new task is switched in, update the global errno. */
         #if ( configUSE_POSIX_ERRNO == 1 )
         {
@@ -3211,6 +4556,7 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
     {
         /* The delayed and ready lists cannot be accessed, so hold this task
          * pending until the scheduler is resumed. */
+        taskRECORD_READY_TIME( pxUnblockedTCB );
         listINSERT_END( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
     }
 
@@ -3679,6 +5025,16 @@ static void prvInitialiseTaskLists( void )
     }
     #endif /* INCLUDE_vTaskSuspend */
 
+    #if ( configUSE_TIME_TRIGGERED_TASKS == 1 )
+    {
+        vListInitialise( &xTimeTriggeredWaitList );
+        vListInitialise( &xTimeTriggeredReleaseList1 );
+        vListInitialise( &xTimeTriggeredReleaseList2 );
+        pxTimeTriggeredReleaseList = &xTimeTriggeredReleaseList1;
+        pxOverflowTimeTriggeredReleaseList = &xTimeTriggeredReleaseList2;
+    }
+    #endif /* configUSE_TIME_TRIGGERED_TASKS */
+
     /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
      * using list2. */
     pxDelayedTaskList = &xDelayedTaskList1;
@@ -3756,6 +5112,49 @@ static void prvCheckTasksWaitingTermination( void )
         }
         #endif
 
+        #if ( configUSE_TASK_BUDGETS == 1 )
+        {
+            pxTaskStatus->xCpuBudget = pxTCB->xCpuBudget;
+            pxTaskStatus->xCpuBudgetPeriod = pxTCB->xCpuBudgetPeriod;
+            pxTaskStatus->uxCpuBudgetOverruns = pxTCB->uxCpuBudgetOverruns;
+
+            /* The budget is only replenished when the task next runs, so report
+             * nothing used if the period has already ended. */
+            if( ( pxTCB->xCpuBudget != ( TickType_t ) 0 ) &&
+                ( ( TickType_t ) ( xTickCount - pxTCB->xCpuBudgetPeriodStart ) < pxTCB->xCpuBudgetPeriod ) )
+            {
+                pxTaskStatus->xCpuBudgetUsed = pxTCB->xCpuBudgetUsed;
+            }
+            else
+            {
+                pxTaskStatus->xCpuBudgetUsed = ( TickType_t ) 0;
+            }
+        }
+        #endif /* configUSE_TASK_BUDGETS */
+
+        #if ( configRECORD_JOB_TIMES == 1 )
+        {
+            pxTaskStatus->ulMaxJobRunTime = pxTCB->ulMaxJobRunTime;
+            pxTaskStatus->ulMinJobInterval = pxTCB->ulMinJobInterval;
+            pxTaskStatus->uxJobCount = pxTCB->uxJobCount;
+        }
+        #endif
+
+        #if ( configRECORD_CONTEXT_SWITCHES == 1 )
+        {
+            pxTaskStatus->uxVoluntarySwitches = pxTCB->uxVoluntarySwitches;
+            pxTaskStatus->uxInvoluntarySwitches = pxTCB->uxInvoluntarySwitches;
+        }
+        #endif
+
+        #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        {
+            pxTaskStatus->xHeapBytesInUse = pxTCB->xHeapBytesInUse;
+            pxTaskStatus->xHeapBytesPeak = pxTCB->xHeapBytesPeak;
+            pxTaskStatus->xHeapQuota = pxTCB->xHeapQuota;
+        }
+        #endif
+
         /* Obtaining the task state is a little fiddly, so is only done if the
          * value of eState passed into this function is eInvalid - otherwise the
          * state is just set to whatever is passed in. */
@@ -3798,15 +5197,7 @@ static void prvCheckTasksWaitingTermination( void )
          * parameter is provided to allow it to be skipped. */
         if( xGetFreeStackSpace != pdFALSE )
         {
-            #if ( portSTACK_GROWTH > 0 )
-            {
-                pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
-            }
-            #else
-            {
-                pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxStack );
-            }
-            #endif
+            pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( pxTCB );
         }
         else
         {
@@ -3855,17 +5246,29 @@ static void prvCheckTasksWaitingTermination( void )
 
 #if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
 
-    static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
+    static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( TCB_t * pxTCB )
     {
+        const StackType_t * pxStackWord;
         uint32_t ulCount = 0U;
 
-        while( *pucStackByte == ( uint8_t ) tskSTACK_FILL_BYTE )
+        /* Count the words at the end of the stack that still hold the fill
+         * value.  The stack is word aligned, so comparing whole words gives
+         * the same count as comparing bytes. */
+        #if ( portSTACK_GROWTH < 0 )
         {
-            pucStackByte -= portSTACK_GROWTH;
-            ulCount++;
+            pxStackWord = pxTCB->pxStack;
         }
+        #else
+        {
+            pxStackWord = pxTCB->pxEndOfStack;
+        }
+        #endif
 
-        ulCount /= ( uint32_t ) sizeof( StackType_t ); /*lint !e961 Casting is not redundant on smaller architectures. */
+        while( *pxStackWord == tskSTACK_FILL_WORD )
+        {
+            pxStackWord -= portSTACK_GROWTH;
+            ulCount++;
+        }
 
         return ( configSTACK_DEPTH_TYPE ) ulCount;
     }
@@ -3883,7 +5286,6 @@ static void prvCheckTasksWaitingTermination( void )
     configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask )
     {
         TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
         configSTACK_DEPTH_TYPE uxReturn;
 
         /* uxTaskGetStackHighWaterMark() and uxTaskGetStackHighWaterMark2() are
@@ -3895,17 +5297,7 @@ static void prvCheckTasksWaitingTermination( void )
 
         pxTCB = prvGetTCBFromHandle( xTask );
 
-        #if portSTACK_GROWTH < 0
-        {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
-        }
-        #else
-        {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
-        }
-        #endif
-
-        uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+        uxReturn = prvTaskCheckFreeStackSpace( pxTCB );
 
         return uxReturn;
     }
@@ -3918,27 +5310,72 @@ static void prvCheckTasksWaitingTermination( void )
     UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
     {
         TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
         UBaseType_t uxReturn;
 
         pxTCB = prvGetTCBFromHandle( xTask );
 
-        #if portSTACK_GROWTH < 0
+        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pxTCB );
+
+        return uxReturn;
+    }
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+/*-----------------------------------------------------------*/
+
+#if ( configRECORD_STACK_HEADROOM == 1 )
+
+    configSTACK_DEPTH_TYPE uxTaskGetStackHeadroom( TaskHandle_t xTask )
+    {
+        const TCB_t * pxTCB;
+        configSTACK_DEPTH_TYPE uxReturn;
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        /* Only read, and only written by the task's own context switches, so
+         * no critical section is needed. */
+        #if ( portSTACK_GROWTH < 0 )
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+            uxReturn = ( configSTACK_DEPTH_TYPE ) ( pxTCB->pxLowestTopOfStack - pxTCB->pxStack );
         }
         #else
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+            uxReturn = ( configSTACK_DEPTH_TYPE ) ( pxTCB->pxEndOfStack - pxTCB->pxLowestTopOfStack );
         }
         #endif
 
-        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
-
         return uxReturn;
     }
 
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+#endif /* configRECORD_STACK_HEADROOM */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TCB_HOT_COLD_SPLIT == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+    static TCB_t * prvAllocateAlignedTCB( void )
+    {
+        uint8_t * pucAllocation;
+        uint8_t * pucTCB = NULL;
+
+        pucAllocation = ( uint8_t * ) taskMALLOC_TCB_MEMORY( sizeof( TCB_t ) + sizeof( void * ) + ( size_t ) configTCB_CACHE_LINE_SIZE - ( size_t ) 1 );
+
+        if( pucAllocation != NULL )
+        {
+            /* Leave room for the pointer to the allocation before rounding up
+             * to the cache line.  A cache line is a multiple of the pointer
+             * size, so the word before the TCB is pointer aligned. */
+            pucTCB = ( uint8_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pucAllocation + sizeof( void * ) ) + ( portPOINTER_SIZE_TYPE ) ( configTCB_CACHE_LINE_SIZE - 1 ) ) &
+                                     ~( ( portPOINTER_SIZE_TYPE ) ( configTCB_CACHE_LINE_SIZE - 1 ) ) );
+            ( ( void ** ) pucTCB )[ -1 ] = ( void * ) pucAllocation;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return ( TCB_t * ) pucTCB; /*lint !e826 !e9087 The TCB is aligned to a cache line, which is at least the alignment it requires. */
+    }
+
+#endif /* ( configUSE_TCB_HOT_COLD_SPLIT == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
 /*-----------------------------------------------------------*/
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -3950,6 +5387,23 @@ static void prvCheckTasksWaitingTermination( void )
          * want to allocate and clean RAM statically. */
         portCLEAN_UP_TCB( pxTCB );
 
+        #if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+        {
+            /* Blocks the task allocated and did not free outlive it, so must no
+             * longer reference its TCB.  Most tasks free everything they
+             * allocate, so the heap is only searched if the task still holds
+             * some of it. */
+            if( pxTCB->xHeapBytesInUse != ( size_t ) 0 )
+            {
+                vPortDisownHeapBlocks( pxTCB, pxTCB->xHeapBytesInUse );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif
+
         #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
         {
             /* Free up the memory allocated for the task's TLS Block. */
@@ -3962,7 +5416,7 @@ static void prvCheckTasksWaitingTermination( void )
             /* The task can only have been allocated dynamically - free both
              * the stack and TCB. */
             vPortFreeStack( pxTCB->pxStack );
-            vPortFree( pxTCB );
+            taskFREE_TCB( pxTCB );
         }
         #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
         {
@@ -3974,13 +5428,13 @@ static void prvCheckTasksWaitingTermination( void )
                 /* Both the stack and TCB were allocated dynamically, so both
                  * must be freed. */
                 vPortFreeStack( pxTCB->pxStack );
-                vPortFree( pxTCB );
+                taskFREE_TCB( pxTCB );
             }
             else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
             {
                 /* Only the stack was statically allocated, so the TCB is the
                  * only memory that must be freed. */
-                vPortFree( pxTCB );
+                taskFREE_TCB( pxTCB );
             }
             else
             {
@@ -5075,6 +6529,7 @@ TickType_t uxTaskResetEventItemValue( void )
                 {
                     /* The delayed and ready lists cannot be accessed, so hold
                      * this task pending until the scheduler is resumed. */
+                    taskRECORD_READY_TIME( pxTCB );
                     listINSERT_END( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
 
@@ -5166,6 +6621,7 @@ TickType_t uxTaskResetEventItemValue( void )
                 {
                     /* The delayed and ready lists cannot be accessed, so hold
                      * this task pending until the scheduler is resumed. */
+                    taskRECORD_READY_TIME( pxTCB );
                     listINSERT_END( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
 
@@ -5294,6 +6750,30 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( configRECORD_INTERRUPT_RUN_TIME == 1 )
+
+    void vTaskAddInterruptRunTime( configRUN_TIME_COUNTER_TYPE ulTime )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* Nested interrupts can report their time too. */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            ulPendingInterruptRunTime += ulTime;
+            ulInterruptRunTime += ulTime;
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    configRUN_TIME_COUNTER_TYPE ulTaskGetInterruptRunTimeCounter( void )
+    {
+        return ulInterruptRunTime;
+    }
+
+#endif /* configRECORD_INTERRUPT_RUN_TIME */
+/*-----------------------------------------------------------*/
+
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely )
 {
@@ -5309,6 +6789,15 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
     }
     #endif
 
+    #if ( configUSE_TASK_BUDGETS == 1 )
+    {
+        /* The task is blocking of its own accord.  prvChargeCpuBudget() sets
+         * the flag again after calling this function if the task is instead
+         * being held because its budget is exhausted. */
+        pxCurrentTCB->ucCpuBudgetHeld = pdFALSE;
+    }
+    #endif
+
     /* Remove the task from the ready list before adding it to the blocked list
      * as the same list item is used for both lists. */
     if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
@@ -70,6 +70,11 @@
     #define tmrSTATUS_IS_ACTIVE                  ( ( uint8_t ) 0x01 )
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x02 )
     #define tmrSTATUS_IS_AUTORELOAD              ( ( uint8_t ) 0x04 )
+    #define tmrSTATUS_IS_HARD                    ( ( uint8_t ) 0x08 )
+
+/* The notification value the timer service task sends to a task once the
+ * command batch the task sent has been carried out. */
+    #define tmrBATCH_COMPLETE                    ( ( uint32_t ) 0x80000000UL )
 
 /* The definition of the timers themselves. */
     typedef struct tmrTimerControl                  /* The old naming convention is used to prevent breaking kernel aware debuggers. */
@@ -82,6 +87,9 @@
         #if ( configUSE_TRACE_FACILITY == 1 )
             UBaseType_t uxTimerNumber;              /*<< An ID assigned by trace tools such as FreeRTOS+Trace */
         #endif
+        #if ( configUSE_TIMER_SLACK == 1 )
+            TickType_t xTimerSlackInTicks;          /*<< How long after its expiry time the timer may be processed, so its expiry can be coalesced with that of other timers. */
+        #endif
         uint8_t ucStatus;                           /*<< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
     } xTIMER;
 
@@ -108,6 +116,13 @@
         uint32_t ulParameter2;               /* << The value that will be used as the callback functions second parameter. */
     } CallbackParameters_t;
 
+    typedef struct tmrBatchParameters
+    {
+        const TimerBatchCommand_t * pxCommands; /* << The commands to carry out. */
+        UBaseType_t uxNumberOfCommands;         /* << The number of entries in pxCommands. */
+        TaskHandle_t xSendingTask;              /* << The task to notify once the commands have been carried out, or NULL. */
+    } BatchParameters_t;
+
 /* The structure that contains the two message types, along with an identifier
  * that is used to determine which message type is valid. */
     typedef struct tmrTimerQueueMessage
@@ -122,6 +137,10 @@
             #if ( INCLUDE_xTimerPendFunctionCall == 1 )
                 CallbackParameters_t xCallbackParameters;
             #endif /* INCLUDE_xTimerPendFunctionCall */
+
+            #if ( configUSE_TIMER_BATCH_COMMANDS == 1 )
+                BatchParameters_t xBatchParameters;
+            #endif /* configUSE_TIMER_BATCH_COMMANDS */
         } u;
     } DaemonTaskMessage_t;
 
@@ -139,10 +158,80 @@
     PRIVILEGED_DATA static List_t * pxCurrentTimerList;
     PRIVILEGED_DATA static List_t * pxOverflowTimerList;
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/* When the timing wheel is used, the active timers that expire before the
+ * tick count next overflows are held unsorted in a hierarchy of wheels, and the
+ * overflow list holds, unsorted, the timers that expire after it overflows.
+ * The current timer list is not used.
+ *
+ * Each level of the wheel has configTIMER_WHEEL_SLOTS slots and takes the next
+ * tmrWHEEL_SLOT_BITS bits of the expiry time as the slot number, so each slot
+ * of level 0 covers one tick, each slot of level 1 covers
+ * configTIMER_WHEEL_SLOTS ticks, and so on, with enough levels to cover every
+ * bit of TickType_t.  A timer is held in the lowest level at which its expiry
+ * time and xTimerWheelBase have the same bits above the slot number, so every
+ * timer in a slot of level 0 expires at the same tick, and every timer in a
+ * level expires before every timer in the levels above it.  When
+ * xTimerWheelBase reaches the start of a slot above level 0 the timers in the
+ * slot are moved down, which happens at most once per level for each timer.
+ * xTimerWheelBase is never later than the tick count or than the expiry time
+ * of any active timer.  A bit is set in ulTimerWheelSlotsInUse for each slot
+ * that is not empty, so the next slot is found without searching the slots. */
+        #if ( configTIMER_WHEEL_SLOTS == 256 )
+            #define tmrWHEEL_SLOT_BITS    8U
+        #elif ( configTIMER_WHEEL_SLOTS == 128 )
+            #define tmrWHEEL_SLOT_BITS    7U
+        #elif ( configTIMER_WHEEL_SLOTS == 64 )
+            #define tmrWHEEL_SLOT_BITS    6U
+        #elif ( configTIMER_WHEEL_SLOTS == 32 )
+            #define tmrWHEEL_SLOT_BITS    5U
+        #elif ( configTIMER_WHEEL_SLOTS == 16 )
+            #define tmrWHEEL_SLOT_BITS    4U
+        #elif ( configTIMER_WHEEL_SLOTS == 8 )
+            #define tmrWHEEL_SLOT_BITS    3U
+        #elif ( configTIMER_WHEEL_SLOTS == 4 )
+            #define tmrWHEEL_SLOT_BITS    2U
+        #else
+            #error configTIMER_WHEEL_SLOTS must be a power of 2 from 4 to 256.
+        #endif
+
+        #define tmrWHEEL_TICK_BITS     ( sizeof( TickType_t ) * 8U )
+        #define tmrWHEEL_LEVELS        ( ( tmrWHEEL_TICK_BITS + tmrWHEEL_SLOT_BITS - 1U ) / tmrWHEEL_SLOT_BITS )
+        #define tmrWHEEL_WORDS         ( ( configTIMER_WHEEL_SLOTS + 31 ) / 32 )
+        #define tmrWHEEL_SLOT_MASK     ( ( TickType_t ) ( configTIMER_WHEEL_SLOTS - 1 ) )
+
+        PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ configTIMER_WHEEL_SLOTS ];
+        PRIVILEGED_DATA static uint32_t ulTimerWheelSlotsInUse[ tmrWHEEL_LEVELS ][ tmrWHEEL_WORDS ];
+        PRIVILEGED_DATA static TickType_t xTimerWheelBase = ( TickType_t ) 0U;
+    #endif /* configUSE_TIMER_WHEEL */
+
+    #if ( configUSE_HARD_TIMERS == 1 )
+
+/* Active hard timers, held in the same way as the active timer lists above but
+ * only accessed with interrupts masked.  xHardTimerTimeNow is the tick count
+ * at which the hard timers were last processed. */
+        PRIVILEGED_DATA static List_t xHardTimerList1;
+        PRIVILEGED_DATA static List_t xHardTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentHardTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowHardTimerList;
+        PRIVILEGED_DATA static TickType_t xHardTimerTimeNow = ( TickType_t ) configINITIAL_TICK_COUNT;
+    #endif /* configUSE_HARD_TIMERS */
+
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
     PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
 
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+/* The number of timers that have expired, and the number of times the timer
+ * service task has woken from blocking to process expired timers.  The ratio
+ * shows how many expiries each wake up is coalescing. */
+        PRIVILEGED_DATA static uint32_t ulTimerExpiries = 0UL;
+        PRIVILEGED_DATA static uint32_t ulTimerExpiryWakeups = 0UL;
+        PRIVILEGED_DATA static BaseType_t xTimerTaskHasBlocked = pdFALSE;
+    #endif /* configUSE_TIMER_SLACK */
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -166,6 +255,24 @@
  */
     static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Carry out a single start, reset, stop, change period or delete command on a
+ * timer managed by the timer service task.
+ */
+    static void prvProcessTimerCommand( const BaseType_t xCommandID,
+                                        Timer_t * const pxTimer,
+                                        const TickType_t xMessageValue ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_BATCH_COMMANDS == 1 )
+
+/*
+ * Carry out every command in a batch sent by xTimerSendCommandBatch(), then
+ * notify the task that sent it.
+ */
+    static void prvProcessTimerBatch( const BatchParameters_t * const pxBatch ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_BATCH_COMMANDS */
+
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
  * depending on if the expire time causes a timer counter overflow.
@@ -184,6 +291,42 @@
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+/*
+ * Return an active timer that expires at xNextExpireTime, the time returned by
+ * prvGetNextExpireTime().
+ */
+    static Timer_t * prvGetExpiredTimer( const TickType_t xNextExpireTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove an active timer from the list or timing wheel slot that holds it.
+ */
+    static void prvRemoveTimerFromActiveList( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+
+/*
+ * If the timing wheel holds any timers then set *pxExpireTime to the start of
+ * the first slot in use and return the level of the slot.  For a slot of level
+ * 0 that is the expire time of the timers in it.  If the wheel is empty return
+ * tmrWHEEL_LEVELS.
+ */
+    static UBaseType_t prvGetWheelExpireTime( TickType_t * const pxExpireTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a timer that expires no earlier than xTimerWheelBase, and before the
+ * tick count overflows, to the timing wheel slot for its expiry time.
+ */
+    static void prvInsertTimerInWheel( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move xTimerWheelBase up to xTimeNow, or to the expire time of the first
+ * active timer if that is earlier, moving down the timers in each slot above
+ * level 0 the base reaches on the way.
+ */
+    static void prvAdvanceTimerWheel( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
@@ -211,6 +354,17 @@
  */
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_TIMER_SLACK == 1 )
+
+/*
+ * Returns the latest time the timer service task can wake and still process
+ * every timer within its slack, given that the first timer expires at
+ * xNextExpireTime.
+ */
+    static TickType_t prvGetCoalescedWakeTime( const TickType_t xNextExpireTime ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_SLACK */
+
 /*
  * If a timer has expired, process it.  Otherwise, block the timer service task
  * until either a timer does expire or a command is received.
@@ -218,6 +372,33 @@
     static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_HARD_TIMERS == 1 )
+
+/*
+ * Insert a hard timer into the current or overflow hard timer list depending
+ * on whether xNextExpiryTime is after the tick count overflows.  Must be called
+ * with interrupts masked.
+ */
+    static void prvInsertHardTimer( Timer_t * const pxTimer,
+                                    const TickType_t xNextExpiryTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove a hard timer that has reached its expiry time from the active hard
+ * timers, reload it if it is an auto-reload timer, then call its callback.
+ */
+    static void prvExpireHardTimer( Timer_t * const pxTimer,
+                                    const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Perform a timer command on a hard timer immediately, rather than sending it
+ * to the timer service task.
+ */
+    static void prvHardTimerCommand( Timer_t * const pxTimer,
+                                     const BaseType_t xCommandID,
+                                     const TickType_t xOptionalValue ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_HARD_TIMERS */
+
 /*
  * Called after a Timer_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -374,6 +555,12 @@
         pxNewTimer->pxCallbackFunction = pxCallbackFunction;
         vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
 
+        #if ( configUSE_TIMER_SLACK == 1 )
+        {
+            pxNewTimer->xTimerSlackInTicks = ( TickType_t ) 0U;
+        }
+        #endif
+
         if( xAutoReload != pdFALSE )
         {
             pxNewTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
@@ -390,13 +577,31 @@
                                      const TickType_t xTicksToWait )
     {
         BaseType_t xReturn = pdFAIL;
+        BaseType_t xSendToDaemon = pdTRUE;
         DaemonTaskMessage_t xMessage;
 
         configASSERT( xTimer );
 
+        #if ( configUSE_HARD_TIMERS == 1 )
+        {
+            /* Hard timers are not managed by the timer service task. */
+            if( ( ( ( Timer_t * ) xTimer )->ucStatus & tmrSTATUS_IS_HARD ) != 0 )
+            {
+                prvHardTimerCommand( xTimer, xCommandID, xOptionalValue );
+                xReturn = pdPASS;
+                xSendToDaemon = pdFALSE;
+                traceTIMER_COMMAND_SEND( xTimer, xCommandID, xOptionalValue, xReturn );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_HARD_TIMERS */
+
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
-        if( xTimerQueue != NULL )
+        if( ( xSendToDaemon != pdFALSE ) && ( xTimerQueue != NULL ) )
         {
             /* Send a command to the timer service task to start the xTimer timer. */
             xMessage.xMessageID = xCommandID;
@@ -469,6 +674,58 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        BaseType_t xTimerSetSlack( TimerHandle_t xTimer,
+                                   const TickType_t xSlackInTicks )
+        {
+            Timer_t * pxTimer = xTimer;
+            BaseType_t xReturn;
+
+            configASSERT( xTimer );
+            taskENTER_CRITICAL();
+            {
+                /* A timer processed a whole period late would miss its next
+                 * expiry, so the slack must be shorter than the period. */
+                if( xSlackInTicks < pxTimer->xTimerPeriodInTicks )
+                {
+                    pxTimer->xTimerSlackInTicks = xSlackInTicks;
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    xReturn = pdFAIL;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
+        TickType_t xTimerGetSlack( TimerHandle_t xTimer )
+        {
+            Timer_t * pxTimer = xTimer;
+
+            configASSERT( xTimer );
+            return pxTimer->xTimerSlackInTicks;
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerGetWakeupStats( uint32_t * const pulTimerExpiries,
+                                   uint32_t * const pulExpiryWakeups )
+        {
+            taskENTER_CRITICAL();
+            {
+                *pulTimerExpiries = ulTimerExpiries;
+                *pulExpiryWakeups = ulTimerExpiryWakeups;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
     BaseType_t xTimerGetReloadMode( TimerHandle_t xTimer )
     {
         Timer_t * pxTimer = xTimer;
@@ -538,30 +795,122 @@
     }
 /*-----------------------------------------------------------*/
 
+    static Timer_t * prvGetExpiredTimer( const TickType_t xNextExpireTime )
+    {
+        Timer_t * pxTimer;
+
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            /* prvAdvanceTimerWheel() has been called for a time no earlier
+             * than xNextExpireTime, so any timer that expires then is in
+             * level 0, and every timer in its slot expires at the same time.
+             * xNextExpireTime may instead have been the start of a slot above
+             * level 0, in which case the timers in it have been moved down and
+             * expire later. */
+            const List_t * const pxSlot = &( xTimerWheel[ 0 ][ xNextExpireTime & tmrWHEEL_SLOT_MASK ] );
+
+            if( ( listLIST_IS_EMPTY( pxSlot ) == pdFALSE ) && ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxSlot ) == xNextExpireTime ) )
+            {
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            }
+            else
+            {
+                pxTimer = NULL;
+            }
+        }
+        #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
+        {
+            /* A check has already been performed to ensure the list is not
+             * empty. */
+            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            ( void ) xNextExpireTime;
+        }
+        #endif /* if ( configUSE_TIMER_WHEEL == 1 ) */
+
+        return pxTimer;
+    }
+/*-----------------------------------------------------------*/
+
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        Timer_t * const pxTimer = prvGetExpiredTimer( xNextExpireTime );
 
-        /* Remove the timer from the list of active timers.  A check has already
-         * been performed to ensure the list is not empty. */
+        /* Only NULL with the timing wheel, when no timer expires at
+         * xNextExpireTime. */
+        if( pxTimer != NULL )
+        {
+            #if ( configUSE_TIMER_SLACK == 1 )
+            {
+                ulTimerExpiries++;
+
+                /* Only the first timer processed after the task unblocks counts
+                 * as a wake up. */
+                if( xTimerTaskHasBlocked != pdFALSE )
+                {
+                    ulTimerExpiryWakeups++;
+                    xTimerTaskHasBlocked = pdFALSE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TIMER_SLACK */
 
-        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            /* Remove the timer from the list of active timers.  A check has already
+             * been performed to ensure the list is not empty. */
+            prvRemoveTimerFromActiveList( pxTimer );
 
-        /* If the timer is an auto-reload timer then calculate the next
-         * expiry time and re-insert the timer in the list of active timers. */
-        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
-        {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            /* If the timer is an auto-reload timer then calculate the next
+             * expiry time and re-insert the timer in the list of active timers. */
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+            {
+                prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            }
+            else
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            }
+
+            /* Call the timer callback. */
+            traceTIMER_EXPIRED( pxTimer );
+            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
         }
         else
         {
-            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            mtCOVERAGE_TEST_MARKER();
         }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRemoveTimerFromActiveList( Timer_t * const pxTimer )
+    {
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            const List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+            UBaseType_t uxSlot, uxLevel;
 
-        /* Call the timer callback. */
-        traceTIMER_EXPIRED( pxTimer );
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            if( ( uxListRemove( &( pxTimer->xTimerListItem ) ) == ( UBaseType_t ) 0 ) &&
+                ( pxList >= &( xTimerWheel[ 0 ][ 0 ] ) ) &&
+                ( pxList < &( xTimerWheel[ tmrWHEEL_LEVELS - 1U ][ configTIMER_WHEEL_SLOTS ] ) ) )
+            {
+                /* The timer was the last in its wheel slot. */
+                uxSlot = ( UBaseType_t ) ( pxList - &( xTimerWheel[ 0 ][ 0 ] ) );
+                uxLevel = uxSlot / ( UBaseType_t ) configTIMER_WHEEL_SLOTS;
+                uxSlot %= ( UBaseType_t ) configTIMER_WHEEL_SLOTS;
+                ulTimerWheelSlotsInUse[ uxLevel ][ uxSlot >> 5 ] &= ~( 1UL << ( uxSlot & 31U ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else
+        {
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+        }
+        #endif /* configUSE_TIMER_WHEEL */
     }
 /*-----------------------------------------------------------*/
 
@@ -637,9 +986,27 @@
                         /* The current timer list is empty - is the overflow list
                          * also empty? */
                         xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+                    }
+                    else
+                    {
+                        #if ( configUSE_TIMER_SLACK == 1 )
+                        {
+                            /* Sleep until the last moment every timer can still
+                             * be processed within its slack, so expiries that
+                             * fall within each other's windows share a single
+                             * wake up.  As this is the task's block time it is
+                             * also the time prvGetExpectedIdleTime() lets the
+                             * tick be suppressed until. */
+                            vQueueWaitForMessageRestricted( xTimerQueue, ( prvGetCoalescedWakeTime( xNextExpireTime ) - xTimeNow ), pdFALSE );
+                            xTimerTaskHasBlocked = pdTRUE;
+                        }
+                        #else
+                        {
+                            vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), pdFALSE );
+                        }
+                        #endif /* configUSE_TIMER_SLACK */
                     }
-
-                    vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
                     if( xTaskResumeAll() == pdFALSE )
                     {
@@ -674,22 +1041,213 @@
          * this task to unblock when the tick count overflows, at which point the
          * timer lists will be switched and the next expiry time can be
          * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-
-        if( *pxListWasEmpty == pdFALSE )
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            /* If the first timer is above level 0 of the wheel this is the
+             * start of its slot, so the task unblocks then to move the timers
+             * in the slot down, without processing a timer. */
+            if( prvGetWheelExpireTime( &xNextExpireTime ) < ( UBaseType_t ) tmrWHEEL_LEVELS )
+            {
+                *pxListWasEmpty = pdFALSE;
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                *pxListWasEmpty = pdTRUE;
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
         }
-        else
+        #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
         }
+        #endif /* if ( configUSE_TIMER_WHEEL == 1 ) */
 
         return xNextExpireTime;
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+        static UBaseType_t prvGetWheelExpireTime( TickType_t * const pxExpireTime )
+        {
+            /* Finds the lowest bit set in a word from the top five bits of the
+             * word's lowest set bit multiplied by a de Bruijn sequence, as not
+             * every port has a count trailing zeros instruction. */
+            static const uint8_t ucLowestBitSet[ 32 ] =
+            {
+                0U,  1U,  28U, 2U,  29U, 14U, 24U, 3U,  30U, 22U, 20U, 15U, 25U, 17U, 4U,  8U,
+                31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U,  26U, 12U, 18U, 6U,  11U, 5U,  10U, 9U
+            };
+            UBaseType_t uxLevel, uxWord, uxSlot;
+            UBaseType_t uxReturn = ( UBaseType_t ) tmrWHEEL_LEVELS;
+            uint32_t ulSlotsInUse;
+            TickType_t xLevelStart;
+
+            /* Every timer in a level expires before every timer in the levels
+             * above it, and within a level no slot before the one holding
+             * xTimerWheelBase is in use, so the first bit set is the first
+             * slot. */
+            for( uxLevel = 0; ( uxLevel < ( UBaseType_t ) tmrWHEEL_LEVELS ) && ( uxReturn == ( UBaseType_t ) tmrWHEEL_LEVELS ); uxLevel++ )
+            {
+                for( uxWord = 0; uxWord < ( UBaseType_t ) tmrWHEEL_WORDS; uxWord++ )
+                {
+                    ulSlotsInUse = ulTimerWheelSlotsInUse[ uxLevel ][ uxWord ];
+
+                    if( ulSlotsInUse != 0UL )
+                    {
+                        ulSlotsInUse &= ( ( uint32_t ) 0UL - ulSlotsInUse );
+                        uxSlot = ( uxWord << 5 ) + ( UBaseType_t ) ucLowestBitSet[ ( uint32_t ) ( ulSlotsInUse * 0x077CB531UL ) >> 27 ];
+
+                        /* The slot starts where the bits of xTimerWheelBase
+                         * above the level's slot number are followed by the
+                         * slot number and zeros. */
+                        if( ( ( uxLevel + 1U ) * tmrWHEEL_SLOT_BITS ) < tmrWHEEL_TICK_BITS )
+                        {
+                            xLevelStart = ( TickType_t ) ( ( xTimerWheelBase >> ( ( uxLevel + 1U ) * tmrWHEEL_SLOT_BITS ) ) << ( ( uxLevel + 1U ) * tmrWHEEL_SLOT_BITS ) );
+                        }
+                        else
+                        {
+                            xLevelStart = ( TickType_t ) 0U;
+                        }
+
+                        *pxExpireTime = ( TickType_t ) ( xLevelStart | ( ( TickType_t ) uxSlot << ( uxLevel * tmrWHEEL_SLOT_BITS ) ) );
+                        uxReturn = uxLevel;
+                        break;
+                    }
+                }
+            }
+
+            return uxReturn;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvInsertTimerInWheel( Timer_t * const pxTimer )
+        {
+            const TickType_t xExpireTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+            TickType_t xDifference = xExpireTime ^ xTimerWheelBase;
+            UBaseType_t uxLevel = 0, uxSlot;
+
+            /* The level is the one whose slot number holds the highest bit
+             * in which the expiry time and the base differ. */
+            while( ( xDifference >> tmrWHEEL_SLOT_BITS ) != ( TickType_t ) 0U )
+            {
+                xDifference >>= tmrWHEEL_SLOT_BITS;
+                uxLevel++;
+            }
+
+            uxSlot = ( UBaseType_t ) ( ( xExpireTime >> ( uxLevel * tmrWHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK );
+
+            vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+            ulTimerWheelSlotsInUse[ uxLevel ][ uxSlot >> 5 ] |= ( 1UL << ( uxSlot & 31U ) );
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvAdvanceTimerWheel( const TickType_t xTimeNow )
+        {
+            TickType_t xSlotStart;
+            UBaseType_t uxLevel, uxSlot;
+            List_t * pxSlot;
+            Timer_t * pxTimer;
+
+            for( ; ; )
+            {
+                uxLevel = prvGetWheelExpireTime( &xSlotStart );
+
+                if( ( uxLevel == ( UBaseType_t ) tmrWHEEL_LEVELS ) || ( xSlotStart > xTimeNow ) )
+                {
+                    /* No timer expires before xTimeNow. */
+                    xTimerWheelBase = xTimeNow;
+                    break;
+                }
+                else if( uxLevel == ( UBaseType_t ) 0U )
+                {
+                    /* The base cannot pass a timer that has not been
+                     * processed, as the timer's slot would then be taken for
+                     * a later turn of the wheel. */
+                    xTimerWheelBase = xSlotStart;
+                    break;
+                }
+                else
+                {
+                    /* Every timer in the slot expires at or after its start,
+                     * and in a lower level once the base is there. */
+                    xTimerWheelBase = xSlotStart;
+                    uxSlot = ( UBaseType_t ) ( ( xSlotStart >> ( uxLevel * tmrWHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK );
+                    pxSlot = &( xTimerWheel[ uxLevel ][ uxSlot ] );
+                    ulTimerWheelSlotsInUse[ uxLevel ][ uxSlot >> 5 ] &= ~( 1UL << ( uxSlot & 31U ) );
+
+                    while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                    {
+                        pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                        prvInsertTimerInWheel( pxTimer );
+                    }
+                }
+            }
+        }
+
+    #endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        static TickType_t prvGetCoalescedWakeTime( const TickType_t xNextExpireTime )
+        {
+            TickType_t xWakeTime = tmrMAX_TIME_BEFORE_OVERFLOW;
+            TickType_t xExpireTime, xLatestTime;
+            const ListItem_t * pxItem;
+            const ListItem_t * const pxEnd = listGET_END_MARKER( pxCurrentTimerList );
+
+            /* Walk the timers in expiry order, bringing the wake time forward to
+             * the end of each timer's slack window.  Timers that expire after
+             * the wake time already reached will be processed late anyway, so
+             * the walk stops at the first of them. */
+            for( pxItem = listGET_HEAD_ENTRY( pxCurrentTimerList ); pxItem != pxEnd; pxItem = listGET_NEXT( pxItem ) )
+            {
+                xExpireTime = listGET_LIST_ITEM_VALUE( pxItem );
+
+                if( xExpireTime >= xWakeTime )
+                {
+                    break;
+                }
+
+                xLatestTime = xExpireTime + ( ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem ) )->xTimerSlackInTicks; /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                /* A window that extends past the tick count overflow ends at
+                 * the overflow, as the lists are switched there. */
+                if( xLatestTime < xExpireTime )
+                {
+                    xLatestTime = tmrMAX_TIME_BEFORE_OVERFLOW;
+                }
+
+                if( xLatestTime < xWakeTime )
+                {
+                    xWakeTime = xLatestTime;
+                }
+            }
+
+            /* The head of the list is the first timer, so its expiry time is
+             * always within the wake time. */
+            configASSERT( xWakeTime >= xNextExpireTime );
+            ( void ) xNextExpireTime;
+
+            return xWakeTime;
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
@@ -707,6 +1265,12 @@
             *pxTimerListsWereSwitched = pdFALSE;
         }
 
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            prvAdvanceTimerWheel( xTimeNow );
+        }
+        #endif
+
         xLastTime = xTimeNow;
 
         return xTimeNow;
@@ -735,7 +1299,17 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    /* Moved into the wheel when the lists are switched, so the
+                     * order does not matter. */
+                    vListInsertEnd( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #else
+                {
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #endif
             }
         }
         else
@@ -749,7 +1323,17 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    /* xTimerWheelBase is no later than xTimeNow, so the timer
+                     * does not expire before it. */
+                    prvInsertTimerInWheel( pxTimer );
+                }
+                #else
+                {
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #endif
             }
         }
 
@@ -760,17 +1344,27 @@
     static void prvProcessReceivedCommands( void )
     {
         DaemonTaskMessage_t xMessage;
-        Timer_t * pxTimer;
-        BaseType_t xTimerListsWereSwitched;
-        TickType_t xTimeNow;
 
         while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL ) /*lint !e603 xMessage does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
         {
+            #if ( configUSE_TIMER_BATCH_COMMANDS == 1 )
+            {
+                if( xMessage.xMessageID == tmrCOMMAND_EXECUTE_BATCH )
+                {
+                    prvProcessTimerBatch( &( xMessage.u.xBatchParameters ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TIMER_BATCH_COMMANDS */
+
             #if ( INCLUDE_xTimerPendFunctionCall == 1 )
             {
-                /* Negative commands are pended function calls rather than timer
-                 * commands. */
-                if( xMessage.xMessageID < ( BaseType_t ) 0 )
+                /* Other negative commands are pended function calls rather than
+                 * timer commands. */
+                if( ( xMessage.xMessageID < ( BaseType_t ) 0 ) && ( xMessage.xMessageID != tmrCOMMAND_EXECUTE_BATCH ) )
                 {
                     const CallbackParameters_t * const pxCallback = &( xMessage.u.xCallbackParameters );
 
@@ -794,117 +1388,286 @@
             {
                 /* The messages uses the xTimerParameters member to work on a
                  * software timer. */
-                pxTimer = xMessage.u.xTimerParameters.pxTimer;
+                prvProcessTimerCommand( xMessage.xMessageID, xMessage.u.xTimerParameters.pxTimer, xMessage.u.xTimerParameters.xMessageValue );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvProcessTimerCommand( const BaseType_t xCommandID,
+                                        Timer_t * const pxTimer,
+                                        const TickType_t xMessageValue )
+    {
+        BaseType_t xTimerListsWereSwitched;
+        TickType_t xTimeNow;
 
-                if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+        if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+        {
+            /* The timer is in a list, remove it. */
+            prvRemoveTimerFromActiveList( pxTimer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceTIMER_COMMAND_RECEIVED( pxTimer, xCommandID, xMessageValue );
+
+        /* In this case the xTimerListsWereSwitched parameter is not used, but
+         *  it must be present in the function call.  prvSampleTimeNow() must be
+         *  called after the message is received from xTimerQueue so there is no
+         *  possibility of a higher priority task adding a message to the message
+         *  queue with a time that is ahead of the timer daemon task (because it
+         *  pre-empted the timer daemon task after the xTimeNow value was set). */
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+        switch( xCommandID )
+        {
+            case tmrCOMMAND_START:
+            case tmrCOMMAND_START_FROM_ISR:
+            case tmrCOMMAND_RESET:
+            case tmrCOMMAND_RESET_FROM_ISR:
+                /* Start or restart a timer. */
+                pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+
+                if( prvInsertTimerInActiveList( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessageValue ) != pdFALSE )
                 {
-                    /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    /* The timer expired before it was added to the active
+                     * timer list.  Process it now. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                    {
+                        prvReloadTimer( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+
+                    /* Call the timer callback. */
+                    traceTIMER_EXPIRED( pxTimer );
+                    pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
 
-                traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
+                break;
+
+            case tmrCOMMAND_STOP:
+            case tmrCOMMAND_STOP_FROM_ISR:
+                /* The timer has already been removed from the active list. */
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                break;
+
+            case tmrCOMMAND_CHANGE_PERIOD:
+            case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+                pxTimer->xTimerPeriodInTicks = xMessageValue;
+                configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+                /* The new period does not really have a reference, and can
+                 * be longer or shorter than the old one.  The command time is
+                 * therefore set to the current time, and as the period cannot
+                 * be zero the next expiry time can only be in the future,
+                 * meaning (unlike for the xTimerStart() case above) there is
+                 * no fail case that needs to be handled here. */
+                ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                break;
+
+            case tmrCOMMAND_DELETE:
+                #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+                {
+                    /* The timer has already been removed from the active list,
+                     * just free up the memory if the memory was dynamically
+                     * allocated. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
+                    {
+                        vPortFree( pxTimer );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+                }
+                #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+                {
+                    /* If dynamic allocation is not enabled, the memory
+                     * could not have been dynamically allocated. So there is
+                     * no need to free the memory - just mark the timer as
+                     * "not active". */
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+                #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+                break;
+
+            default:
+                /* Don't expect to get here. */
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_BATCH_COMMANDS == 1 )
+
+        static void prvProcessTimerBatch( const BatchParameters_t * const pxBatch )
+        {
+            UBaseType_t uxCommand;
+            const TimerBatchCommand_t * pxCommand;
 
-                /* In this case the xTimerListsWereSwitched parameter is not used, but
-                 *  it must be present in the function call.  prvSampleTimeNow() must be
-                 *  called after the message is received from xTimerQueue so there is no
-                 *  possibility of a higher priority task adding a message to the message
-                 *  queue with a time that is ahead of the timer daemon task (because it
-                 *  pre-empted the timer daemon task after the xTimeNow value was set). */
-                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+            for( uxCommand = ( UBaseType_t ) 0; uxCommand < pxBatch->uxNumberOfCommands; uxCommand++ )
+            {
+                pxCommand = &( pxBatch->pxCommands[ uxCommand ] );
+
+                /* Only the task level commands can be batched. */
+                configASSERT( pxCommand->xTimer );
+                configASSERT( ( pxCommand->xCommandID >= tmrCOMMAND_START_DONT_TRACE ) && ( pxCommand->xCommandID < tmrFIRST_FROM_ISR_COMMAND ) );
 
-                switch( xMessage.xMessageID )
+                #if ( configUSE_HARD_TIMERS == 1 )
                 {
-                    case tmrCOMMAND_START:
-                    case tmrCOMMAND_START_FROM_ISR:
-                    case tmrCOMMAND_RESET:
-                    case tmrCOMMAND_RESET_FROM_ISR:
-                        /* Start or restart a timer. */
-                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+                    if( ( pxCommand->xTimer->ucStatus & tmrSTATUS_IS_HARD ) != 0 )
+                    {
+                        prvHardTimerCommand( pxCommand->xTimer, pxCommand->xCommandID, pxCommand->xOptionalValue );
+                    }
+                    else
+                    {
+                        prvProcessTimerCommand( pxCommand->xCommandID, pxCommand->xTimer, pxCommand->xOptionalValue );
+                    }
+                }
+                #else
+                {
+                    prvProcessTimerCommand( pxCommand->xCommandID, pxCommand->xTimer, pxCommand->xOptionalValue );
+                }
+                #endif /* configUSE_HARD_TIMERS */
+            }
 
-                        if( prvInsertTimerInActiveList( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
-                        {
-                            /* The timer expired before it was added to the active
-                             * timer list.  Process it now. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
-                            {
-                                prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
+            if( pxBatch->xSendingTask != NULL )
+            {
+                ( void ) xTaskNotifyIndexed( pxBatch->xSendingTask, configTIMER_BATCH_NOTIFICATION_INDEX, tmrBATCH_COMPLETE, eSetBits );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+/*-----------------------------------------------------------*/
 
-                            /* Call the timer callback. */
-                            traceTIMER_EXPIRED( pxTimer );
-                            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-                        }
-                        else
-                        {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
+        BaseType_t xTimerSendCommandBatch( const TimerBatchCommand_t * const pxCommands,
+                                           const UBaseType_t uxNumberOfCommands,
+                                           const TickType_t xTicksToWait )
+        {
+            BaseType_t xReturn = pdFAIL;
+            DaemonTaskMessage_t xMessage;
+            uint32_t ulNotifiedValue;
+            const BaseType_t xSchedulerState = xTaskGetSchedulerState();
 
-                        break;
+            configASSERT( pxCommands );
+            configASSERT( xSchedulerState != taskSCHEDULER_SUSPENDED );
 
-                    case tmrCOMMAND_STOP:
-                    case tmrCOMMAND_STOP_FROM_ISR:
-                        /* The timer has already been removed from the active list. */
-                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        break;
+            if( xTimerQueue != NULL )
+            {
+                xMessage.xMessageID = tmrCOMMAND_EXECUTE_BATCH;
+                xMessage.u.xBatchParameters.pxCommands = pxCommands;
+                xMessage.u.xBatchParameters.uxNumberOfCommands = uxNumberOfCommands;
 
-                    case tmrCOMMAND_CHANGE_PERIOD:
-                    case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
-                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-                        pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-                        configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+                if( ( xSchedulerState == taskSCHEDULER_NOT_STARTED ) || ( xTaskGetCurrentTaskHandle() == xTimerTaskHandle ) )
+                {
+                    /* The timer service task is either not running yet or is
+                     * the caller, so cannot be waited for.  Nothing else can be
+                     * accessing the timer lists, so carry out the commands
+                     * here. */
+                    xMessage.u.xBatchParameters.xSendingTask = NULL;
+                    prvProcessTimerBatch( &( xMessage.u.xBatchParameters ) );
+                    xReturn = pdPASS;
+                }
+                else if( xSchedulerState == taskSCHEDULER_RUNNING )
+                {
+                    xMessage.u.xBatchParameters.xSendingTask = xTaskGetCurrentTaskHandle();
 
-                        /* The new period does not really have a reference, and can
-                         * be longer or shorter than the old one.  The command time is
-                         * therefore set to the current time, and as the period cannot
-                         * be zero the next expiry time can only be in the future,
-                         * meaning (unlike for the xTimerStart() case above) there is
-                         * no fail case that needs to be handled here. */
-                        ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
-                        break;
+                    /* Discard any notification left at the index, so only the
+                     * one sent when this batch is complete ends the wait. */
+                    ( void ) xTaskNotifyStateClearIndexed( NULL, configTIMER_BATCH_NOTIFICATION_INDEX );
+                    ( void ) ulTaskNotifyValueClearIndexed( NULL, configTIMER_BATCH_NOTIFICATION_INDEX, tmrBATCH_COMPLETE );
 
-                    case tmrCOMMAND_DELETE:
-                        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
-                        {
-                            /* The timer has already been removed from the active list,
-                             * just free up the memory if the memory was dynamically
-                             * allocated. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
-                            {
-                                vPortFree( pxTimer );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
-                        }
-                        #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+                    if( xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait ) != pdFAIL )
+                    {
+                        /* The timer service task reads the commands from the
+                         * caller's array, so wait until it has finished.  A
+                         * notification sent to the index by anything else does
+                         * not set tmrBATCH_COMPLETE, so the wait continues. */
+                        do
                         {
-                            /* If dynamic allocation is not enabled, the memory
-                             * could not have been dynamically allocated. So there is
-                             * no need to free the memory - just mark the timer as
-                             * "not active". */
-                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        }
-                        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-                        break;
+                            ( void ) xTaskNotifyWaitIndexed( configTIMER_BATCH_NOTIFICATION_INDEX, 0UL, tmrBATCH_COMPLETE, &ulNotifiedValue, portMAX_DELAY );
+                        } while( ( ulNotifiedValue & tmrBATCH_COMPLETE ) == 0UL );
 
-                    default:
-                        /* Don't expect to get here. */
-                        break;
+                        xReturn = pdPASS;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
                 }
             }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
         }
-    }
+
+    #endif /* configUSE_TIMER_BATCH_COMMANDS */
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+        static void prvSwitchTimerLists( void )
+        {
+            TickType_t xNextExpireTime;
+            BaseType_t xListWasEmpty;
+            Timer_t * pxTimer;
+
+            /* The tick count has overflowed.  Any timers still in the wheel
+             * must have expired and are processed in expiry order before the
+             * lists are switched.  Auto-reload timers are processed with the
+             * time set to the last tick before the overflow, so their reload
+             * goes to the overflow list. */
+            for( ; ; )
+            {
+                xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+
+                if( xListWasEmpty != pdFALSE )
+                {
+                    break;
+                }
+
+                /* Moves the timers down to level 0 if xNextExpireTime is the
+                 * start of a slot above it, in which case no timer is
+                 * processed this time round. */
+                prvAdvanceTimerWheel( xNextExpireTime );
+                prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            }
+
+            /* Restart the now empty wheel at the overflow and move the timers
+             * from the overflow list into it.  This is the only time the cost
+             * depends on the number of active timers, once per overflow of the
+             * tick count. */
+            xTimerWheelBase = ( TickType_t ) 0U;
+
+            while( listLIST_IS_EMPTY( pxOverflowTimerList ) == pdFALSE )
+            {
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxOverflowTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                prvInsertTimerInWheel( pxTimer );
+            }
+        }
+
+    #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
+
     static void prvSwitchTimerLists( void )
     {
         TickType_t xNextExpireTime;
@@ -928,6 +1691,8 @@
         pxCurrentTimerList = pxOverflowTimerList;
         pxOverflowTimerList = pxTemp;
     }
+
+    #endif /* if ( configUSE_TIMER_WHEEL == 1 ) */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -944,6 +1709,29 @@
                 pxCurrentTimerList = &xActiveTimerList1;
                 pxOverflowTimerList = &xActiveTimerList2;
 
+                #if ( configUSE_HARD_TIMERS == 1 )
+                {
+                    vListInitialise( &xHardTimerList1 );
+                    vListInitialise( &xHardTimerList2 );
+                    pxCurrentHardTimerList = &xHardTimerList1;
+                    pxOverflowHardTimerList = &xHardTimerList2;
+                }
+                #endif
+
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    UBaseType_t uxLevel, uxSlot;
+
+                    for( uxLevel = 0; uxLevel < ( UBaseType_t ) tmrWHEEL_LEVELS; uxLevel++ )
+                    {
+                        for( uxSlot = 0; uxSlot < ( UBaseType_t ) configTIMER_WHEEL_SLOTS; uxSlot++ )
+                        {
+                            vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+                        }
+                    }
+                }
+                #endif
+
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
                     /* The timer queue is allocated statically in case
@@ -981,6 +1769,253 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_HARD_TIMERS == 1 )
+
+        void vTimerSetHard( TimerHandle_t xTimer )
+        {
+            Timer_t * pxTimer = xTimer;
+
+            configASSERT( xTimer );
+
+            taskENTER_CRITICAL();
+            {
+                /* The timer cannot be moved out of the timer service task's
+                 * lists, so it must not have been started. */
+                configASSERT( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) != pdFALSE );
+                pxTimer->ucStatus |= tmrSTATUS_IS_HARD;
+            }
+            taskEXIT_CRITICAL();
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvInsertHardTimer( Timer_t * const pxTimer,
+                                        const TickType_t xNextExpiryTime )
+        {
+            listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+            listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+            if( xNextExpiryTime <= xHardTimerTimeNow )
+            {
+                /* The expiry time has overflowed. */
+                vListInsert( pxOverflowHardTimerList, &( pxTimer->xTimerListItem ) );
+            }
+            else
+            {
+                vListInsert( pxCurrentHardTimerList, &( pxTimer->xTimerListItem ) );
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvExpireHardTimer( Timer_t * const pxTimer,
+                                        const TickType_t xTimeNow )
+        {
+            const TickType_t xExpiredTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+            TickType_t xLateBy;
+
+            #if ( configHARD_TIMER_MAX_CALLBACK_TIME > 0 )
+                configRUN_TIME_COUNTER_TYPE ulStartTime, ulCallbackTime;
+            #endif
+
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+            {
+                /* Callbacks are not repeated to catch up on expiries missed
+                 * while the tick was suppressed - periods that have already
+                 * passed are skipped, keeping the timer's phase. */
+                xLateBy = xTimeNow - xExpiredTime;
+                prvInsertHardTimer( pxTimer, xTimeNow + ( pxTimer->xTimerPeriodInTicks - ( xLateBy % pxTimer->xTimerPeriodInTicks ) ) );
+            }
+            else
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            }
+
+            traceTIMER_EXPIRED( pxTimer );
+
+            #if ( configHARD_TIMER_MAX_CALLBACK_TIME > 0 )
+            {
+                ulStartTime = ( configRUN_TIME_COUNTER_TYPE ) configHARD_TIMER_GET_TIME();
+                pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                ulCallbackTime = ( configRUN_TIME_COUNTER_TYPE ) configHARD_TIMER_GET_TIME() - ulStartTime;
+
+                /* A callback that runs for too long delays every interrupt at
+                 * or below the kernel's priority, so the timer is stopped. */
+                if( ulCallbackTime > ( configRUN_TIME_COUNTER_TYPE ) configHARD_TIMER_MAX_CALLBACK_TIME )
+                {
+                    traceTIMER_HARD_CALLBACK_OVERRUN( pxTimer, ulCallbackTime );
+
+                    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+                    {
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    }
+
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #else /* if ( configHARD_TIMER_MAX_CALLBACK_TIME > 0 ) */
+            {
+                pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            }
+            #endif /* if ( configHARD_TIMER_MAX_CALLBACK_TIME > 0 ) */
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerProcessHardTimers( const TickType_t xTimeNow )
+        {
+            List_t * pxTemp;
+
+            /* Called from the tick interrupt, with interrupts masked. */
+            if( xTimeNow < xHardTimerTimeNow )
+            {
+                /* The tick count has overflowed.  Any timers still in the
+                 * current list expired before the overflow.  They are reloaded
+                 * relative to the time before the overflow so the reload goes to
+                 * the overflow list, which becomes the current list below. */
+                while( listLIST_IS_EMPTY( pxCurrentHardTimerList ) == pdFALSE )
+                {
+                    prvExpireHardTimer( ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentHardTimerList ), xTimeNow ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                }
+
+                pxTemp = pxCurrentHardTimerList;
+                pxCurrentHardTimerList = pxOverflowHardTimerList;
+                pxOverflowHardTimerList = pxTemp;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xHardTimerTimeNow = xTimeNow;
+
+            while( ( listLIST_IS_EMPTY( pxCurrentHardTimerList ) == pdFALSE ) &&
+                   ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentHardTimerList ) <= xTimeNow ) )
+            {
+                prvExpireHardTimer( ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentHardTimerList ), xTimeNow ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        BaseType_t xTimerGetNextHardExpiryTime( TickType_t * const pxNextExpiryTime )
+        {
+            BaseType_t xReturn = pdTRUE;
+
+            /* Called by the kernel with interrupts masked. */
+            if( listLIST_IS_EMPTY( pxCurrentHardTimerList ) == pdFALSE )
+            {
+                *pxNextExpiryTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentHardTimerList );
+            }
+            else if( listLIST_IS_EMPTY( pxOverflowHardTimerList ) == pdFALSE )
+            {
+                *pxNextExpiryTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxOverflowHardTimerList );
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvHardTimerCommand( Timer_t * const pxTimer,
+                                         const BaseType_t xCommandID,
+                                         const TickType_t xOptionalValue )
+        {
+            UBaseType_t uxSavedInterruptStatus = 0;
+            BaseType_t xFreeTimer = pdFALSE;
+
+            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+            {
+                taskENTER_CRITICAL();
+            }
+            else
+            {
+                uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            }
+
+            {
+                if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+                {
+                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                traceTIMER_COMMAND_RECEIVED( pxTimer, xCommandID, xOptionalValue );
+
+                switch( xCommandID )
+                {
+                    case tmrCOMMAND_START_DONT_TRACE:
+                    case tmrCOMMAND_START:
+                    case tmrCOMMAND_START_FROM_ISR:
+                    case tmrCOMMAND_RESET:
+                    case tmrCOMMAND_RESET_FROM_ISR:
+                        /* The command is executed immediately so the period is
+                         * measured from the tick at which the hard timers were
+                         * last processed, which, unlike the tick count, is not
+                         * held while the scheduler is suspended. */
+                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+                        prvInsertHardTimer( pxTimer, xHardTimerTimeNow + pxTimer->xTimerPeriodInTicks );
+                        break;
+
+                    case tmrCOMMAND_STOP:
+                    case tmrCOMMAND_STOP_FROM_ISR:
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                        break;
+
+                    case tmrCOMMAND_CHANGE_PERIOD:
+                    case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+                        pxTimer->xTimerPeriodInTicks = xOptionalValue;
+                        configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+                        prvInsertHardTimer( pxTimer, xHardTimerTimeNow + pxTimer->xTimerPeriodInTicks );
+                        break;
+
+                    case tmrCOMMAND_DELETE:
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+
+                        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+                        {
+                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
+                            {
+                                xFreeTimer = pdTRUE;
+                            }
+                        }
+                        #endif
+                        break;
+
+                    default:
+                        /* Don't expect to get here. */
+                        break;
+                }
+            }
+
+            if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+            {
+                taskEXIT_CRITICAL();
+            }
+            else
+            {
+                taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+            }
+
+            /* The heap cannot be used from within a critical section. */
+            if( xFreeTimer != pdFALSE )
+            {
+                vPortFree( pxTimer );
+            }
+        }
+
+    #endif /* configUSE_HARD_TIMERS */
+/*-----------------------------------------------------------*/
+
     BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer )
     {
         BaseType_t xReturn;